@@ -0,0 +1,61 @@
+#!/bin/sh
+#
+# Check that splitting a stats run between worker processes doesn't change
+# what it finds: make the same seeded runs serially and with -j, and compare
+# every table of the two databases apart from the metadata.
+#
+# Run from the top-level directory, with angband built with stats support
+# and sqlite3 on the path. Set STATS_DIR if the stats databases are not
+# written to the default user directory.
+
+if [ $# -gt 3 ]; then
+	echo "Syntax: $0 [runs [workers [seed]]]"
+	exit 1
+fi
+
+RUNS=${1:-6}
+WORKERS=${2:-3}
+SEED=${3:-1234}
+STATS_DIR=${STATS_DIR:-$HOME/.angband/Angband-v4/stats}
+
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+# Make the runs and move the new database to $TMP/$1.db. Databases are
+# named after the minute they were started in, so moving each one out of
+# the way lets the next run start straight after.
+stats_run() {
+	name=$1
+	shift
+
+	if ! src/angband -mstats -- -q -n$RUNS -S$SEED "$@" >"$TMP/$name.log"; then
+		echo "The $name stats run failed:"
+		cat "$TMP/$name.log"
+		exit 1
+	fi
+
+	db=$(ls -t "$STATS_DIR"/*.db | head -n 1)
+	mv "$db" "$TMP/$name.db" || exit 1
+	rm -f "$db-wal" "$db-shm"
+}
+
+stats_run serial
+stats_run workers -j$WORKERS
+
+FAILED=0
+for table in $(sqlite3 "$TMP/serial.db" \
+		"SELECT name FROM sqlite_master WHERE type = 'table' AND name != 'metadata'"); do
+	sqlite3 "$TMP/serial.db" "SELECT * FROM $table" | sort >"$TMP/serial.txt"
+	sqlite3 "$TMP/workers.db" "SELECT * FROM $table" | sort >"$TMP/workers.txt"
+
+	if ! cmp -s "$TMP/serial.txt" "$TMP/workers.txt"; then
+		echo "Table $table differs between -j1 and -j$WORKERS"
+		FAILED=1
+	fi
+done
+
+if [ $FAILED -eq 0 ]; then
+	echo "$RUNS runs with seed $SEED match with -j1 and -j$WORKERS"
+fi
+
+exit $FAILED
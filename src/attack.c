@@ -341,7 +341,7 @@ static bool py_attack_real(int y, int x, bool *fear) {
 	/* Apply earthquake brand */
 	if (do_quake) {
 		earthquake(p_ptr->py, p_ptr->px, 10);
-		if (cave->m_idx[y][x] == 0) stop = TRUE;
+		if (cave_m_idx(cave, y, x) == 0) stop = TRUE;
 	}
 
 	return stop;
@@ -368,6 +368,9 @@ void py_attack(int y, int x) {
 	/* Initialize the energy used */
 	p_ptr->energy_use = 0;
 
+	/* Fighting is noisy */
+	cave_make_noise(cave, p_ptr->py, p_ptr->px, NOISE_FIGHT);
+
 	/* Attack until energy runs out or enemy dies. We limit energy use to 100
 	 * to avoid giving monsters a possible double move. */
 	while (p_ptr->energy >= blow_energy * (blows + 1)) {
@@ -488,11 +491,11 @@ static void ranged_helper(int item, int dir, int range, int shots, ranged_attack
 		}
 
 		/* Handle monster */
-		if (cave->m_idx[y][x] > 0) break;
+		if (cave_m_idx(cave, y, x) > 0) break;
 	}
 
 	/* Try the attack on the monster at (x, y) if any */
-	if (cave->m_idx[y][x] > 0) {
+	if (cave_m_idx(cave, y, x) > 0) {
 		monster_type *m_ptr = cave_monster_at(cave, y, x);
 		monster_race *r_ptr = &r_info[m_ptr->r_idx];
 		int visible = m_ptr->ml;
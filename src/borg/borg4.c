@@ -8903,7 +8903,7 @@ int borg_danger(int y, int x, int c, bool average, bool full_damage)
     int i, p=0;
 
     /* Base danger (from regional fear) but not within a vault.  Cheating the floor grid */
-	if (!(cave->info[y][x] & (CAVE_ICKY)) && borg_skill[BI_CDEPTH] <= 80)
+	if (!(cave_info(cave, y, x) & (CAVE_ICKY)) && borg_skill[BI_CDEPTH] <= 80)
 	{
 		p += borg_fear_region[y/11][x/11] * c;
 	}
@@ -8917,7 +8917,7 @@ int borg_danger(int y, int x, int c, bool average, bool full_damage)
      * can induce some bouncy behavior.
      */
     if (time_this_panel <= 200 &&
-		!(cave->info[y][x] & (CAVE_ICKY))) p += borg_fear_monsters[y][x] * c;
+		!(cave_info(cave, y, x) & (CAVE_ICKY))) p += borg_fear_monsters[y][x] * c;
 
     full_damage = TRUE;
 
@@ -142,7 +142,7 @@ static struct object_kind *borg_guess_kind(byte a, wchar_t c,int y,int x)
 
     /* Cheat the Actual item */
     object_type *o_ptr;
-    o_ptr= object_byid(cave->o_idx[y][x]);
+    o_ptr= object_byid(cave_o_idx(cave, y, x));
     return (o_ptr->kind);
 #if 0
 /* The rest here is the original code.  It made several mistakes */
@@ -343,7 +343,7 @@ static int borg_new_take(struct object_kind *kind, int y, int x)
 
     borg_grid *ag = &borg_grids[y][x];
 
-    object_type *o_ptr = object_byid(cave->o_idx[y][x]);
+    object_type *o_ptr = object_byid(cave_o_idx(cave, y, x));
 
     /* Look for a "dead" object */
     for (i = 1; (n < 0) && (i < borg_takes_nxt); i++)
@@ -613,7 +613,7 @@ static int borg_guess_race(byte a, wchar_t c, bool multi, int y, int x)
 #endif
 
     monster_type   *m_ptr;
-    m_ptr= cave_monster(cave, cave->m_idx[y][x]);
+    m_ptr= cave_monster(cave, cave_m_idx(cave, y, x));
 
     /* Actual monsters */
     return (m_ptr->r_idx);
@@ -894,7 +894,7 @@ static void borg_fear_grid(char *who, int y, int x, int k)  /* 8-8, this was uin
 	if (borg_morgoth_position || borg_as_position) return;
 
 	/* Do not add fear in a vault -- Cheating the cave info */
-	if (cave->info[y][x] & CAVE_ICKY) return;
+	if (cave_info(cave, y, x) & CAVE_ICKY) return;
 
 	/* Access the grid info */
 	ag = &borg_grids[y][x];
@@ -962,7 +962,7 @@ static void borg_fear_regional(char *who, int y, int x, int k, bool seen_guy) /*
     int x0, y0, x1, x2, y1, y2;
 
 	/* Do not add fear in a vault -- Cheating the cave info */
-  	if (cave->info[y][x] & CAVE_ICKY) return;
+  	if (cave_info(cave, y, x) & CAVE_ICKY) return;
 
     /* Messages */
     if (seen_guy)
@@ -1013,7 +1013,7 @@ static void borg_update_kill_new(int i)
 
     borg_kill *kill = &borg_kills[i];
 
-    monster_type    *m_ptr = cave_monster(cave, cave->m_idx[kill->y][kill->x]);
+    monster_type    *m_ptr = cave_monster(cave, cave_m_idx(cave, kill->y, kill->x));
     monster_race    *r_ptr = &r_info[kill->r_idx];
 
     /* Extract the monster speed */
@@ -1069,7 +1069,7 @@ static void borg_update_kill_new(int i)
 	/* Cheat in the game's index of the monster.
 	 * Used in tracking monsters
 	 */
-	kill->m_idx = cave->m_idx[kill->y][kill->x];
+	kill->m_idx = cave_m_idx(cave, kill->y, kill->x);
 
     /* Is it sleeping */
     if (m_ptr->m_timed[MON_TMD_SLEEP] == 0) kill->awake = TRUE;
@@ -1150,7 +1150,7 @@ static void borg_update_kill_old(int i)
 
     borg_kill *kill = &borg_kills[i];
 
-    monster_type    *m_ptr = cave_monster(cave, cave->m_idx[kill->y][kill->x]);
+    monster_type    *m_ptr = cave_monster(cave, cave_m_idx(cave, kill->y, kill->x));
     monster_race *r_ptr = &r_info[kill->r_idx];
 
         /* Extract max hitpoints */
@@ -1205,7 +1205,7 @@ static void borg_update_kill_old(int i)
 	/* Cheat in the game's index of the monster.
 	 * Used in tracking monsters
 	 */
-	kill->m_idx = cave->m_idx[kill->y][kill->x];
+	kill->m_idx = cave_m_idx(cave, kill->y, kill->x);
 
     /* Extract the monster speed */
     kill->speed = (m_ptr->mspeed);
@@ -1663,7 +1663,7 @@ static int borg_new_kill(int r_idx, int y, int x)
     kill->oy = kill->y = y;
 
 	/* Games Index of the monster */
-	kill->m_idx = cave->m_idx[y][x];
+	kill->m_idx = cave_m_idx(cave, y, x);
 
     /* Update the grids */
     borg_grids[kill->y][kill->x].kill = n;
@@ -1830,7 +1830,7 @@ static bool observe_kill_move(int y, int x, int d, byte a, wchar_t c, bool flag)
         if (z > d) continue;
 
 		/* Verify that we are looking at the right one */
-		if (kill->m_idx != cave->m_idx[y][x]) continue;
+		if (kill->m_idx != cave_m_idx(cave, y, x)) continue;
 
         /* Verify "reasonable" motion, if allowed */
         if (!flag && (z > (kill->moves / 10) + 1)) continue;
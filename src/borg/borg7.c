@@ -707,7 +707,7 @@ bool borg_check_LIGHT(void)
 
             	/* Get grid */
                 ag = &borg_grids[y][x];
-                feat = cave->feat[y][x]; /* Cheat this grid from game */
+                feat = cave_feat(cave, y, x); /* Cheat this grid from game */
 
                 /* Location must be a lit floor */
                 if (ag->info & BORG_LIGHT) floors ++;
@@ -2907,7 +2907,7 @@ bool borg_think_dungeon_light(void)
 				(y == c_y && x == c_x))
 			{
 				/* Cheat the grid info to see if the door is lit */
-				if (cave->feat[c_y][c_x] == CAVE_GLOW) ag->info |= BORG_GLOW;
+				if (cave_feat(cave, c_y, c_x) == CAVE_GLOW) ag->info |= BORG_GLOW;
 				continue;
 			}
 
@@ -2967,7 +2967,7 @@ bool borg_think_stair_scum(bool from_town)
 
 	borg_grid *ag = &borg_grids[c_y][c_x];
 
-    byte feat = cave->feat[c_y][c_x];
+    byte feat = cave_feat(cave, c_y, c_x);
 
 	enum borg_need need;
 
@@ -3207,7 +3207,7 @@ bool borg_think_dungeon_lunal(void)
 
 	borg_grid *ag = &borg_grids[c_y][c_x];
 
-    byte feat = cave->feat[c_y][c_x];
+    byte feat = cave_feat(cave, c_y, c_x);
 
     enum borg_need need;
 
@@ -3590,7 +3590,7 @@ bool borg_think_dungeon_munchkin(void)
 
 	borg_grid *ag = &borg_grids[c_y][c_x];
 
-    byte feat = cave->feat[c_y][c_x];
+    byte feat = cave_feat(cave, c_y, c_x);
 
     enum borg_need need;
 
@@ -667,7 +667,7 @@ static bool borg_think(void)
 		 streq(buf, "Home")))
     {
         /* Cheat the store number */
-		shop_num = (cave->feat[p_ptr->py][p_ptr->px] - FEAT_SHOP_HEAD);
+		shop_num = (cave_feat(cave, p_ptr->py, p_ptr->px) - FEAT_SHOP_HEAD);
 
         /* Clear the goal (the goal was probably going to a shop number) */
         goal = 0;
@@ -1634,7 +1634,7 @@ static void borg_parse_aux(char *msg, int len)
                  * He won't see the one under him though.  So a special check
                  * must be made.
                  */
-                byte feat = cave->feat[c_y][c_x];
+                byte feat = cave_feat(cave, c_y, c_x);
 
                  /* Remove the entire array */
                  for (i = 0; i < track_glyph_num; i++)
@@ -2222,7 +2222,7 @@ static void borg_parse_aux(char *msg, int len)
          * He won't see the one under him though.  So a special check
          * must be made.
          */
-        byte feat = cave->feat[c_y][c_x];
+        byte feat = cave_feat(cave, c_y, c_x);
 
          /* Remove the entire array */
          for (i = 0; i < track_glyph_num; i++)
@@ -4915,7 +4915,7 @@ void borg_write_map(bool ask)
             char ch;
 
             borg_grid *ag= &borg_grids[i][j];
-            m_idx = cave->m_idx[i][j];
+            m_idx = cave_m_idx(cave, i, j);
 
 
             /* reset the ch each time through */
@@ -5243,7 +5243,7 @@ void borg_write_map(bool ask)
             s16b this_o_idx, next_o_idx = 0;
 
             /* Scan all objects in the grid */
-            for (this_o_idx = cave->o_idx[y][x]; this_o_idx; this_o_idx = next_o_idx)
+            for (this_o_idx = cave_o_idx(cave, y, x); this_o_idx; this_o_idx = next_o_idx)
             {
                 object_type *o_ptr;
 
@@ -6339,7 +6339,7 @@ void do_cmd_borg(void)
 			y = ty;
 			x = tx;
 
-			borg_note(format("Borg's Feat for grid (%d, %d) is %d, game Feat is %d", y,x,mask, cave->feat[y][x]));
+			borg_note(format("Borg's Feat for grid (%d, %d) is %d, game Feat is %d", y,x,mask, cave_feat(cave, y, x)));
 			prt_map();
 			break;
 		}
@@ -6430,9 +6430,9 @@ void do_cmd_borg(void)
                 if (borg_grids[y][x].info & BORG_VIEW)	msg("Info for grid (%d, %d) is VIEW", y,x);
                 if (borg_grids[y][x].info & BORG_TEMP)	msg("Info for grid (%d, %d) is TEMP", y,x);
                 if (borg_grids[y][x].info & BORG_XTRA)	msg("Info for grid (%d, %d) is XTRA", y,x);
-				if (cave->info[y][x] & CAVE_ICKY) msg("Info for grid (%d, %d) is ICKY", y,x);
+				if (cave_info(cave, y, x) & CAVE_ICKY) msg("Info for grid (%d, %d) is ICKY", y,x);
 
-				borg_note(format("Info for grid (%d, %d) is %d", y,x,cave->info[y][x]));
+				borg_note(format("Info for grid (%d, %d) is %d", y,x,cave_info(cave, y, x)));
 			prt_map();
 			break;
 		}
@@ -24,10 +24,32 @@
 #include "object/tvalsval.h"
 #include "squelch.h"
 #include "cmds.h"
+#include "z-bitboard.h"
 
 static int view_n;
 static u16b view_g[VIEW_MAX];
 
+/*
+ * The grids which came into, or dropped out of, view or sight at the last
+ * call to update_view()
+ */
+static int view_added_n;
+static u16b view_added_g[VIEW_MAX];
+static int view_removed_n;
+static u16b view_removed_g[VIEW_MAX];
+
+/*
+ * What the current view was worked out from, so that update_view() can
+ * tell when it has nothing to do.  The first view_lit_n entries of view_g
+ * are the grids lit by monsters.
+ */
+static struct cave *view_cave;
+static bool view_valid;
+static int view_py, view_px;
+static int view_radius;
+static bool view_blind;
+static int view_lit_n;
+
 /*
  * Approximate distance between two points.
  *
@@ -52,6 +74,9 @@ int distance(int y1, int x1, int y2, int x2)
  * A simple, fast, integer-based line-of-sight algorithm.  By Joseph Hall,
  * 4116 Brewster Drive, Raleigh NC 27606.  Email to jnh@ecemwl.ncsu.edu.
  *
+ * This walks the line in cave "c" one grid at a time; "los()" gets the
+ * same answers from a table built by running this once per offset.
+ *
  * This function returns TRUE if a "line of sight" can be traced from the
  * center of the grid (x1,y1) to the center of the grid (x2,y2), with all
  * of the grids along this path (except for the endpoints) being non-wall
@@ -84,7 +109,7 @@ int distance(int y1, int x1, int y2, int x2)
  * determining which grids are illuminated by the player's torch, and which
  * grids and monsters can be "seen" by the player, etc).
  */
-bool los(int y1, int x1, int y2, int x2)
+bool los_walk(struct cave *c, int y1, int x1, int y2, int x2)
 {
 	/* Delta */
 	int dx, dy;
@@ -129,7 +154,7 @@ bool los(int y1, int x1, int y2, int x2)
 		{
 			for (ty = y1 + 1; ty < y2; ty++)
 			{
-				if (!cave_floor_bold(ty, x1)) return (FALSE);
+				if (cave_info(c, ty, x1) & (CAVE_WALL)) return (FALSE);
 			}
 		}
 
@@ -138,7 +163,7 @@ bool los(int y1, int x1, int y2, int x2)
 		{
 			for (ty = y1 - 1; ty > y2; ty--)
 			{
-				if (!cave_floor_bold(ty, x1)) return (FALSE);
+				if (cave_info(c, ty, x1) & (CAVE_WALL)) return (FALSE);
 			}
 		}
 
@@ -154,7 +179,7 @@ bool los(int y1, int x1, int y2, int x2)
 		{
 			for (tx = x1 + 1; tx < x2; tx++)
 			{
-				if (!cave_floor_bold(y1, tx)) return (FALSE);
+				if (cave_info(c, y1, tx) & (CAVE_WALL)) return (FALSE);
 			}
 		}
 
@@ -163,7 +188,7 @@ bool los(int y1, int x1, int y2, int x2)
 		{
 			for (tx = x1 - 1; tx > x2; tx--)
 			{
-				if (!cave_floor_bold(y1, tx)) return (FALSE);
+				if (cave_info(c, y1, tx) & (CAVE_WALL)) return (FALSE);
 			}
 		}
 
@@ -182,7 +207,7 @@ bool los(int y1, int x1, int y2, int x2)
 	{
 		if (ay == 2)
 		{
-			if (cave_floor_bold(y1 + sy, x1)) return (TRUE);
+			if (!(cave_info(c, y1 + sy, x1) & (CAVE_WALL))) return (TRUE);
 		}
 	}
 
@@ -191,7 +216,7 @@ bool los(int y1, int x1, int y2, int x2)
 	{
 		if (ax == 2)
 		{
-			if (cave_floor_bold(y1, x1 + sx)) return (TRUE);
+			if (!(cave_info(c, y1, x1 + sx) & (CAVE_WALL))) return (TRUE);
 		}
 	}
 
@@ -227,7 +252,7 @@ bool los(int y1, int x1, int y2, int x2)
 		/* the LOS exactly meets the corner of a tile. */
 		while (x2 - tx)
 		{
-			if (!cave_floor_bold(ty, tx)) return (FALSE);
+			if (cave_info(c, ty, tx) & (CAVE_WALL)) return (FALSE);
 
 			qy += m;
 
@@ -238,7 +263,7 @@ bool los(int y1, int x1, int y2, int x2)
 			else if (qy > f2)
 			{
 				ty += sy;
-				if (!cave_floor_bold(ty, tx)) return (FALSE);
+				if (cave_info(c, ty, tx) & (CAVE_WALL)) return (FALSE);
 				qy -= f1;
 				tx += sx;
 			}
@@ -274,7 +299,7 @@ bool los(int y1, int x1, int y2, int x2)
 		/* the LOS exactly meets the corner of a tile. */
 		while (y2 - ty)
 		{
-			if (!cave_floor_bold(ty, tx)) return (FALSE);
+			if (cave_info(c, ty, tx) & (CAVE_WALL)) return (FALSE);
 
 			qx += m;
 
@@ -285,7 +310,7 @@ bool los(int y1, int x1, int y2, int x2)
 			else if (qx > f2)
 			{
 				tx += sx;
-				if (!cave_floor_bold(ty, tx)) return (FALSE);
+				if (cave_info(c, ty, tx) & (CAVE_WALL)) return (FALSE);
 				qx -= f1;
 				ty += sy;
 			}
@@ -303,6 +328,223 @@ bool los(int y1, int x1, int y2, int x2)
 }
 
 
+/*
+ * The line of sight table.  For every offset (dy, dx) from a source grid,
+ * up to LOS_RADIUS each way, it holds the rows of grids which "los_walk()"
+ * checks on the way to the target, nearest first.  Row "los_dy[i]" (from
+ * the source) is blocked if a wall is in "los_mask[i]", a mask of the row
+ * starting LOS_RADIUS grids west of the source.
+ */
+#define LOS_SIDE	(2 * LOS_RADIUS + 1)
+#define LOS_OFFSET(DY, DX)	(((DY) + LOS_RADIUS) * LOS_SIDE + (DX) + LOS_RADIUS)
+
+/* Each offset uses at most one row per row from the source to the target */
+#define LOS_ROWS_MAX \
+	(LOS_SIDE * ((LOS_RADIUS + 1) * (LOS_RADIUS + 1) + LOS_RADIUS))
+
+static u16b los_first[LOS_SIDE * LOS_SIDE];
+static byte los_count[LOS_SIDE * LOS_SIDE];
+static s16b los_dy[LOS_ROWS_MAX];
+static u64b los_mask[LOS_ROWS_MAX];
+
+/* The bitplane of CAVE_WALL */
+static int los_walls;
+
+
+/*
+ * Build the line of sight table.
+ *
+ * Whether "los_walk()" succeeds depends only on whether the grids it checks
+ * are walls, and the grids it checks depend only on the offset, so each
+ * offset's grids are found by putting a single wall in each grid between
+ * the source and target of an empty cave in turn and seeing if it blocks.
+ * (A knight's move is walked only when the grid beside the source is a
+ * wall, and that grid is the first checked, so it is the only one found.)
+ */
+errr los_init(void)
+{
+	struct cave *c = cave_new();
+	int dy, dx, y, x, n = 0;
+
+	los_walls = bitboard_first(CAVE_WALL);
+
+	cave_resize(c, LOS_SIDE, LOS_SIDE);
+
+	for (dy = -LOS_RADIUS; dy <= LOS_RADIUS; dy++)
+	{
+		int sy = (dy < 0) ? -1 : 1;
+
+		for (dx = -LOS_RADIUS; dx <= LOS_RADIUS; dx++)
+		{
+			int o = LOS_OFFSET(dy, dx);
+
+			los_first[o] = n;
+
+			/* Scan the rows from the source to the target */
+			for (y = 0; y != dy + sy; y += sy)
+			{
+				u64b mask = 0;
+
+				for (x = MIN(0, dx); x <= MAX(0, dx); x++)
+				{
+					int wy = LOS_RADIUS + y;
+					int wx = LOS_RADIUS + x;
+
+					/* Skip the end points */
+					if ((!y && !x) || ((y == dy) && (x == dx))) continue;
+
+					/* Does a wall here block the line? */
+					cave_info_on(c, wy, wx, CAVE_WALL);
+					if (!los_walk(c, LOS_RADIUS, LOS_RADIUS,
+							LOS_RADIUS + dy, LOS_RADIUS + dx))
+						mask |= (u64b)1 << wx;
+					cave_info_off(c, wy, wx, CAVE_WALL);
+				}
+
+				if (!mask) continue;
+
+				assert(n < LOS_ROWS_MAX);
+				los_dy[n] = y;
+				los_mask[n] = mask;
+				n++;
+			}
+
+			los_count[o] = n - los_first[o];
+		}
+	}
+
+	cave_free(c);
+
+	return (0);
+}
+
+
+/*
+ * Find the word "w" of each row of the wall bitplane which holds the first
+ * of the LOS_SIDE columns centred on x, and the bit "shift" it starts at.
+ */
+static void los_columns(int x, int *w, int *shift)
+{
+	int x0 = x - LOS_RADIUS;
+
+	*w = (x0 + BITBOARD_WORD_BITS) / BITBOARD_WORD_BITS - 1;
+	*shift = x0 - *w * BITBOARD_WORD_BITS;
+}
+
+
+/*
+ * Return the walls of the columns found by "los_columns()" in row y, so
+ * that bit j holds column x - LOS_RADIUS + j.  Columns off the board read
+ * as open.
+ */
+static u64b los_window(const struct bitboard *walls, int y, int w, int shift)
+{
+	const u64b *row = BITBOARD_ROW(walls, y);
+	u64b lo = (w >= 0) ? row[w] : 0;
+	u64b hi = (w + 1 < walls->words) ? row[w + 1] : 0;
+
+	if (!shift) return (lo);
+	return ((lo >> shift) | (hi << (BITBOARD_WORD_BITS - shift)));
+}
+
+
+/*
+ * Determine if a "line of sight" can be traced from (y1, x1) to (y2, x2),
+ * as "los_walk()" does for the current cave.
+ *
+ * Within LOS_RADIUS each way this takes one mask test per row of the line
+ * against the CAVE_WALL bitplane, using the table built by "los_init()";
+ * longer lines are walked.
+ */
+bool los(int y1, int x1, int y2, int x2)
+{
+	const struct bitboard *walls = cave->planes[los_walls];
+
+	int dy = y2 - y1;
+	int dx = x2 - x1;
+
+	int i, n, w, shift;
+
+	/* Too long for the table */
+	if ((ABS(dy) > LOS_RADIUS) || (ABS(dx) > LOS_RADIUS))
+		return (los_walk(cave, y1, x1, y2, x2));
+
+	i = los_first[LOS_OFFSET(dy, dx)];
+	n = i + los_count[LOS_OFFSET(dy, dx)];
+
+	los_columns(x1, &w, &shift);
+
+	/* Check each row of the line */
+	for (; i < n; i++)
+	{
+		if (los_window(walls, y1 + los_dy[i], w, shift) & los_mask[i])
+			return (FALSE);
+	}
+
+	/* Assume los */
+	return (TRUE);
+}
+
+
+/*
+ * Prepare to test "line of sight" from (y, x) to many grids with
+ * "los_from()".  The rows of walls around the source are read as they
+ * are needed and kept, so the lines share them.
+ *
+ * The walls must not change while the source is in use.
+ */
+void los_source_init(struct los_source *s, int y, int x)
+{
+	s->y = y;
+	s->x = x;
+	s->known = 0;
+}
+
+
+/*
+ * Determine if a "line of sight" can be traced from the source to (y, x),
+ * as "los()" does.
+ */
+bool los_from(struct los_source *s, int y, int x)
+{
+	const struct bitboard *walls = cave->planes[los_walls];
+
+	int dy = y - s->y;
+	int dx = x - s->x;
+
+	int i, n;
+
+	/* Too long for the table */
+	if ((ABS(dy) > LOS_RADIUS) || (ABS(dx) > LOS_RADIUS))
+		return (los_walk(cave, s->y, s->x, y, x));
+
+	i = los_first[LOS_OFFSET(dy, dx)];
+	n = i + los_count[LOS_OFFSET(dy, dx)];
+
+	/* Check each row of the line */
+	for (; i < n; i++)
+	{
+		int r = los_dy[i] + LOS_RADIUS;
+
+		/* Read the row */
+		if (!(s->known & ((u64b)1 << r)))
+		{
+			int w, shift;
+
+			los_columns(s->x, &w, &shift);
+			s->rows[r] = los_window(walls, s->y + los_dy[i], w, shift);
+			s->known |= (u64b)1 << r;
+		}
+
+		if (s->rows[r] & los_mask[i]) return (FALSE);
+	}
+
+	/* Assume los */
+	return (TRUE);
+}
+
+
+
 
 
 /*
@@ -427,13 +669,13 @@ byte get_color(byte a, int attr, int n)
 bool dtrap_edge(int y, int x) 
 { 
 	/* Check if the square is a dtrap in the first place */ 
- 	if (!(cave->info2[y][x] & CAVE2_DTRAP)) return FALSE; 
+ 	if (!(cave_info2(cave, y, x) & CAVE2_DTRAP)) return FALSE; 
 
  	/* Check for non-dtrap adjacent grids */ 
- 	if (in_bounds_fully(y + 1, x    ) && (!(cave->info2[y + 1][x    ] & CAVE2_DTRAP))) return TRUE; 
- 	if (in_bounds_fully(y    , x + 1) && (!(cave->info2[y    ][x + 1] & CAVE2_DTRAP))) return TRUE; 
- 	if (in_bounds_fully(y - 1, x    ) && (!(cave->info2[y - 1][x    ] & CAVE2_DTRAP))) return TRUE; 
- 	if (in_bounds_fully(y    , x - 1) && (!(cave->info2[y    ][x - 1] & CAVE2_DTRAP))) return TRUE; 
+ 	if (in_bounds_fully(y + 1, x    ) && (!(cave_info2(cave, y + 1, x) & CAVE2_DTRAP))) return TRUE; 
+ 	if (in_bounds_fully(y    , x + 1) && (!(cave_info2(cave, y, x + 1) & CAVE2_DTRAP))) return TRUE; 
+ 	if (in_bounds_fully(y - 1, x    ) && (!(cave_info2(cave, y - 1, x) & CAVE2_DTRAP))) return TRUE; 
+ 	if (in_bounds_fully(y    , x - 1) && (!(cave_info2(cave, y, x - 1) & CAVE2_DTRAP))) return TRUE; 
 
 	return FALSE; 
 }
@@ -767,10 +1009,10 @@ void map_info(unsigned y, unsigned x, grid_data *g)
 	object_type *o_ptr;
 	byte info;
 
-	assert(x < DUNGEON_WID);
-	assert(y < DUNGEON_HGT);
+	assert(x < (unsigned)cave->width);
+	assert(y < (unsigned)cave->height);
 
-	info = cave->info[y][x];
+	info = cave_info(cave, y, x);
 	
 	/* Default "clear" values, others will be set later where appropriate. */
 	g->first_kind = NULL;
@@ -778,13 +1020,13 @@ void map_info(unsigned y, unsigned x, grid_data *g)
 	g->lighting = FEAT_LIGHTING_DARK;
 	g->unseen_object = FALSE;
 
-	g->f_idx = cave->feat[y][x];
+	g->f_idx = cave_feat(cave, y, x);
 	if (f_info[g->f_idx].mimic)
 		g->f_idx = f_info[g->f_idx].mimic;
 
 	g->in_view = (info & CAVE_SEEN) ? TRUE : FALSE;
-	g->is_player = (cave->m_idx[y][x] < 0) ? TRUE : FALSE;
-	g->m_idx = (g->is_player) ? 0 : cave->m_idx[y][x];
+	g->is_player = (cave_m_idx(cave, y, x) < 0) ? TRUE : FALSE;
+	g->m_idx = (g->is_player) ? 0 : cave_m_idx(cave, y, x);
 	g->hallucinate = p_ptr->timed[TMD_IMAGE] ? TRUE : FALSE;
 	g->trapborder = (dtrap_edge(y, x)) ? TRUE : FALSE;
 
@@ -1079,17 +1321,17 @@ void cave_note_spot(struct cave *c, int y, int x)
 	object_type *o_ptr;
 
 	/* Require "seen" flag */
-	if (!(c->info[y][x] & CAVE_SEEN))
+	if (!(cave_info(c, y, x) & CAVE_SEEN))
 		return;
 
 	for (o_ptr = get_first_object(y, x); o_ptr; o_ptr = get_next_object(o_ptr))
 		o_ptr->marked = MARK_SEEN;
 
-	if (c->info[y][x] & CAVE_MARK)
+	if (cave_info(c, y, x) & CAVE_MARK)
 		return;
 
 	/* Memorize this grid */
-	cave->info[y][x] |= (CAVE_MARK);
+	cave_info_on(cave, y, x, CAVE_MARK);
 }
 
 
@@ -1250,8 +1492,8 @@ void display_map(int *cy, int *cx)
 
 	byte tp;
 
-	/* Large array on the stack */
-	byte mp[DUNGEON_HGT][DUNGEON_WID];
+	/* Priority of what is shown at each map location */
+	byte *mp;
 
 	monster_race *r_ptr = &r_info[0];
 
@@ -1259,8 +1501,8 @@ void display_map(int *cy, int *cx)
 	map_hgt = Term->hgt - 2;
 	map_wid = Term->wid - 2;
 
-	dungeon_hgt = (p_ptr->depth == 0) ? TOWN_HGT : DUNGEON_HGT;
-	dungeon_wid = (p_ptr->depth == 0) ? TOWN_WID : DUNGEON_WID;
+	dungeon_hgt = cave->height;
+	dungeon_wid = cave->width;
 
 	/* Prevent accidents */
 	if (map_hgt > dungeon_hgt) map_hgt = dungeon_hgt;
@@ -1274,15 +1516,8 @@ void display_map(int *cy, int *cx)
 	ta = TERM_WHITE;
 	tc = L' ';
 
-	/* Clear the priorities */
-	for (y = 0; y < map_hgt; ++y)
-	{
-		for (x = 0; x < map_wid; ++x)
-		{
-			/* No priority */
-			mp[y][x] = 0;
-		}
-	}
+	/* No priorities yet */
+	mp = C_ZNEW(map_hgt * map_wid, byte);
 
 
 	/* Draw a box around the edge of the term */
@@ -1308,7 +1543,7 @@ void display_map(int *cy, int *cx)
 			tp = f_info[g.f_idx].priority;
 
 			/* Save "best" */
-			if (mp[row][col] < tp)
+			if (mp[row * map_wid + col] < tp)
 			{
 				/* Hack - make every grid on the map lit */
 				g.lighting = FEAT_LIGHTING_LIT; /*FEAT_LIGHTING_BRIGHT;*/
@@ -1321,11 +1556,13 @@ void display_map(int *cy, int *cx)
 					Term_big_putch(col + 1, row + 1, ta, tc);
 
 				/* Save priority */
-				mp[row][col] = tp;
+				mp[row * map_wid + col] = tp;
 			}
 		}
 	}
 
+	FREE(mp);
+
 	/*** Display the player ***/
 
 	/* Player location */
@@ -2236,6 +2473,12 @@ errr vinfo_init(void)
 
 
 
+/*
+ * The "cave->info" flags of the grid with "grid" index G
+ */
+#define VIEW_INFO(G) \
+	cave_info(cave, GRID_Y(G), GRID_X(G))
+
 /*
  * Forget the "CAVE_VIEW" grids, redrawing as needed
  */
@@ -2246,9 +2489,13 @@ void forget_view(void)
 	int fast_view_n = view_n;
 	u16b *fast_view_g = view_g;
 
-	/* XXX: this is moronic. It's not 'fast'. */
-	byte *fast_cave_info = &cave->info[0][0];
 
+	/* The next update_view() starts from scratch */
+	view_valid = FALSE;
+	view_added_n = view_removed_n = 0;
+
+	/* The grids belong to another level */
+	if (cave != view_cave) fast_view_n = 0;
 
 	/* None to forget */
 	if (!fast_view_n) return;
@@ -2266,7 +2513,7 @@ void forget_view(void)
 		x = GRID_X(g);
 
 		/* Clear "CAVE_VIEW" and "CAVE_SEEN" flags */
-		fast_cave_info[g] &= ~(CAVE_VIEW | CAVE_SEEN);
+		cave_info_off(cave, GRID_Y(g), GRID_X(g), CAVE_VIEW | CAVE_SEEN);
 
 		/* Clear "CAVE_LIGHT" flag */
 		/* fast_cave->info[g] &= ~(CAVE_LIGHT); */
@@ -2284,6 +2531,132 @@ void forget_view(void)
 }
 
 
+/*
+ * Forget the view of cave c without touching its grids, which are about
+ * to be wiped
+ */
+void cave_view_reset(struct cave *c)
+{
+	if (c != view_cave) return;
+
+	view_cave = NULL;
+	view_n = 0;
+	view_valid = FALSE;
+	view_added_n = view_removed_n = 0;
+}
+
+
+
+/*
+ * Handle grid (y, x) becoming "CAVE_SEEN"
+ */
+static void view_grid_seen(int y, int x)
+{
+	/* Handle feeling squares */
+	if (cave_info2(cave, y, x) & CAVE2_FEEL)
+	{
+		cave->feeling_squares++;
+
+		/* Erase the square so you can't 'resee' it */
+		cave_info2(cave, y, x) &= ~(CAVE2_FEEL);
+
+		/* Display feeling if necessary */
+		if (cave->feeling_squares == FEELING1)
+			display_feeling(TRUE);
+	}
+
+	cave_note_spot(cave, y, x);
+	cave_light_spot(cave, y, x);
+}
+
+/*
+ * Decide whether the viewable grid "g", "d" grids from the player, is
+ * "CAVE_SEEN" with the given light radius, leaving aside monster light and
+ * blindness.  This is the test made by the octant scan of update_view().
+ */
+static bool view_grid_lit(int g, int d, int radius)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	byte info = VIEW_INFO(g);
+
+	/* Torch-lit grids */
+	if (d < radius) return (TRUE);
+
+	/* Unlit grids */
+	if (!(info & (CAVE_GLOW))) return (FALSE);
+
+	/* Perma-lit walls need a perma-lit grid between them and the player */
+	if ((info & (CAVE_WALL)) && (g != GRID(py, px)))
+	{
+		int y = GRID_Y(g);
+		int x = GRID_X(g);
+
+		/* Hack -- move towards player */
+		int yy = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+		int xx = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+
+		return ((cave_info(cave, yy, xx) & (CAVE_GLOW)) != 0);
+	}
+
+	/* Perma-lit grids */
+	return (TRUE);
+}
+
+/*
+ * Update the "CAVE_SEEN" flags of the current view for a change in the light
+ * radius, when nothing else has changed.  Only the grids between the old and
+ * new radius can be affected.
+ */
+static void update_view_ring(int radius)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	int lo = MIN(view_radius, radius);
+	int hi = MAX(view_radius, radius);
+
+	int i, j;
+
+	for (i = view_lit_n; i < view_n; i++)
+	{
+		int g = view_g[i];
+		int y = GRID_Y(g);
+		int x = GRID_X(g);
+		int d = distance(py, px, y, x);
+
+		byte info;
+
+		/* Outside the ring */
+		if ((d < lo) || (d >= hi)) continue;
+
+		/* Get grid info */
+		info = VIEW_INFO(g);
+
+		/* Was not "CAVE_SEEN", is now "CAVE_SEEN" */
+		if (!(info & (CAVE_SEEN)) && view_grid_lit(g, d, radius))
+		{
+			cave_info_on(cave, y, x, CAVE_SEEN);
+			view_added_g[view_added_n++] = g;
+			view_grid_seen(y, x);
+		}
+
+		/* Was "CAVE_SEEN", is now not "CAVE_SEEN" */
+		else if ((info & (CAVE_SEEN)) && !view_grid_lit(g, d, radius))
+		{
+			/* Monsters still light it */
+			for (j = 0; j < view_lit_n; j++)
+				if (view_g[j] == g) break;
+			if (j < view_lit_n) continue;
+
+			cave_info_off(cave, y, x, CAVE_SEEN);
+			view_removed_g[view_removed_n++] = g;
+			cave_light_spot(cave, y, x);
+		}
+	}
+}
+
 
 /*
  * Calculate the complete field of view using a new algorithm
@@ -2370,6 +2743,17 @@ void forget_view(void)
  * their children, and the queue must be able to hold several of these
  * special grids.  Because the actual number of required grids is bizarre,
  * we simply allocate twice as many as we would normally need.  XXX XXX XXX
+ *
+ * The view is only worked out again when something it depends on has
+ * changed: the player grid, the light radius, blindness, the grids lit by
+ * monsters, or a "CAVE_WALL" or "CAVE_GLOW" flag within MAX_SIGHT of the
+ * player (see "view_note_change()").  When only the light radius changed,
+ * just the grids between the old and new radius are looked at again.  After
+ * the player moves the whole scan is needed, as every line of sight moves
+ * with the player.
+ *
+ * The grids whose "CAVE_VIEW" or "CAVE_SEEN" flags changed are available
+ * from "view_added()" and "view_removed()" until the next call.
  */
 void update_view(void)
 {
@@ -2387,72 +2771,62 @@ void update_view(void)
 
 	int fast_temp_n = 0;
 	u16b *fast_temp_g = temp_g;
+	byte fast_temp_info[VIEW_MAX];
 
-	/* XXX: also moronic. Optimizers exist. */
-	byte *fast_cave_info = &cave->info[0][0];
+	int lit_n = 0;
+	u16b lit_g[VIEW_MAX];
+
+	bool blind = (p_ptr->timed[TMD_BLIND] ? TRUE : FALSE);
 
 	byte info;
 
+	struct los_source from_player;
 
-	/*** Step 0 -- Begin ***/
 
-	/* Save the old "view" grids for later */
-	for (i = 0; i < fast_view_n; i++)
+	/* The old view belongs to another level */
+	if (cave != view_cave)
 	{
-		/* Grid */
-		g = fast_view_g[i];
-
-		/* Get grid info */
-		info = fast_cave_info[g];
-
-		/* Save "CAVE_SEEN" grids */
-		if (info & (CAVE_SEEN))
-		{
-			/* Set "CAVE_TEMP" flag */
-			info |= (CAVE_TEMP);
-
-			/* Save grid for later */
-			fast_temp_g[fast_temp_n++] = g;
-		}
-
-		/* Clear "CAVE_VIEW" and "CAVE_SEEN" flags */
-		info &= ~(CAVE_VIEW | CAVE_SEEN);
-
-		/* Clear "CAVE_LIGHT" flag */
-		/* info &= ~(CAVE_LIGHT); */
-
-		/* Save cave info */
-		fast_cave_info[g] = info;
+		fast_view_n = view_n = 0;
+		view_valid = FALSE;
+		view_cave = cave;
 	}
 
-	/* Reset the "view" array */
-	fast_view_n = 0;
-
 	/* Extract "radius" value */
 	radius = p_ptr->cur_light;
 
 	/* Handle real light */
 	if (radius > 0) ++radius;
 
-	/* Scan monster list and add monster lights */
+
+	/*** Step 0 -- Monster lights ***/
+
+	los_source_init(&from_player, py, px);
+
+	/* Scan monster list and collect monster lights */
 	for (k = 1; k < z_info->m_max; k++)
 	{
 		/* Check the k'th monster */
 		monster_type *m_ptr = cave_monster(cave, k);
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+		monster_race *r_ptr;
 
 		/* Access the location */
 		int fx = m_ptr->fx;
 		int fy = m_ptr->fy;
 
-		bool in_los = los(p_ptr->py, p_ptr->px, fy, fx);
+		bool in_los;
 
 		/* Skip dead monsters */
 		if (!m_ptr->r_idx) continue;
 
 		/* Skip monsters not carrying light */
+		r_ptr = &r_info[m_ptr->r_idx];
 		if (!rf_has(r_ptr->flags, RF_HAS_LIGHT)) continue;
 
+		/* Skip monsters too far away to light anything in view */
+		if (distance(py, px, fy, fx) > MAX_SIGHT + 2) continue;
+
+		in_los = los_from(&from_player, fy, fx);
+
 		/* Light a 3x3 box centered on the monster */
 		for (i = -1; i <= 1; i++)
 		{
@@ -2470,28 +2844,88 @@ void update_view(void)
 					continue;
 				
 				/* If the tile itself isn't in LOS, don't light it */
-				if (!los(p_ptr->py, p_ptr->px, sy, sx))
+				if (!los_from(&from_player, sy, sx))
 					continue;
 				
-				g = GRID(sy, sx);
-
-				/* Mark the square lit and seen */
-				fast_cave_info[g] |= (CAVE_VIEW | CAVE_SEEN);
-				
 				/* Save in array */
-				fast_view_g[fast_view_n++] = g;
+				if (lit_n < VIEW_MAX) lit_g[lit_n++] = GRID(sy, sx);
 			}
 		}
 	}
 
 
-	/*** Step 1 -- player grid ***/
+	/*** Step 1 -- Reuse the old view ***/
+
+	/* Nothing the view depends on has changed, save perhaps the radius */
+	if (view_valid && (py == view_py) && (px == view_px) &&
+	    (blind == view_blind) && (lit_n == view_lit_n) &&
+	    !memcmp(lit_g, fast_view_g, lit_n * sizeof(u16b)))
+	{
+		view_added_n = view_removed_n = 0;
+
+		/* Blindness hides any change of radius */
+		if ((radius != view_radius) && !blind)
+			update_view_ring(radius);
+
+		view_radius = radius;
+		return;
+	}
+
+
+	/*** Step 2 -- Begin ***/
+
+	/* Save the old "view" grids for later */
+	for (i = 0; i < fast_view_n; i++)
+	{
+		/* Grid */
+		g = fast_view_g[i];
+
+		/* Get grid info */
+		info = VIEW_INFO(g);
+
+		/* Saved already (lit by several monsters) */
+		if (info & (CAVE_TEMP)) continue;
+
+		/* Save grid and flags for later */
+		fast_temp_info[fast_temp_n] = info;
+		fast_temp_g[fast_temp_n++] = g;
+
+		/* Set "CAVE_TEMP" flag */
+		info |= (CAVE_TEMP);
+
+		/* Clear "CAVE_VIEW" and "CAVE_SEEN" flags */
+		info &= ~(CAVE_VIEW | CAVE_SEEN);
+
+		/* Clear "CAVE_LIGHT" flag */
+		/* info &= ~(CAVE_LIGHT); */
+
+		/* Save cave info */
+		cave_info_set(cave, GRID_Y(g), GRID_X(g), info);
+	}
+
+	/* Reset the "view" array */
+	fast_view_n = 0;
+
+	/* Add the monster lights */
+	for (i = 0; i < lit_n; i++)
+	{
+		g = lit_g[i];
+
+		/* Mark the square lit and seen */
+		cave_info_on(cave, GRID_Y(g), GRID_X(g), CAVE_VIEW | CAVE_SEEN);
+
+		/* Save in array */
+		fast_view_g[fast_view_n++] = g;
+	}
+
+
+	/*** Step 3 -- player grid ***/
 
 	/* Player grid */
 	g = pg;
 
 	/* Get grid info */
-	info = fast_cave_info[g];
+	info = VIEW_INFO(g);
 
 	/* Assume viewable */
 	info |= (CAVE_VIEW);
@@ -2514,13 +2948,13 @@ void update_view(void)
 	}
 
 	/* Save cave info */
-	fast_cave_info[g] = info;
+	cave_info_set(cave, GRID_Y(g), GRID_X(g), info);
 
 	/* Save in array */
 	fast_view_g[fast_view_n++] = g;
 
 
-	/*** Step 2 -- octants ***/
+	/*** Step 4 -- octants ***/
 
 	/* Scan each octant */
 	for (o2 = 0; o2 < 8; o2++)
@@ -2564,7 +2998,7 @@ void update_view(void)
 				g = pg + p->grid[o2];
 
 				/* Get grid info */
-				info = fast_cave_info[g];
+				info = VIEW_INFO(g);
 
 				/* Handle wall */
 				if (info & (CAVE_WALL))
@@ -2602,7 +3036,7 @@ void update_view(void)
 							int xx = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
 
 							/* Check for "simple" illumination */
-							if (cave->info[yy][xx] & (CAVE_GLOW))
+							if (cave_info(cave, yy, xx) & (CAVE_GLOW))
 							{
 								/* Mark as seen */
 								info |= (CAVE_SEEN);
@@ -2610,7 +3044,7 @@ void update_view(void)
 						}
 
 						/* Save cave info */
-						fast_cave_info[g] = info;
+						cave_info_set(cave, GRID_Y(g), GRID_X(g), info);
 
 						/* Save in array */
 						fast_view_g[fast_view_n++] = g;
@@ -2656,7 +3090,7 @@ void update_view(void)
 						}
 
 						/* Save cave info */
-						fast_cave_info[g] = info;
+						cave_info_set(cave, GRID_Y(g), GRID_X(g), info);
 
 						/* Save in array */
 						fast_view_g[fast_view_n++] = g;
@@ -2667,10 +3101,10 @@ void update_view(void)
 	}
 
 
-	/*** Step 3 -- Complete the algorithm ***/
+	/*** Step 5 -- Complete the algorithm ***/
 
 	/* Handle blindness */
-	if (p_ptr->timed[TMD_BLIND])
+	if (blind)
 	{
 		/* Process "new" grids */
 		for (i = 0; i < fast_view_n; i++)
@@ -2679,10 +3113,13 @@ void update_view(void)
 			g = fast_view_g[i];
 
 			/* Grid cannot be "CAVE_SEEN" */
-			fast_cave_info[g] &= ~(CAVE_SEEN);
+			cave_info_off(cave, GRID_Y(g), GRID_X(g), CAVE_SEEN);
 		}
 	}
 
+	/* Start a new delta */
+	view_added_n = view_removed_n = 0;
+
 	/* Process "new" grids */
 	for (i = 0; i < fast_view_n; i++)
 	{
@@ -2690,77 +3127,104 @@ void update_view(void)
 		g = fast_view_g[i];
 
 		/* Get grid info */
-		info = fast_cave_info[g];
+		info = VIEW_INFO(g);
+
+		/* Was in view, see below */
+		if (info & (CAVE_TEMP)) continue;
+
+		/* Newly in view */
+		view_added_g[view_added_n++] = g;
 
 		/* Was not "CAVE_SEEN", is now "CAVE_SEEN" */
-		if ((info & (CAVE_SEEN)) && !(info & (CAVE_TEMP)))
-		{
-			int y, x;
-
-			/* Location */
-			y = GRID_Y(g);
-			x = GRID_X(g);
-			
-			/* Handle feeling squares */
-			if (cave->info2[y][x] & CAVE2_FEEL)
-			{
-				cave->feeling_squares++;
-				
-				/* Erase the square so you can't 'resee' it */
-				cave->info2[y][x] &= ~(CAVE2_FEEL);
-			
-				/* Display feeling if necessary */
-				if (cave->feeling_squares == FEELING1)
-					display_feeling(TRUE);
-		
-			}
-			
-			cave_note_spot(cave, y, x);
-			cave_light_spot(cave, y, x);
-		}
-	}
+		if (info & (CAVE_SEEN))
+			view_grid_seen(GRID_Y(g), GRID_X(g));
+	}
 
 	/* Process "old" grids */
 	for (i = 0; i < fast_temp_n; i++)
 	{
+		byte old_info = fast_temp_info[i];
+
 		/* Grid */
 		g = fast_temp_g[i];
 
 		/* Get grid info */
-		info = fast_cave_info[g];
+		info = VIEW_INFO(g);
 
 		/* Clear "CAVE_TEMP" flag */
 		info &= ~(CAVE_TEMP);
 
 		/* Save cave info */
-		fast_cave_info[g] = info;
+		cave_info_set(cave, GRID_Y(g), GRID_X(g), info);
 
-		/* Was "CAVE_SEEN", is now not "CAVE_SEEN" */
-		if (!(info & (CAVE_SEEN)))
+		/* No change */
+		if (!((info ^ old_info) & (CAVE_VIEW | CAVE_SEEN))) continue;
+
+		/* Was not "CAVE_SEEN", is now "CAVE_SEEN" */
+		if (info & (CAVE_SEEN))
 		{
-			int y, x;
+			view_added_g[view_added_n++] = g;
+			view_grid_seen(GRID_Y(g), GRID_X(g));
+		}
 
-			/* Location */
-			y = GRID_Y(g);
-			x = GRID_X(g);
+		/* Has left view, or is no longer "CAVE_SEEN" */
+		else
+		{
+			view_removed_g[view_removed_n++] = g;
 
-			/* Redraw */
-			cave_light_spot(cave, y, x);
+			/* Was "CAVE_SEEN", is now not "CAVE_SEEN" */
+			if (old_info & (CAVE_SEEN))
+				cave_light_spot(cave, GRID_Y(g), GRID_X(g));
 		}
 	}
 
 
 	/* Save 'view_n' */
 	view_n = fast_view_n;
+
+	/* Remember what the view was worked out from */
+	view_valid = TRUE;
+	view_py = py;
+	view_px = px;
+	view_radius = radius;
+	view_blind = blind;
+	view_lit_n = lit_n;
+}
+
+
+/*
+ * Get the grids which came into view, or became "CAVE_SEEN", at the last
+ * call to "update_view()"
+ */
+int view_added(const u16b **gp)
+{
+	*gp = view_added_g;
+	return (view_added_n);
+}
+
+/*
+ * Get the grids which left view, or stopped being "CAVE_SEEN", at the last
+ * call to "update_view()"
+ */
+int view_removed(const u16b **gp)
+{
+	*gp = view_removed_g;
+	return (view_removed_n);
 }
 
 
 
 
 /*
- * Size of the circular queue used by "update_flow()"
+ * The most grids whose terrain can change between two flow updates before
+ * it is cheaper to start the flow over than to repair it
  */
-#define FLOW_MAX 2048
+#define FLOW_DIRTY_MAX	64
+
+/*
+ * The most grids besides the player's that monsters can flow towards
+ */
+#define FLOW_SOURCES_MAX	8
 
 /*
  * Hack -- provide some "speed" for the "flow" code
@@ -2778,34 +3242,321 @@ void update_view(void)
  */
 static int flow_save = 0;
 
+/*
+ * What the current flow was worked out from: the cave, where the player
+ * stood, and the other sources, along with the grids whose terrain has
+ * changed since (flow_dirty_n goes past FLOW_DIRTY_MAX when too many have).
+ * Sources made by noises lapse with them, at the "c->sense_turn" given by
+ * "until"; other sources have an "until" of zero, and last until cleared.
+ */
+static struct cave *flow_cave = NULL;
+static int flow_py, flow_px;
+
+static struct {
+	int y, x;
+	int cost;
+	u16b until;
+} flow_sources[FLOW_SOURCES_MAX];
+static int flow_sources_n = 0;
+static bool flow_sources_moved = FALSE;
 
+static int flow_dirty[FLOW_DIRTY_MAX];
+static int flow_dirty_n = 0;
 
 /*
- * Hack -- forget the "flow" information
+ * The bucket queue of grids waiting to pass their cost on, one bucket per
+ * cost.  A grid may be queued more than once as its cost drops, and only
+ * the entry in the bucket matching its cost counts.
  */
-void cave_forget_flow(struct cave *c)
+static int *flow_bucket[MONSTER_FLOW_DEPTH];
+static int flow_bucket_n[MONSTER_FLOW_DEPTH];
+static int flow_bucket_size[MONSTER_FLOW_DEPTH];
+
+/*
+ * The grids a repair has forgotten
+ */
+static int *flow_lost;
+static int flow_lost_n, flow_lost_size;
+
+
+/*
+ * Append grid g to a growable list
+ */
+static void flow_push(int **list, int *n, int *size, int g)
 {
-	int x, y;
+	if (*n == *size)
+	{
+		*size = *size ? *size * 2 : 256;
+		*list = mem_realloc(*list, *size * sizeof **list);
+	}
 
-	/* Nothing to forget */
-	if (!flow_save) return;
+	(*list)[(*n)++] = g;
+}
+
+
+/*
+ * The cost of stepping into grid (y, x), or zero if the flow cannot pass
+ * through it.  Doors cost the extra turns a monster spends getting them
+ * open.
+ *
+ * Rubble has no cost, as only monsters which pass or destroy walls ever
+ * get through it, and those never follow the flow (see monster_can_flow()).
+ */
+static int flow_step(struct cave *c, int y, int x)
+{
+	int feat = cave_feat(c, y, x);
+
+	/* Ignore "walls" and "rubble" */
+	if (feat >= FEAT_RUBBLE) return (0);
+
+	/* Locked and jammed doors */
+	if (feat > FEAT_DOOR_HEAD && feat <= FEAT_DOOR_TAIL) return (3);
+
+	/* Closed and secret doors */
+	if (feat == FEAT_DOOR_HEAD || feat == FEAT_SECRET) return (2);
+
+	return (1);
+}
+
+
+/*
+ * Give grid (y, x) the given cost if that is cheaper than it has, and
+ * queue it to pass the cost on
+ */
+static void flow_seed(struct cave *c, int y, int x, int cost, int flow_n)
+{
+	int g = cave_grid(c, y, x);
+
+	/* Hack -- Limit flow depth */
+	if (cost >= MONSTER_FLOW_DEPTH) return;
+
+	/* Ignore grids that are already as cheap */
+	if (c->when[g] == flow_n && c->cost[g] <= cost) return;
+
+	c->when[g] = flow_n;
+	c->cost[g] = cost;
+	flow_push(&flow_bucket[cost], &flow_bucket_n[cost],
+		&flow_bucket_size[cost], g);
+}
+
+
+/*
+ * Empty the bucket queue in order of cost, so that every grid ends up
+ * with the cost of the cheapest way from it to a source
+ */
+static void flow_run(struct cave *c, int flow_n)
+{
+	int b, i, d;
+
+	for (b = 0; b < MONSTER_FLOW_DEPTH; b++)
+	{
+		/* Steps all cost at least one, so this bucket does not grow */
+		for (i = 0; i < flow_bucket_n[b]; i++)
+		{
+			int g = flow_bucket[b][i];
+			int ty = g / c->width;
+			int tx = g % c->width;
+
+			/* Ignore entries for a cost the grid no longer has */
+			if (c->cost[g] != b) continue;
+
+			/* Add the "children" */
+			for (d = 0; d < 8; d++)
+			{
+				int y = ty + ddy_ddd[d];
+				int x = tx + ddx_ddd[d];
+				int step = flow_step(c, y, x);
+
+				if (step) flow_seed(c, y, x, b + step, flow_n);
+			}
+		}
+
+		flow_bucket_n[b] = 0;
+	}
+}
+
+
+/*
+ * Work the flow out afresh from the player and the other sources
+ */
+static void flow_rebuild(struct cave *c)
+{
+	int y, x, i;
+
+	int flow_n;
+
+
+	/*** Cycle the flow ***/
+
+	/* Cycle the flow */
+	if (flow_save++ == 255)
+	{
+		/* Cycle the flow */
+		for (y = 0; y < c->height; y++)
+		{
+			for (x = 0; x < c->width; x++)
+			{
+				int w = cave_when(c, y, x);
+				cave_when(c, y, x) = (w >= 128) ? (w - 128) : 0;
+			}
+		}
+
+		/* Restart */
+		flow_save = 128;
+	}
+
+	/* Local variable */
+	flow_n = flow_save;
+
+
+	/*** Sources ***/
+
+	/* Forget old trails through grids that are now blocked */
+	for (i = 0; i < flow_dirty_n; i++)
+	{
+		int g = flow_dirty[i];
+
+		if (!flow_step(c, g / c->width, g % c->width))
+			c->when[g] = c->cost[g] = 0;
+	}
+
+	/* The player */
+	flow_seed(c, p_ptr->py, p_ptr->px, 0, flow_n);
+
+	/* The others */
+	for (i = 0; i < flow_sources_n; i++)
+		flow_seed(c, flow_sources[i].y, flow_sources[i].x,
+			flow_sources[i].cost, flow_n);
+
+	flow_run(c, flow_n);
+}
+
+
+/*
+ * Work out the cost of a grid from its neighbours (or from the sources
+ * it holds), and queue it if it can be reached at all
+ */
+static void flow_reseed(struct cave *c, int g, int flow_n)
+{
+	int y = g / c->width;
+	int x = g % c->width;
+	int step = flow_step(c, y, x);
+	int best = MONSTER_FLOW_DEPTH;
+	int i, d;
+
+	/* Already reached again */
+	if (c->when[g] == flow_n) return;
+
+	if (y == p_ptr->py && x == p_ptr->px) best = 0;
+
+	for (i = 0; i < flow_sources_n; i++)
+	{
+		if (flow_sources[i].y == y && flow_sources[i].x == x)
+			best = MIN(best, flow_sources[i].cost);
+	}
 
-	/* Check the entire dungeon */
-	for (y = 0; y < DUNGEON_HGT; y++)
+	for (d = 0; step && d < 8; d++)
 	{
-		for (x = 0; x < DUNGEON_WID; x++)
+		int n = cave_grid(c, y + ddy_ddd[d], x + ddx_ddd[d]);
+
+		if (c->when[n] == flow_n) best = MIN(best, c->cost[n] + step);
+	}
+
+	if (best < MONSTER_FLOW_DEPTH)
+		flow_seed(c, y, x, best, flow_n);
+
+	/* Unreachable now, and no use as a trail either */
+	else if (!step || !c->when[g])
+		c->when[g] = c->cost[g] = 0;
+}
+
+
+/*
+ * Mend the flow after the terrain of a few grids has changed, while the
+ * sources stayed put.  The changed grids and every grid whose cost was
+ * reached through one of them are forgotten, and then given their costs
+ * again from the grids around them that are still right.
+ */
+static void flow_repair(struct cave *c)
+{
+	int flow_n = flow_save;
+	int i, d;
+
+	flow_lost_n = 0;
+
+	/* Forget the changed grids that were in the flow */
+	for (i = 0; i < flow_dirty_n; i++)
+	{
+		int g = flow_dirty[i];
+
+		if (c->when[g] != flow_n) continue;
+
+		c->when[g] = 0;
+		flow_push(&flow_lost, &flow_lost_n, &flow_lost_size, g);
+	}
+
+	/* Forget the grids whose cost came through a forgotten grid */
+	for (i = 0; i < flow_lost_n; i++)
+	{
+		int g = flow_lost[i];
+		int ty = g / c->width;
+		int tx = g % c->width;
+
+		for (d = 0; d < 8; d++)
 		{
-			/* Forget the old data */
-			c->cost[y][x] = 0;
-			c->when[y][x] = 0;
+			int y = ty + ddy_ddd[d];
+			int x = tx + ddx_ddd[d];
+			int n = cave_grid(c, y, x);
+
+			if (c->when[n] != flow_n) continue;
+			if (c->cost[n] != c->cost[g] + flow_step(c, y, x)) continue;
+
+			c->when[n] = 0;
+			flow_push(&flow_lost, &flow_lost_n, &flow_lost_size, n);
 		}
 	}
 
+	/* Reach them again, along with changed grids that were not in it */
+	for (i = 0; i < flow_lost_n; i++)
+		flow_reseed(c, flow_lost[i], flow_n);
+
+	for (i = 0; i < flow_dirty_n; i++)
+		flow_reseed(c, flow_dirty[i], flow_n);
+
+	flow_run(c, flow_n);
+}
+
+
+/*
+ * Forget the flow, but not its sources
+ */
+static void flow_forget(struct cave *c)
+{
+	flow_cave = NULL;
+	flow_dirty_n = 0;
+
+	/* Nothing to forget */
+	if (!flow_save) return;
+
+	/* Forget the old data */
+	C_WIPE(c->cost, c->height * c->width, byte);
+	C_WIPE(c->when, c->height * c->width, byte);
+
 	/* Start over */
 	flow_save = 0;
 }
 
 
+/*
+ * Hack -- forget the "flow" information
+ */
+void cave_forget_flow(struct cave *c)
+{
+	flow_sources_n = 0;
+	flow_forget(c);
+}
+
+
 /*
  * Hack -- fill in the "cost" field of every grid that the player can
  * "reach" with the number of steps needed to reach that grid.  This
@@ -2814,124 +3565,321 @@ void cave_forget_flow(struct cave *c)
  * In addition, mark the "when" of the grids that can reach the player
  * with the incremented value of "flow_save".
  *
- * Hack -- use the local "flow_y" and "flow_x" arrays as a "circular
- * queue" of cave grids.
+ * Doors cost more than one step (see flow_step()), and grids added with
+ * cave_flow_add_source() are reached as well as the player, so the costs
+ * are found with a bucket queue in order of cost.
  *
- * We do not need a priority queue because the cost from grid to grid
- * is always "one" (even along diagonals) and we process them in order.
+ * Once the player moves every cost in the flow may change, and the "when"
+ * of every grid in it has to move on, so the flow is worked out afresh.
+ * When only the terrain has changed, the flow is mended around the grids
+ * that changed.
  */
 void cave_update_flow(struct cave *c)
 {
-	int py = p_ptr->py;
-	int px = p_ptr->px;
+	/* Too much has changed to mend the flow */
+	if (flow_dirty_n > FLOW_DIRTY_MAX) flow_forget(c);
+
+	if (c != flow_cave || flow_sources_moved ||
+			p_ptr->py != flow_py || p_ptr->px != flow_px)
+		flow_rebuild(c);
+	else if (flow_dirty_n)
+		flow_repair(c);
+
+	flow_cave = c;
+	flow_py = p_ptr->py;
+	flow_px = p_ptr->px;
+	flow_sources_moved = FALSE;
+	flow_dirty_n = 0;
+}
 
-	int ty, tx;
 
-	int y, x;
+/*
+ * Note that the terrain of grid (y, x) has changed in a way that matters
+ * to the flow
+ */
+static void flow_note(struct cave *c, int y, int x)
+{
+	if (c != flow_cave || !cave_in_bounds_fully(c, y, x)) return;
 
-	int n, d;
+	if (flow_dirty_n < FLOW_DIRTY_MAX)
+		flow_dirty[flow_dirty_n] = cave_grid(c, y, x);
 
-	int flow_n;
+	if (flow_dirty_n <= FLOW_DIRTY_MAX) flow_dirty_n++;
+
+	p_ptr->update |= (PU_UPDATE_FLOW);
+}
 
-	int flow_tail = 0;
-	int flow_head = 0;
 
-	byte flow_y[FLOW_MAX];
-	byte flow_x[FLOW_MAX];
+/*
+ * Have monsters flow towards grid (y, x) as well as the player, as if it
+ * were "cost" steps away from the player.  Returns FALSE if there are
+ * already as many sources as there can be.
+ */
+bool cave_flow_add_source(struct cave *c, int y, int x, int cost)
+{
+	assert(cave_in_bounds_fully(c, y, x));
 
+	if (flow_sources_n == FLOW_SOURCES_MAX) return (FALSE);
 
-	/*** Cycle the flow ***/
+	flow_sources[flow_sources_n].y = y;
+	flow_sources[flow_sources_n].x = x;
+	flow_sources[flow_sources_n].cost = cost;
+	flow_sources[flow_sources_n].until = 0;
+	flow_sources_n++;
 
-	/* Cycle the flow */
-	if (flow_save++ == 255)
+	flow_sources_moved = TRUE;
+	p_ptr->update |= (PU_UPDATE_FLOW);
+
+	return (TRUE);
+}
+
+
+/*
+ * Stop monsters flowing towards source i
+ */
+static void flow_remove_source(int i)
+{
+	flow_sources[i] = flow_sources[--flow_sources_n];
+
+	flow_sources_moved = TRUE;
+	p_ptr->update |= (PU_UPDATE_FLOW);
+}
+
+
+/*
+ * Have monsters which heard a noise at grid (y, x) go and look, while it
+ * lasts, unless the player is nearer.  The source is "loudness" steps
+ * further off than the player, so monsters only turn aside for it once the
+ * player has gone some way from where the noise was made.
+ *
+ * A noise made where one is already going on makes it last longer; when
+ * there are already as many sources as there can be, the noise replaces
+ * the one that would stop first.
+ */
+static void flow_add_noise(struct cave *c, int y, int x, int loudness)
+{
+	u16b until = c->sense_turn + loudness;
+	int i, first = -1;
+
+	if (c != flow_cave || loudness >= MONSTER_FLOW_DEPTH) return;
+
+	for (i = 0; i < flow_sources_n; i++)
 	{
-		/* Cycle the flow */
-		for (y = 0; y < DUNGEON_HGT; y++)
+		if (!flow_sources[i].until) continue;
+
+		/* Already making a noise here */
+		if (flow_sources[i].y == y && flow_sources[i].x == x)
 		{
-			for (x = 0; x < DUNGEON_WID; x++)
+			flow_sources[i].until = MAX(flow_sources[i].until, until);
+			if (loudness < flow_sources[i].cost)
 			{
-				int w = c->when[y][x];
-				c->when[y][x] = (w >= 128) ? (w - 128) : 0;
+				flow_sources[i].cost = loudness;
+				flow_sources_moved = TRUE;
+				p_ptr->update |= (PU_UPDATE_FLOW);
 			}
+			return;
 		}
 
-		/* Restart */
-		flow_save = 128;
+		if (first < 0 || flow_sources[i].until < flow_sources[first].until)
+			first = i;
 	}
 
-	/* Local variable */
-	flow_n = flow_save;
+	if (flow_sources_n == FLOW_SOURCES_MAX)
+	{
+		/* Only quieter noises can make way */
+		if (first < 0 || flow_sources[first].until >= until) return;
+		flow_remove_source(first);
+	}
 
+	flow_sources[flow_sources_n].y = y;
+	flow_sources[flow_sources_n].x = x;
+	flow_sources[flow_sources_n].cost = loudness;
+	flow_sources[flow_sources_n].until = until;
+	flow_sources_n++;
 
-	/*** Player Grid ***/
+	flow_sources_moved = TRUE;
+	p_ptr->update |= (PU_UPDATE_FLOW);
+}
+
+
+/*
+ * Let the sources made by noises lapse with them, moving them back with
+ * the clock when it is moved back by "rebase"
+ */
+static void flow_age_sources(struct cave *c, int rebase)
+{
+	int i;
+
+	if (c != flow_cave) return;
 
-	/* Save the time-stamp */
-	c->when[py][px] = flow_n;
+	for (i = flow_sources_n - 1; i >= 0; i--)
+	{
+		if (!flow_sources[i].until) continue;
+
+		if (flow_sources[i].until <= c->sense_turn)
+			flow_remove_source(i);
+		else
+			flow_sources[i].until -= rebase;
+	}
+}
 
-	/* Save the flow cost */
-	c->cost[py][px] = 0;
 
-	/* Enqueue that entry */
-	flow_y[flow_head] = py;
-	flow_x[flow_head] = px;
+/*
+ * Have monsters flow towards the player alone again
+ */
+void cave_flow_clear_sources(struct cave *c)
+{
+	if (!flow_sources_n) return;
 
-	/* Advance the queue */
-	++flow_tail;
+	flow_sources_n = 0;
 
+	flow_sources_moved = TRUE;
+	p_ptr->update |= (PU_UPDATE_FLOW);
+}
+
+
+
+/*
+ * Noise and scent
+ *
+ * Besides the flow, monsters can follow two fainter signs of the player,
+ * each kept in a layer of the cave and stamped with c->sense_turn, which
+ * moves on once per player turn.  The scent of a grid is the turn the
+ * player last stood in it; the noise of a grid is the turn by which the
+ * last noise heard there will have died away.  Either can be asked about
+ * in constant time, so the monster AI can use them to tell whether the
+ * player is anywhere about before doing anything expensive.
+ *
+ * A zero stamp means "never", so when the clock nears the top of its range
+ * every stamp is moved back by SENSE_REBASE, forgetting the oldest ones.
+ */
+#define SENSE_REBASE	0x8000
+
+/* Queue of grids the noise is spreading through */
+static int *noise_queue;
+static int noise_queue_size;
+
+
+/*
+ * Move the noise and scent clock on by one player turn
+ */
+void cave_senses_tick(struct cave *c)
+{
+	int i, n = c->height * c->width;
+
+	c->sense_turn++;
+
+	/* Leave room for the loudest noise above the clock */
+	if (c->sense_turn < 0xFFFF - MAX_UCHAR)
+	{
+		flow_age_sources(c, 0);
+		return;
+	}
 
-	/*** Process Queue ***/
+	flow_age_sources(c, SENSE_REBASE);
 
-	/* Now process the queue */
-	while (flow_head != flow_tail)
+	for (i = 0; i < n; i++)
 	{
-		/* Extract the next entry */
-		ty = flow_y[flow_head];
-		tx = flow_x[flow_head];
+		c->scent[i] = (c->scent[i] > SENSE_REBASE) ?
+			c->scent[i] - SENSE_REBASE : 0;
+		c->noise[i] = (c->noise[i] > SENSE_REBASE) ?
+			c->noise[i] - SENSE_REBASE : 0;
+	}
 
-		/* Forget that entry (with wrap) */
-		if (++flow_head == FLOW_MAX) flow_head = 0;
+	c->sense_turn -= SENSE_REBASE;
+}
 
-		/* Child cost */
-		n = c->cost[ty][tx] + 1;
 
-		/* Hack -- Limit flow depth */
-		if (n == MONSTER_FLOW_DEPTH) continue;
+/*
+ * Note that the player has just stood in grid (y, x)
+ */
+void cave_leave_scent(struct cave *c, int y, int x)
+{
+	c->scent[cave_grid(c, y, x)] = c->sense_turn;
+}
 
-		/* Add the "children" */
-		for (d = 0; d < 8; d++)
-		{
-			int old_head = flow_tail;
 
-			/* Child location */
-			y = ty + ddy_ddd[d];
-			x = tx + ddx_ddd[d];
+/*
+ * How many player turns ago the player stood in grid (y, x), or -1 if
+ * the player has not been there (or not for a very long time)
+ */
+int cave_scent_age(struct cave *c, int y, int x)
+{
+	u16b s = c->scent[cave_grid(c, y, x)];
 
-			/* Ignore "pre-stamped" entries */
-			if (c->when[y][x] == flow_n) continue;
+	return (s ? c->sense_turn - s : -1);
+}
 
-			/* Ignore "walls" and "rubble" */
-			if (c->feat[y][x] >= FEAT_RUBBLE) continue;
 
-			/* Save the time-stamp */
-			c->when[y][x] = flow_n;
+/*
+ * Make a noise at grid (y, x) which carries "loudness" steps and lasts as
+ * many turns, fading by a turn with each step.  While it lasts, monsters
+ * may flow towards it (see flow_add_noise()).
+ *
+ * The noise spreads breadth-first through the grids the flow can pass
+ * through, and stops wherever a louder noise has already been heard.
+ */
+void cave_make_noise(struct cave *c, int y, int x, int loudness)
+{
+	int head = 0, tail = 0;
+	int g = cave_grid(c, y, x);
+
+	assert(cave_in_bounds(c, y, x));
+	assert(loudness >= 0 && loudness <= MAX_UCHAR);
+
+	if (c->noise[g] >= c->sense_turn + loudness) return;
 
-			/* Save the flow cost */
-			c->cost[y][x] = n;
+	flow_add_noise(c, y, x, loudness);
 
-			/* Enqueue that entry */
-			flow_y[flow_tail] = y;
-			flow_x[flow_tail] = x;
+	c->noise[g] = c->sense_turn + loudness;
+	flow_push(&noise_queue, &tail, &noise_queue_size, g);
 
-			/* Advance the queue */
-			if (++flow_tail == FLOW_MAX) flow_tail = 0;
+	while (head < tail)
+	{
+		int d;
+
+		g = noise_queue[head++];
+		y = g / c->width;
+		x = g % c->width;
 
-			/* Hack -- Overflow by forgetting new entry */
-			if (flow_tail == flow_head) flow_tail = old_head;
+		/* Faded away */
+		if (c->noise[g] <= c->sense_turn + 1) continue;
+
+		for (d = 0; d < 8; d++)
+		{
+			int y2 = y + ddy_ddd[d];
+			int x2 = x + ddx_ddd[d];
+			int g2;
+
+			if (!cave_in_bounds(c, y2, x2)) continue;
+
+			g2 = cave_grid(c, y2, x2);
+
+			/* Already as loud */
+			if (c->noise[g2] >= c->noise[g] - 1) continue;
+
+			/* Sound does not pass through walls and rubble */
+			if (!flow_step(c, y2, x2)) continue;
+
+			c->noise[g2] = c->noise[g] - 1;
+			flow_push(&noise_queue, &tail, &noise_queue_size, g2);
 		}
 	}
 }
 
 
+/*
+ * How many more player turns the noise heard at grid (y, x) lasts, or 0
+ * if nothing has been heard there lately
+ */
+int cave_noise(struct cave *c, int y, int x)
+{
+	u16b n = c->noise[cave_grid(c, y, x)];
+
+	return (n > c->sense_turn ? n - c->sense_turn : 0);
+}
+
+
 
 
 /*
@@ -2961,13 +3909,13 @@ void wiz_light(void)
 	}
 
 	/* Scan all normal grids */
-	for (y = 1; y < DUNGEON_HGT-1; y++)
+	for (y = 1; y < cave->height - 1; y++)
 	{
 		/* Scan all normal grids */
-		for (x = 1; x < DUNGEON_WID-1; x++)
+		for (x = 1; x < cave->width - 1; x++)
 		{
 			/* Process all non-walls */
-			if (cave->feat[y][x] < FEAT_SECRET)
+			if (cave_feat(cave, y, x) < FEAT_SECRET)
 			{
 				/* Scan all neighbors */
 				for (i = 0; i < 9; i++)
@@ -2976,11 +3924,11 @@ void wiz_light(void)
 					int xx = x + ddx_ddd[i];
 
 					/* Perma-light the grid */
-					cave->info[yy][xx] |= (CAVE_GLOW);
+					cave_info_on(cave, yy, xx, CAVE_GLOW);
 
 					/* Memorize normal features */
-					if (cave->feat[yy][xx] > FEAT_INVIS)
-						cave->info[yy][xx] |= (CAVE_MARK);
+					if (cave_feat(cave, yy, xx) > FEAT_INVIS)
+						cave_info_on(cave, yy, xx, CAVE_MARK);
 				}
 			}
 		}
@@ -3003,15 +3951,13 @@ void wiz_dark(void)
 
 
 	/* Forget every grid */
-	for (y = 0; y < DUNGEON_HGT; y++)
-	{
-		for (x = 0; x < DUNGEON_WID; x++)
-		{
-			/* Process the grid */
-			cave->info[y][x] &= ~(CAVE_MARK);
-			cave->info2[y][x] &= ~(CAVE2_DTRAP);
-		}
-	}
+	cave_info_fill(cave, 0, 0, cave->height - 1, cave->width - 1, CAVE_MARK,
+		FALSE);
+
+	/* Forget detected traps */
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++)
+			cave_info2(cave, y, x) &= ~(CAVE2_DTRAP);
 
 	/* Forget all objects */
 	for (i = 1; i < o_max; i++)
@@ -3051,33 +3997,33 @@ void cave_illuminate(struct cave *c, bool daytime)
 		for (x = 0; x < c->width; x++)
 		{
 			/* Interesting grids */
-			if (c->feat[y][x] > FEAT_INVIS)
+			if (cave_feat(c, y, x) > FEAT_INVIS)
 			{
 				/* Illuminate the grid */
-				c->info[y][x] |= (CAVE_GLOW);
+				cave_info_on(c, y, x, CAVE_GLOW);
 
 				/* Memorize the grid */
-				c->info[y][x] |= (CAVE_MARK);
+				cave_info_on(c, y, x, CAVE_MARK);
 			}
 
 			/* Boring grids (light) */
 			else if (daytime)
 			{
 				/* Illuminate the grid */
-				c->info[y][x] |= (CAVE_GLOW);
+				cave_info_on(c, y, x, CAVE_GLOW);
 
 				/* Memorize grids */
-				c->info[y][x] |= (CAVE_MARK);
+				cave_info_on(c, y, x, CAVE_MARK);
 			}
 
 			/* Boring grids (dark) */
 			else
 			{
 				/* Darken the grid */
-				c->info[y][x] &= ~(CAVE_GLOW);
+				cave_info_off(c, y, x, CAVE_GLOW);
 
 				/* Forget grids */
-				c->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(c, y, x, CAVE_MARK);
 			}
 		}
 	}
@@ -3089,8 +4035,8 @@ void cave_illuminate(struct cave *c, bool daytime)
 		for (x = 0; x < c->width; x++)
 		{
 			/* Track shop doorways */
-			if ((c->feat[y][x] >= FEAT_SHOP_HEAD) &&
-			    (c->feat[y][x] <= FEAT_SHOP_TAIL))
+			if ((cave_feat(c, y, x) >= FEAT_SHOP_HEAD) &&
+			    (cave_feat(c, y, x) <= FEAT_SHOP_TAIL))
 			{
 				for (i = 0; i < 8; i++)
 				{
@@ -3098,10 +4044,10 @@ void cave_illuminate(struct cave *c, bool daytime)
 					int xx = x + ddx_ddd[i];
 
 					/* Illuminate the grid */
-					c->info[yy][xx] |= (CAVE_GLOW);
+					cave_info_on(c, yy, xx, CAVE_GLOW);
 
 					/* Memorize grids */
-					c->info[yy][xx] |= (CAVE_MARK);
+					cave_info_on(c, yy, xx, CAVE_MARK);
 				}
 			}
 		}
@@ -3115,24 +4061,291 @@ void cave_illuminate(struct cave *c, bool daytime)
 	p_ptr->redraw |= (PR_MAP | PR_MONLIST | PR_ITEMLIST);
 }
 
+/**
+ * Note that the CAVE_WALL or CAVE_GLOW flag of grid (y, x) has changed, which
+ * makes the player's view out of date if the grid is close enough to it.
+ */
+static void view_note_change(struct cave *c, int y, int x)
+{
+	if (c == view_cave && view_valid &&
+			distance(y, x, view_py, view_px) <= MAX_SIGHT)
+		view_valid = FALSE;
+}
+
+/**
+ * Set the CAVE_* flags of grid (y, x) to info, updating the bitplanes of
+ * the flags that change.
+ */
+void cave_info_set(struct cave *c, int y, int x, byte info)
+{
+	byte changed = cave_info(c, y, x) ^ info;
+	int i = y * c->planes[0]->words + x / BITBOARD_WORD_BITS;
+	u64b bit = (u64b)1 << (x % BITBOARD_WORD_BITS);
+	int k;
+
+	if (!changed) return;
+
+	cave_info_byte(c, y, x) = info;
+
+	if (changed & (CAVE_WALL | CAVE_GLOW))
+		view_note_change(c, y, x);
+
+	for (k = 0; changed; k++, changed >>= 1)
+		if (changed & 1)
+			c->planes[k]->bits[i] ^= bit;
+}
+
+void cave_info_on(struct cave *c, int y, int x, byte flags)
+{
+	cave_info_set(c, y, x, cave_info(c, y, x) | flags);
+}
+
+void cave_info_off(struct cave *c, int y, int x, byte flags)
+{
+	cave_info_set(c, y, x, cave_info(c, y, x) & ~flags);
+}
+
+/**
+ * Turn the CAVE_* flag with bitplane k on (or off) in the grids of row y
+ * which are picked out by mask in word i of the row.
+ */
+static void cave_info_fill_word(struct cave *c, int k, int y, int i,
+	u64b mask, bool on)
+{
+	u64b *w = BITBOARD_ROW(c->planes[k], y) + i;
+	u64b changed = mask & (on ? ~*w : *w);
+
+	*w ^= changed;
+
+	while (changed) {
+		int x = i * BITBOARD_WORD_BITS + bitboard_first(changed);
+
+		if (on)
+			cave_info_byte(c, y, x) |= 1 << k;
+		else
+			cave_info_byte(c, y, x) &= ~(1 << k);
+
+		if ((1 << k) & (CAVE_WALL | CAVE_GLOW))
+			view_note_change(c, y, x);
+
+		changed &= changed - 1;
+	}
+}
+
+/**
+ * Turn the CAVE_* flags on (or off) over the rectangle from (y1, x1) to
+ * (y2, x2) inclusive.
+ *
+ * The bitplanes are updated a word at a time, and only the grids whose flags
+ * actually change have their info touched, so clearing a flag which is set
+ * in a handful of grids costs a few hundred word operations however big the
+ * rectangle is.
+ */
+void cave_info_fill(struct cave *c, int y1, int x1, int y2, int x2,
+	byte flags, bool on)
+{
+	int k, y, i;
+
+	for (k = 0; k < 8; k++) {
+		if (!(flags & (1 << k))) continue;
+
+		for (y = y1; y <= y2; y++)
+			for (i = x1 / BITBOARD_WORD_BITS; i <= x2 / BITBOARD_WORD_BITS; i++)
+				cave_info_fill_word(c, k, y, i, bitboard_span(i, x1, x2), on);
+	}
+}
+
+/**
+ * Turn the CAVE_* flags on (or off) in every grid which is set in b, a board
+ * the size of the dungeon.
+ */
+void cave_info_mask(struct cave *c, const struct bitboard *b, byte flags,
+	bool on)
+{
+	int k, y, i;
+
+	for (k = 0; k < 8; k++) {
+		if (!(flags & (1 << k))) continue;
+
+		for (y = 0; y < b->height; y++)
+			for (i = 0; i < b->words; i++)
+				cave_info_fill_word(c, k, y, i, BITBOARD_ROW(b, y)[i], on);
+	}
+}
+
+/**
+ * Return the number of grids in the rectangle from (y1, x1) to (y2, x2)
+ * inclusive which have the CAVE_* flag flag.
+ */
+int cave_info_count(struct cave *c, int y1, int x1, int y2, int x2,
+	byte flag)
+{
+	return bitboard_count_rect(c->planes[bitboard_first(flag)], y1, x1, y2,
+		x2);
+}
+
+/**
+ * True if any grid in the rectangle from (y1, x1) to (y2, x2) inclusive has
+ * the CAVE_* flag flag.
+ */
+bool cave_info_any(struct cave *c, int y1, int x1, int y2, int x2,
+	byte flag)
+{
+	struct bitboard *b = c->planes[bitboard_first(flag)];
+	int y, i;
+
+	for (y = y1; y <= y2; y++) {
+		const u64b *row = BITBOARD_ROW(b, y);
+
+		for (i = x1 / BITBOARD_WORD_BITS; i <= x2 / BITBOARD_WORD_BITS; i++)
+			if (row[i] & bitboard_span(i, x1, x2)) return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Note in c->empty_grids whether grid (y, x) is now empty.
+ */
+static void cave_note_empty(struct cave *c, int y, int x)
+{
+	bitboard_put(c->empty_grids, y, x, cave_isempty(c, y, x));
+}
+
+/**
+ * Set the monster index of grid (y, x); negative for the player.
+ */
+void cave_set_m_idx(struct cave *c, int y, int x, int m_idx)
+{
+	cave_m_idx_raw(c, y, x) = m_idx;
+	bitboard_put(c->monster_grids, y, x, m_idx > 0);
+	cave_note_empty(c, y, x);
+}
+
+/**
+ * Set the index of the first object on the floor of grid (y, x).
+ */
+void cave_set_o_idx(struct cave *c, int y, int x, int o_idx)
+{
+	cave_o_idx_raw(c, y, x) = o_idx;
+	bitboard_put(c->object_grids, y, x, o_idx != 0);
+	cave_note_empty(c, y, x);
+}
+
+/**
+ * Start a walk over the grids of b in the rectangle from (y1, x1) to
+ * (y2, x2) inclusive, clipped to the cave.
+ */
+static void cave_iter_start(struct cave_iter *it, struct cave *c,
+	const struct bitboard *b, int y1, int x1, int y2, int x2)
+{
+	it->b = b;
+	it->y1 = MAX(y1, 0);
+	it->x1 = MAX(x1, 0);
+	it->y2 = MIN(y2, c->height - 1);
+	it->x2 = MIN(x2, c->width - 1);
+	it->r = -1;
+	it->los = FALSE;
+
+	/* Nothing to walk */
+	if (it->x1 > it->x2) it->y2 = it->y1 - 1;
+
+	/* Sit at the end of the row before the first */
+	it->y = it->y1 - 1;
+	it->i = it->x2 / BITBOARD_WORD_BITS;
+	it->w = 0;
+}
+
+/**
+ * Start a walk over the monsters in the rectangle from (y1, x1) to (y2, x2)
+ * inclusive. The player is not among them.
+ */
+void cave_iter_monsters(struct cave_iter *it, struct cave *c,
+	int y1, int x1, int y2, int x2)
+{
+	cave_iter_start(it, c, c->monster_grids, y1, x1, y2, x2);
+}
+
+/**
+ * Start a walk over the grids with floor objects in the rectangle from
+ * (y1, x1) to (y2, x2) inclusive.
+ */
+void cave_iter_objects(struct cave_iter *it, struct cave *c,
+	int y1, int x1, int y2, int x2)
+{
+	cave_iter_start(it, c, c->object_grids, y1, x1, y2, x2);
+}
+
+/**
+ * Keep a walk to the grids within distance r of (y, x), and if los is set
+ * to those in line of sight of it as well.
+ */
+void cave_iter_near(struct cave_iter *it, int y, int x, int r, bool los)
+{
+	it->cy = y;
+	it->cx = x;
+	it->r = r;
+	it->los = los;
+
+	if (los) los_source_init(&it->from, y, x);
+}
+
+/**
+ * Find the next grid of a walk, returning FALSE when there are no more.
+ */
+bool cave_iter_next(struct cave_iter *it, int *y, int *x)
+{
+	while (it->y <= it->y2) {
+		while (it->w) {
+			int gx = it->i * BITBOARD_WORD_BITS + bitboard_first(it->w);
+
+			it->w &= it->w - 1;
+
+			if (it->r >= 0 && distance(it->cy, it->cx, it->y, gx) > it->r)
+				continue;
+			if (it->los && !los_from(&it->from, it->y, gx))
+				continue;
+
+			*y = it->y;
+			*x = gx;
+			return TRUE;
+		}
+
+		/* On to the next word of the row, or the first of the next row */
+		if (++it->i > it->x2 / BITBOARD_WORD_BITS) {
+			it->y++;
+			it->i = it->x1 / BITBOARD_WORD_BITS;
+		}
+
+		if (it->y <= it->y2)
+			it->w = BITBOARD_ROW(it->b, it->y)[it->i] &
+				bitboard_span(it->i, it->x1, it->x2);
+	}
+
+	return FALSE;
+}
+
 void cave_set_feat(struct cave *c, int y, int x, int feat)
 {
+	int step;
+
 	assert(c);
-	assert(y >= 0 && y < DUNGEON_HGT);
-	assert(x >= 0 && x < DUNGEON_WID);
-	/* XXX: Check against c->height and c->width instead, once everywhere
-	 * honors those... */
+	assert(cave_in_bounds(c, y, x));
 
-	c->feat[y][x] = feat;
+	step = flow_step(c, y, x);
+	cave_feat(c, y, x) = feat;
+	cave_note_empty(c, y, x);
 
 	if (feat >= FEAT_DOOR_HEAD)
-		c->info[y][x] |= CAVE_WALL;
+		cave_info_on(c, y, x, CAVE_WALL);
 	else
-		c->info[y][x] &= ~CAVE_WALL;
+		cave_info_off(c, y, x, CAVE_WALL);
 
 	if (character_dungeon) {
 		cave_note_spot(c, y, x);
 		cave_light_spot(c, y, x);
+
+		if (flow_step(c, y, x) != step) flow_note(c, y, x);
 	}
 }
 
@@ -3146,9 +4359,32 @@ bool cave_in_bounds_fully(struct cave *c, int y, int x)
 	return x > 0 && x < c->width - 1 && y > 0 && y < c->height - 1;
 }
 
+/*
+ * The projection path table.  For every offset (dy, dx) from the start of
+ * a path, up to PATH_RADIUS each way, it holds the grids a projection of
+ * range MAX_RANGE crosses when nothing gets in its way, and the distance
+ * travelled on reaching each, so that finding a path only has to check
+ * those grids for walls and monsters.
+ */
+#define PATH_RADIUS	MAX_RANGE
+#define PATH_SIDE	(2 * PATH_RADIUS + 1)
+#define PATH_OFFSET(DY, DX)	(((DY) + PATH_RADIUS) * PATH_SIDE + (DX) + PATH_RADIUS)
+
+struct path_step {
+	s16b dy, dx;
+	s16b dist;
+};
+
+static struct path_step path_steps[PATH_SIDE * PATH_SIDE][MAX_RANGE];
+static byte path_count[PATH_SIDE * PATH_SIDE];
+
+
 /*
  * Determine the path taken by a projection.
  *
+ * This walks the path in cave "c" one grid at a time; "project_path()" gets
+ * the same paths from a table built by running this once per offset.
+ *
  * The projection will always start from the grid (y1,x1), and will travel
  * towards the grid (y2,x2), touching one grid per unit of distance along
  * the major axis, and stopping when it enters the destination grid or a
@@ -3186,7 +4422,8 @@ bool cave_in_bounds_fully(struct cave *c, int y, int x)
  * This algorithm is similar to, but slightly different from, the one used
  * by "update_view_los()", and very different from the one used by "los()".
  */
-int project_path(u16b *gp, int range, int y1, int x1, int y2, int x2, int flg)
+int project_path_walk(struct cave *c, u16b *gp, int range, int y1, int x1,
+		int y2, int x2, int flg)
 {
 	int y, x;
 
@@ -3274,12 +4511,12 @@ int project_path(u16b *gp, int range, int y1, int x1, int y2, int x2, int flg)
 			}
 
 			/* Always stop at non-initial wall grids */
-			if ((n > 0) && !cave_floor_bold(y, x)) break;
+			if ((n > 0) && (cave_info(c, y, x) & (CAVE_WALL))) break;
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
 			{
-				if ((n > 0) && (cave->m_idx[y][x] != 0)) break;
+				if ((n > 0) && (cave_m_idx(c, y, x) != 0)) break;
 			}
 
 			/* Slant */
@@ -3336,12 +4573,12 @@ int project_path(u16b *gp, int range, int y1, int x1, int y2, int x2, int flg)
 			}
 
 			/* Always stop at non-initial wall grids */
-			if ((n > 0) && !cave_floor_bold(y, x)) break;
+			if ((n > 0) && (cave_info(c, y, x) & (CAVE_WALL))) break;
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
 			{
-				if ((n > 0) && (cave->m_idx[y][x] != 0)) break;
+				if ((n > 0) && (cave_m_idx(c, y, x) != 0)) break;
 			}
 
 			/* Slant */
@@ -3392,12 +4629,12 @@ int project_path(u16b *gp, int range, int y1, int x1, int y2, int x2, int flg)
 			}
 
 			/* Always stop at non-initial wall grids */
-			if ((n > 0) && !cave_floor_bold(y, x)) break;
+			if ((n > 0) && (cave_info(c, y, x) & (CAVE_WALL))) break;
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
 			{
-				if ((n > 0) && (cave->m_idx[y][x] != 0)) break;
+				if ((n > 0) && (cave_m_idx(c, y, x) != 0)) break;
 			}
 
 			/* Advance (Y) */
@@ -3414,6 +4651,110 @@ int project_path(u16b *gp, int range, int y1, int x1, int y2, int x2, int flg)
 }
 
 
+/*
+ * Build the projection path table, by walking a path of range MAX_RANGE
+ * through each offset in an open cave.
+ */
+errr project_path_init(void)
+{
+	struct cave *c = cave_new();
+	u16b grids[MAX_RANGE];
+	int dy, dx, i, n;
+
+	cave_resize(c, PATH_SIDE, PATH_SIDE);
+
+	for (dy = -PATH_RADIUS; dy <= PATH_RADIUS; dy++)
+	{
+		for (dx = -PATH_RADIUS; dx <= PATH_RADIUS; dx++)
+		{
+			struct path_step *steps = path_steps[PATH_OFFSET(dy, dx)];
+
+			n = project_path_walk(c, grids, MAX_RANGE, PATH_RADIUS,
+				PATH_RADIUS, PATH_RADIUS + dy, PATH_RADIUS + dx,
+				PROJECT_THRU);
+
+			for (i = 0; i < n; i++)
+			{
+				steps[i].dy = GRID_Y(grids[i]) - PATH_RADIUS;
+				steps[i].dx = GRID_X(grids[i]) - PATH_RADIUS;
+
+				/* Distance is the major axis plus half the minor one */
+				steps[i].dist = (i + 1) +
+					MIN(ABS(steps[i].dy), ABS(steps[i].dx)) / 2;
+			}
+
+			path_count[PATH_OFFSET(dy, dx)] = n;
+		}
+	}
+
+	cave_free(c);
+
+	return (0);
+}
+
+
+/*
+ * Determine the path taken by a projection in the current cave, as
+ * "project_path_walk()" does.
+ *
+ * Paths to destinations within PATH_RADIUS each way, of range up to
+ * MAX_RANGE, are read from the table built by "project_path_init()", so
+ * only the checks for walls and monsters look at the cave.
+ */
+int project_path(u16b *gp, int range, int y1, int x1, int y2, int x2, int flg)
+{
+	const struct path_step *steps;
+
+	int dy = y2 - y1;
+	int dx = x2 - x1;
+
+	int i, count, n = 0;
+
+
+	/* No path necessary (or allowed) */
+	if ((x1 == x2) && (y1 == y2)) return (0);
+
+	/* Too far for the table */
+	if ((ABS(dy) > PATH_RADIUS) || (ABS(dx) > PATH_RADIUS) ||
+		(range > MAX_RANGE))
+		return (project_path_walk(cave, gp, range, y1, x1, y2, x2, flg));
+
+	steps = path_steps[PATH_OFFSET(dy, dx)];
+	count = path_count[PATH_OFFSET(dy, dx)];
+
+	/* Check the grids the path would cross if nothing stopped it */
+	for (i = 0; i < count; i++)
+	{
+		int y = y1 + steps[i].dy;
+		int x = x1 + steps[i].dx;
+
+		/* Save grid */
+		gp[n++] = GRID(y,x);
+
+		/* Hack -- Check maximum range */
+		if (steps[i].dist >= range) break;
+
+		/* Sometimes stop at destination grid */
+		if (!(flg & (PROJECT_THRU)))
+		{
+			if ((x == x2) && (y == y2)) break;
+		}
+
+		/* Always stop at non-initial wall grids */
+		if (!cave_floor_bold(y, x)) break;
+
+		/* Sometimes stop at non-initial monsters/players */
+		if (flg & (PROJECT_STOP))
+		{
+			if (cave_m_idx(cave, y, x) != 0) break;
+		}
+	}
+
+	/* Length */
+	return (n);
+}
+
+
 /*
  * Determine if a bolt spell cast from (y1,x1) to (y2,x2) will arrive
  * at the final destination, assuming that no monster gets in the way,
@@ -3468,10 +4809,14 @@ void scatter(int *yp, int *xp, int y, int x, int d, int m)
 {
 	int nx, ny;
 
+	struct los_source from;
+
 
 	/* Unused parameter */
 	(void)m;
 
+	los_source_init(&from, y, x);
+
 	/* Pick a location */
 	while (TRUE)
 	{
@@ -3486,7 +4831,7 @@ void scatter(int *yp, int *xp, int y, int x, int d, int m)
 		if ((d > 1) && (distance(y, x, ny, nx) > d)) continue;
 
 		/* Require "line of sight" */
-		if (los(y, x, ny, nx)) break;
+		if (los_from(&from, ny, nx)) break;
 	}
 
 	/* Save the location */
@@ -3597,32 +4942,123 @@ bool is_quest(int level)
 
 struct cave *cave = NULL;
 
+/**
+ * Make a new cave. It has no grids until cave_resize() gives it some.
+ */
 struct cave *cave_new(void) {
 	struct cave *c = mem_zalloc(sizeof *c);
-	c->info = C_ZNEW(DUNGEON_HGT, byte_256);
-	c->info2 = C_ZNEW(DUNGEON_HGT, byte_256);
-	c->feat = C_ZNEW(DUNGEON_HGT, byte_wid);
-	c->cost = C_ZNEW(DUNGEON_HGT, byte_wid);
-	c->when = C_ZNEW(DUNGEON_HGT, byte_wid);
-	c->m_idx = C_ZNEW(DUNGEON_HGT, s16b_wid);
-	c->o_idx = C_ZNEW(DUNGEON_HGT, s16b_wid);
 
 	c->monsters = C_ZNEW(z_info->m_max, struct monster);
+	c->mon_ready = bitboard_new(1, z_info->m_max);
 	c->mon_max = 1;
 
 	c->created_at = 1;
 	return c;
 }
 
+/**
+ * Free the grids of a cave.
+ */
+static void cave_free_grids(struct cave *c) {
+	int i;
+
+#ifdef CAVE_PACKED_GRIDS
+	FREE(c->squares);
+#else
+	FREE(c->info);
+	FREE(c->info2);
+	FREE(c->feat);
+	FREE(c->m_idx);
+	FREE(c->o_idx);
+#endif
+	FREE(c->cost);
+	FREE(c->when);
+	FREE(c->noise);
+	FREE(c->scent);
+
+	for (i = 0; i < 8; i++) {
+		if (c->planes[i]) bitboard_free(c->planes[i]);
+		c->planes[i] = NULL;
+	}
+
+	if (c->monster_grids) bitboard_free(c->monster_grids);
+	if (c->object_grids) bitboard_free(c->object_grids);
+	if (c->empty_grids) bitboard_free(c->empty_grids);
+	c->monster_grids = c->object_grids = c->empty_grids = NULL;
+}
+
+/**
+ * Give a cave fresh, clear grids for a level of the given size, throwing
+ * away the old ones. Storage is only reallocated when the size changes.
+ *
+ * Grids are addressed by GRID() elsewhere, so neither dimension may be more
+ * than 256.
+ */
+void cave_resize(struct cave *c, int height, int width) {
+	int i, n = height * width;
+
+	assert(height > 0 && height <= 256);
+	assert(width > 0 && width <= 256);
+
+	/* Any view of the old grids goes with them */
+	cave_view_reset(c);
+
+	if (height != c->height || width != c->width || !c->cost) {
+		cave_free_grids(c);
+
+		c->height = height;
+		c->width = width;
+
+#ifdef CAVE_PACKED_GRIDS
+		c->squares = C_ZNEW(n, struct square);
+#else
+		c->info = C_ZNEW(n, byte);
+		c->info2 = C_ZNEW(n, byte);
+		c->feat = C_ZNEW(n, byte);
+		c->m_idx = C_ZNEW(n, s16b);
+		c->o_idx = C_ZNEW(n, s16b);
+#endif
+		c->cost = C_ZNEW(n, byte);
+		c->when = C_ZNEW(n, byte);
+		c->noise = C_ZNEW(n, u16b);
+		c->scent = C_ZNEW(n, u16b);
+
+		for (i = 0; i < 8; i++)
+			c->planes[i] = bitboard_new(height, width);
+		c->monster_grids = bitboard_new(height, width);
+		c->object_grids = bitboard_new(height, width);
+		c->empty_grids = bitboard_new(height, width);
+	} else {
+#ifdef CAVE_PACKED_GRIDS
+		C_WIPE(c->squares, n, struct square);
+#else
+		C_WIPE(c->info, n, byte);
+		C_WIPE(c->info2, n, byte);
+		C_WIPE(c->feat, n, byte);
+		C_WIPE(c->m_idx, n, s16b);
+		C_WIPE(c->o_idx, n, s16b);
+#endif
+		C_WIPE(c->cost, n, byte);
+		C_WIPE(c->when, n, byte);
+		C_WIPE(c->noise, n, u16b);
+		C_WIPE(c->scent, n, u16b);
+
+		for (i = 0; i < 8; i++)
+			bitboard_wipe(c->planes[i]);
+		bitboard_wipe(c->monster_grids);
+		bitboard_wipe(c->object_grids);
+		bitboard_wipe(c->empty_grids);
+	}
+
+	/* Stamps of zero mean "never" */
+	c->sense_turn = 1;
+}
+
 void cave_free(struct cave *c) {
-	mem_free(c->info);
-	mem_free(c->info2);
-	mem_free(c->feat);
-	mem_free(c->cost);
-	mem_free(c->when);
-	mem_free(c->m_idx);
-	mem_free(c->o_idx);
+	cave_view_reset(c);
+	cave_free_grids(c);
 	mem_free(c->monsters);
+	bitboard_free(c->mon_ready);
 	mem_free(c);
 }
 
@@ -3630,8 +5066,8 @@ void cave_free(struct cave *c) {
  * FEATURE PREDICATES
  *
  * These functions are used to figure out what kind of square something is,
- * via c->feat[y][x]. All direct testing of c->feat[y][x] should be rewritten
- * in terms of these functions.
+ * via cave_feat(c, y, x). All direct testing of cave_feat(c, y, x) should be
+ * rewritten in terms of these functions.
  *
  * It's often better to use feature behavior predicates (written in terms of
  * these functions) instead of these functions directly. For instance,
@@ -3645,7 +5081,7 @@ void cave_free(struct cave *c) {
  * True if the square is normal open floor.
  */
 bool cave_isfloor(struct cave *c, int y, int x) {
-	return c->feat[y][x] == FEAT_FLOOR;
+	return cave_feat(c, y, x) == FEAT_FLOOR;
 }
 
 /**
@@ -3655,7 +5091,7 @@ bool cave_isfloor(struct cave *c, int y, int x) {
  * of cave generation (and should be avoided).
  */
 bool cave_isrock(struct cave *c, int y, int x) {
-	switch (c->feat[y][x]) {
+	switch (cave_feat(c, y, x)) {
 		case FEAT_WALL_EXTRA:
 		case FEAT_WALL_INNER:
 		case FEAT_WALL_OUTER:
@@ -3671,7 +5107,7 @@ bool cave_isrock(struct cave *c, int y, int x) {
  * of cave generation (and should be avoided).
  */
 bool cave_isperm(struct cave *c, int y, int x) {
-	switch (c->feat[y][x]) {
+	switch (cave_feat(c, y, x)) {
 		case FEAT_PERM_EXTRA:
 		case FEAT_PERM_INNER:
 		case FEAT_PERM_OUTER:
@@ -3684,7 +5120,7 @@ bool cave_isperm(struct cave *c, int y, int x) {
  * True if the square is a magma wall.
  */
 bool cave_ismagma(struct cave *c, int y, int x) {
-	switch (c->feat[y][x]) {
+	switch (cave_feat(c, y, x)) {
 		case FEAT_MAGMA:
 		case FEAT_MAGMA_H:
 		case FEAT_MAGMA_K: return TRUE;
@@ -3696,7 +5132,7 @@ bool cave_ismagma(struct cave *c, int y, int x) {
  * True if the square is a quartz wall.
  */
 bool cave_isquartz(struct cave *c, int y, int x) {
-	switch (c->feat[y][x]) {
+	switch (cave_feat(c, y, x)) {
 		case FEAT_QUARTZ:
 		case FEAT_QUARTZ_H:
 		case FEAT_QUARTZ_K: return TRUE;
@@ -3715,7 +5151,7 @@ bool cave_ismineral(struct cave *c, int y, int x) {
  * True if the square is rubble.
  */
 bool cave_isrubble(struct cave *c, int y, int x) {
-	return c->feat[y][x] == FEAT_RUBBLE;
+	return cave_feat(c, y, x) == FEAT_RUBBLE;
 }
 
 /**
@@ -3725,21 +5161,21 @@ bool cave_isrubble(struct cave *c, int y, int x) {
  * is replaced by a closed door.
  */
 bool cave_issecretdoor(struct cave *c, int y, int x) {
-    return c->feat[y][x] == FEAT_SECRET;
+    return cave_feat(c, y, x) == FEAT_SECRET;
 }
 
 /**
  * True if the square is an open door.
  */
 bool cave_isopendoor(struct cave *c, int y, int x) {
-    return c->feat[y][x] == FEAT_OPEN;
+    return cave_feat(c, y, x) == FEAT_OPEN;
 }
 
 /**
  * True if the square is a closed door (possibly locked or jammed).
  */
 bool cave_iscloseddoor(struct cave *c, int y, int x) {
-	int feat = c->feat[y][x];
+	int feat = cave_feat(c, y, x);
 	return feat >= FEAT_DOOR_HEAD && feat <= FEAT_DOOR_TAIL;
 }
 
@@ -3747,7 +5183,7 @@ bool cave_iscloseddoor(struct cave *c, int y, int x) {
  * True if the square is a closed, locked door.
  */
 bool cave_islockeddoor(struct cave *c, int y, int x) {
-	int feat = c->feat[y][x];
+	int feat = cave_feat(c, y, x);
 	return feat >= FEAT_DOOR_HEAD + 0x01 && feat <= FEAT_DOOR_TAIL;
 }
 
@@ -3755,7 +5191,7 @@ bool cave_islockeddoor(struct cave *c, int y, int x) {
  * True if the square is a closed, jammed door.
  */
 bool cave_isjammeddoor(struct cave *c, int y, int x) {
-	int feat = c->feat[y][x];
+	int feat = cave_feat(c, y, x);
 	return feat >= FEAT_DOOR_HEAD + 0x08 && feat <= FEAT_DOOR_TAIL;
 }
 
@@ -3774,14 +5210,14 @@ bool cave_isdoor(struct cave *c, int y, int x) {
  * True if the square is an unknown trap (it will appear as a floor tile).
  */
 bool cave_issecrettrap(struct cave *c, int y, int x) {
-    return c->feat[y][x] == FEAT_INVIS;
+    return cave_feat(c, y, x) == FEAT_INVIS;
 }
 
 /**
  * True if the square is a known trap.
  */
 bool cave_isknowntrap(struct cave *c, int y, int x) {
-	int feat = c->feat[y][x];
+	int feat = cave_feat(c, y, x);
 	return feat >= FEAT_TRAP_HEAD && feat <= FEAT_TRAP_TAIL;
 }
 
@@ -3808,21 +5244,21 @@ bool cave_istrap(struct cave *c, int y, int x) {
  * True if the square is open (a floor square not occupied by a monster).
  */
 bool cave_isopen(struct cave *c, int y, int x) {
-	return cave_isfloor(c, y, x) && !c->m_idx[y][x];
+	return cave_isfloor(c, y, x) && !cave_m_idx(c, y, x);
 }
 
 /**
  * True if the square is empty (an open square without any items).
  */
 bool cave_isempty(struct cave *c, int y, int x) {
-	return cave_isopen(c, y, x) && !c->o_idx[y][x];
+	return cave_isopen(c, y, x) && !cave_o_idx(c, y, x);
 }
 
 /**
  * True if the square is a floor square without items.
  */
 bool cave_canputitem(struct cave *c, int y, int x) {
-	return cave_isfloor(c, y, x) && !c->o_idx[y][x];
+	return cave_isfloor(c, y, x) && !cave_o_idx(c, y, x);
 }
 
 /**
@@ -3840,7 +5276,7 @@ bool cave_isdiggable(struct cave *c, int y, int x) {
  * This function is the logical negation of cave_iswall().
  */
 bool cave_ispassable(struct cave *c, int y, int x) {
-	return !(c->info[y][x] & CAVE_WALL);
+	return !(cave_info(c, y, x) & CAVE_WALL);
 }
 
 /**
@@ -3849,7 +5285,7 @@ bool cave_ispassable(struct cave *c, int y, int x) {
  * This function is the logical negation of cave_ispassable().
  */
 bool cave_iswall(struct cave *c, int y, int x) {
-	return c->info[y][x] & CAVE_WALL;
+	return cave_info(c, y, x) & CAVE_WALL;
 }
 
 /**
@@ -3868,14 +5304,14 @@ bool cave_isstrongwall(struct cave *c, int y, int x) {
  * This doesn't say what kind of square it is, just that it is part of a vault.
  */
 bool cave_isvault(struct cave *c, int y, int x) {
-	return c->info[y][x] & CAVE_ICKY;
+	return cave_info(c, y, x) & CAVE_ICKY;
 }
 
 /**
  * True if the square is part of a room.
  */
 bool cave_isroom(struct cave *c, int y, int x) {
-	return c->info[y][x] & CAVE_ROOM;
+	return cave_info(c, y, x) & CAVE_ROOM;
 
 }
 
@@ -3883,7 +5319,7 @@ bool cave_isroom(struct cave *c, int y, int x) {
  * True if cave square is a feeling trigger square 
  */
 bool cave_isfeel(struct cave *c, int y, int x){
-	return c->info2[y][x] & CAVE2_FEEL;
+	return cave_info2(c, y, x) & CAVE2_FEEL;
 }
 
 /**
@@ -3897,7 +5333,7 @@ struct monster *cave_monster(struct cave *c, int idx) {
  * Get a monster on the current level by its position.
  */
 struct monster *cave_monster_at(struct cave *c, int y, int x) {
-	return cave_monster(cave, cave->m_idx[y][x]);
+	return cave_monster(cave, cave_m_idx(cave, y, x));
 }
 
 /**
@@ -3914,11 +5350,28 @@ int cave_monster_count(struct cave *c) {
 	return c->mon_cnt;
 }
 
+/**
+ * Note whether a monster may have the energy to act. Every monster with 100
+ * or more energy must be marked; marks on others are harmless, and are
+ * cleared by process_monsters() as it finds them.
+ */
+void cave_monster_set_ready(struct cave *c, int idx, bool ready) {
+	bitboard_put(c->mon_ready, 0, idx, ready);
+}
+
+/**
+ * The highest monster index at most idx marked by cave_monster_set_ready(),
+ * or 0 if there is none.
+ */
+int cave_monster_prev_ready(struct cave *c, int idx) {
+	return MAX(bitboard_prev(c->mon_ready, 0, idx), 0);
+}
+
 /**
  * Add visible treasure to a mineral square.
  */
 void upgrade_mineral(struct cave *c, int y, int x) {
-	switch (c->feat[y][x]) {
+	switch (cave_feat(c, y, x)) {
 		case FEAT_MAGMA: cave_set_feat(c, y, x, FEAT_MAGMA_K); break;
 		case FEAT_QUARTZ: cave_set_feat(c, y, x, FEAT_QUARTZ_K); break;
 	}
@@ -3,15 +3,37 @@
 #ifndef CAVE_H
 #define CAVE_H
 
+#include "config.h"
 #include "defines.h"
 #include "types.h"
 #include "z-type.h"
 
+struct cave;
 struct player;
 struct monster;
+struct bitboard;
+
+/*
+ * The furthest offset each way which los() answers from its table
+ */
+#define LOS_RADIUS	MAX_SIGHT
+
+/*
+ * A source grid for testing line of sight to many other grids, with the
+ * rows of walls around it which have been read so far
+ */
+struct los_source {
+	int y, x;
+	u64b known;
+	u64b rows[2 * LOS_RADIUS + 1];
+};
 
 extern int distance(int y1, int x1, int y2, int x2);
+extern bool los_walk(struct cave *c, int y1, int x1, int y2, int x2);
+extern errr los_init(void);
 extern bool los(int y1, int x1, int y2, int x2);
+extern void los_source_init(struct los_source *s, int y, int x);
+extern bool los_from(struct los_source *s, int y, int x);
 extern bool no_light(void);
 extern bool cave_valid_bold(int y, int x);
 extern byte get_color(byte a, int attr, int n);
@@ -24,9 +46,14 @@ extern void do_cmd_view_map(void);
 extern errr vinfo_init(void);
 extern void forget_view(void);
 extern void update_view(void);
+extern int view_added(const u16b **gp);
+extern int view_removed(const u16b **gp);
 extern void map_area(void);
 extern void wiz_light(void);
 extern void wiz_dark(void);
+extern int project_path_walk(struct cave *c, u16b *gp, int range, int y1,
+	int x1, int y2, int x2, int flg);
+extern errr project_path_init(void);
 extern int project_path(u16b *gp, int range, int y1, int x1, int y2, int x2, int flg);
 extern bool projectable(int y1, int x1, int y2, int x2, int flg);
 extern void scatter(int *yp, int *xp, int y, int x, int d, int m);
@@ -39,8 +66,23 @@ extern void disturb(struct player *p, int stop_search, int unused_flag);
 extern bool is_quest(int level);
 extern bool dtrap_edge(int y, int x);
 
+/**
+ * The fields of a grid that most code looks at, kept together so that
+ * looking at several of them touches one cache line rather than one per
+ * field. The flow fields are only used by the flow code, and stay in arrays
+ * of their own.
+ */
+struct square {
+	s16b m_idx;	/* Monster in the grid */
+	s16b o_idx;	/* First object in the grid */
+	byte feat;	/* Terrain feature */
+	byte info;	/* CAVE_* flags */
+	byte info2;	/* CAVE2_* flags */
+};
+
 struct cave {
 	s32b created_at;
+	u64b seed; /* The seed the level was generated from */
 	int depth;
 
 	byte feeling;
@@ -53,30 +95,130 @@ struct cave {
 	
 	u16b feeling_squares; /* Keep track of how many feeling squares the player has visited */
 
-	byte (*info)[256];
-	byte (*info2)[256];
-	byte (*feat)[DUNGEON_WID];
-	byte (*cost)[DUNGEON_WID];
-	byte (*when)[DUNGEON_WID];
-	s16b (*m_idx)[DUNGEON_WID];
-	s16b (*o_idx)[DUNGEON_WID];
+	/* Grid (y, x) is entry y * width + x of each of these */
+#ifdef CAVE_PACKED_GRIDS
+	struct square *squares;
+#else
+	byte *info;
+	byte *info2;
+	byte *feat;
+	s16b *m_idx;
+	s16b *o_idx;
+#endif
+	byte *cost;
+	byte *when;
+	u16b *noise;	/* Turn by which the noise heard here dies away */
+	u16b *scent;	/* Turn the player last stood here */
+	u16b sense_turn;	/* Player turns, for noise and scent */
+
+	/* One bitboard per CAVE_* flag, kept in step with info */
+	struct bitboard *planes[8];
+
+	/* The grids holding a monster, those holding floor objects, and the
+	 * empty floor grids (see cave_isempty()) */
+	struct bitboard *monster_grids;
+	struct bitboard *object_grids;
+	struct bitboard *empty_grids;
 
 	struct monster *monsters;
 	int mon_max;
 	int mon_cnt;
+	struct bitboard *mon_ready; /* Monsters which may have the energy to act */
+};
+
+/*
+ * Access to the fields of grid (y, x) of cave c, as lvalues. Everything
+ * outside cave_resize() and cave_free() goes through these, so that the
+ * layout can be switched with CAVE_PACKED_GRIDS.
+ *
+ * cave_info(), cave_m_idx() and cave_o_idx() are the exceptions: they can
+ * only be read. The CAVE_* flags are changed with cave_info_on() and friends
+ * so that c->planes follow, and the monster and object indices with
+ * cave_set_m_idx() and cave_set_o_idx() so that c->monster_grids,
+ * c->object_grids and c->empty_grids do. The feature is still an lvalue,
+ * but should be changed with cave_set_feat() for the same reason.
+ */
+#define cave_grid(C, Y, X)	((Y) * (C)->width + (X))
+#ifdef CAVE_PACKED_GRIDS
+#define cave_info_byte(C, Y, X)	((C)->squares[cave_grid(C, Y, X)].info)
+#define cave_info2(C, Y, X)	((C)->squares[cave_grid(C, Y, X)].info2)
+#define cave_feat(C, Y, X)	((C)->squares[cave_grid(C, Y, X)].feat)
+#define cave_m_idx_raw(C, Y, X)	((C)->squares[cave_grid(C, Y, X)].m_idx)
+#define cave_o_idx_raw(C, Y, X)	((C)->squares[cave_grid(C, Y, X)].o_idx)
+#else
+#define cave_info_byte(C, Y, X)	((C)->info[cave_grid(C, Y, X)])
+#define cave_info2(C, Y, X)	((C)->info2[cave_grid(C, Y, X)])
+#define cave_feat(C, Y, X)	((C)->feat[cave_grid(C, Y, X)])
+#define cave_m_idx_raw(C, Y, X)	((C)->m_idx[cave_grid(C, Y, X)])
+#define cave_o_idx_raw(C, Y, X)	((C)->o_idx[cave_grid(C, Y, X)])
+#endif
+#define cave_info(C, Y, X)	((byte)cave_info_byte(C, Y, X))
+#define cave_m_idx(C, Y, X)	((s16b)cave_m_idx_raw(C, Y, X))
+#define cave_o_idx(C, Y, X)	((s16b)cave_o_idx_raw(C, Y, X))
+#define cave_cost(C, Y, X)	((C)->cost[cave_grid(C, Y, X)])
+#define cave_when(C, Y, X)	((C)->when[cave_grid(C, Y, X)])
+
+/**
+ * A walk over the grids of a rectangle which hold monsters, or floor objects,
+ * started with cave_iter_monsters() or cave_iter_objects() and perhaps
+ * narrowed with cave_iter_near(). The grids come in row order.
+ *
+ * The grids still to come are read as the walk goes on, so monsters and
+ * objects may come and go during it; but a monster that moves on ahead of
+ * the walk may be visited twice.
+ */
+struct cave_iter {
+	const struct bitboard *b;
+	int y1, x1, y2, x2;	/* the rectangle */
+	int cy, cx, r;		/* the circle, if r is not negative */
+	bool los;			/* only grids in line of sight of the centre */
+	struct los_source from;
+	int y, i;			/* the row and word being walked */
+	u64b w;				/* the grids of that word still to visit */
 };
 
 /* XXX: temporary while I refactor */
 extern struct cave *cave;
 
 extern struct cave *cave_new(void);
+extern void cave_resize(struct cave *c, int height, int width);
 extern void cave_free(struct cave *c);
+extern void cave_view_reset(struct cave *c);
+
+extern void cave_info_set(struct cave *c, int y, int x, byte info);
+extern void cave_info_on(struct cave *c, int y, int x, byte flags);
+extern void cave_info_off(struct cave *c, int y, int x, byte flags);
+extern void cave_info_fill(struct cave *c, int y1, int x1, int y2, int x2,
+	byte flags, bool on);
+extern void cave_info_mask(struct cave *c, const struct bitboard *b,
+	byte flags, bool on);
+extern int cave_info_count(struct cave *c, int y1, int x1, int y2, int x2,
+	byte flag);
+extern bool cave_info_any(struct cave *c, int y1, int x1, int y2, int x2,
+	byte flag);
+
+extern void cave_set_m_idx(struct cave *c, int y, int x, int m_idx);
+extern void cave_set_o_idx(struct cave *c, int y, int x, int o_idx);
+extern void cave_iter_monsters(struct cave_iter *it, struct cave *c,
+	int y1, int x1, int y2, int x2);
+extern void cave_iter_objects(struct cave_iter *it, struct cave *c,
+	int y1, int x1, int y2, int x2);
+extern void cave_iter_near(struct cave_iter *it, int y, int x, int r,
+	bool los);
+extern bool cave_iter_next(struct cave_iter *it, int *y, int *x);
 
 extern void cave_set_feat(struct cave *c, int y, int x, int feat);
 extern void cave_note_spot(struct cave *c, int y, int x);
 extern void cave_light_spot(struct cave *c, int y, int x);
 extern void cave_update_flow(struct cave *c);
 extern void cave_forget_flow(struct cave *c);
+extern bool cave_flow_add_source(struct cave *c, int y, int x, int cost);
+extern void cave_flow_clear_sources(struct cave *c);
+extern void cave_senses_tick(struct cave *c);
+extern void cave_leave_scent(struct cave *c, int y, int x);
+extern int cave_scent_age(struct cave *c, int y, int x);
+extern void cave_make_noise(struct cave *c, int y, int x, int loudness);
+extern int cave_noise(struct cave *c, int y, int x);
 extern void cave_illuminate(struct cave *c, bool daytime);
 
 /**
@@ -116,6 +258,10 @@ extern bool cave_isrubble(struct cave *c, int y, int x);
 extern bool cave_isfeel(struct cave *c, int y, int x);
 
 extern void cave_generate(struct cave *c, struct player *p);
+extern void cave_generate_from_seed(struct cave *c, struct player *p,
+	u64b seed);
+extern void cave_pregenerate(struct player *p);
+extern void cave_pregen_free(void);
 
 extern bool cave_in_bounds(struct cave *c, int y, int x);
 extern bool cave_in_bounds_fully(struct cave *c, int y, int x);
@@ -124,6 +270,8 @@ extern struct monster *cave_monster(struct cave *c, int idx);
 extern struct monster *cave_monster_at(struct cave *c, int y, int x);
 extern int cave_monster_max(struct cave *c);
 extern int cave_monster_count(struct cave *c);
+extern void cave_monster_set_ready(struct cave *c, int idx, bool ready);
+extern int cave_monster_prev_ready(struct cave *c, int idx);
 
 void upgrade_mineral(struct cave *c, int y, int x);
 
@@ -160,10 +160,10 @@ int context_menu_player(int mx, int my)
 		menu_dynamic_add_label(m, "Cast", 'm', 2, labels);
 	}
 	/* if player is on stairs add option to use them */
-	if (cave->feat[p_ptr->py][p_ptr->px] == FEAT_LESS) {
+	if (cave_feat(cave, p_ptr->py, p_ptr->px) == FEAT_LESS) {
 		menu_dynamic_add_label(m, "Go Up", '<', 11, labels);
 	} else
-	if (cave->feat[p_ptr->py][p_ptr->px] == FEAT_MORE) {
+	if (cave_feat(cave, p_ptr->py, p_ptr->px) == FEAT_MORE) {
 		menu_dynamic_add_label(m, "Go Down", '>', 12, labels);
 	}
 	menu_dynamic_add_label(m, "Search", 's', 3, labels);
@@ -171,8 +171,8 @@ int context_menu_player(int mx, int my)
 	menu_dynamic_add_label(m, "Rest", 'R', 4, labels);
 	menu_dynamic_add_label(m, "Inventory", 'i', 5, labels);
 	/* if object under player add pickup option */
-	if (cave->o_idx[p_ptr->py][p_ptr->px]) {
-		object_type *o_ptr = object_byid(cave->o_idx[p_ptr->py][p_ptr->px]);
+	if (cave_o_idx(cave, p_ptr->py, p_ptr->px)) {
+		object_type *o_ptr = object_byid(cave_o_idx(cave, p_ptr->py, p_ptr->px));
 		if (!squelch_item_ok(o_ptr)) {
   			menu_dynamic_add_label(m, "Floor", 'i', 13, labels);
 			if (inven_carry_okay(o_ptr)) {
@@ -358,7 +358,7 @@ int context_menu_cave(struct cave *cave, int y, int x, int adjacent, int mx, int
 	m->selections = labels;
 
 	menu_dynamic_add_label(m, "Look At", 'l', 1, labels);
-	if (cave->m_idx[y][x]) {
+	if (cave_m_idx(cave, y, x)) {
 		menu_dynamic_add_label(m, "Recall Info", '/', 18, labels);
 	}
 	menu_dynamic_add_label(m, "Use Item On", 'U', 2, labels);
@@ -366,12 +366,12 @@ int context_menu_cave(struct cave *cave, int y, int x, int adjacent, int mx, int
 		menu_dynamic_add_label(m, "Cast On", 'm', 3, labels);
 	}
 	if (adjacent) {
-		if (cave->m_idx[y][x]) {
+		if (cave_m_idx(cave, y, x)) {
 			menu_dynamic_add_label(m, "Attack", '+', 4, labels);
 		} else {
 			menu_dynamic_add_label(m, "Alter", '+', 4, labels);
 		}
-		if (cave->o_idx[y][x]) {
+		if (cave_o_idx(cave, y, x)) {
 			s16b o_idx = chest_check(y,x);
 			if (o_idx) {
 				object_type *o_ptr = object_byid(o_idx);
@@ -443,7 +443,7 @@ int context_menu_cave(struct cave *cave, int y, int x, int adjacent, int mx, int
 	if (p_ptr->timed[TMD_IMAGE]) {
 		prt("(Enter to select command, ESC to cancel) You see something strange:", 0, 0);
 	} else
-	if (cave->m_idx[y][x]) {
+	if (cave_m_idx(cave, y, x)) {
 		char m_name[80];
 		monster_type *m_ptr = cave_monster_at(cave, y, x);
 
@@ -452,11 +452,11 @@ int context_menu_cave(struct cave *cave, int y, int x, int adjacent, int mx, int
 
 		prt(format("(Enter to select command, ESC to cancel) You see %s:", m_name), 0, 0);
 	} else
-	if (cave->o_idx[y][x] && !squelch_item_ok(object_byid(cave->o_idx[y][x]))) {
+	if (cave_o_idx(cave, y, x) && !squelch_item_ok(object_byid(cave_o_idx(cave, y, x)))) {
 		char o_name[80];
 
 		/* Get the single object in the list */
-		object_type *o_ptr = object_byid(cave->o_idx[y][x]);
+		object_type *o_ptr = object_byid(cave_o_idx(cave, y, x));
 
 		/* Obtain an object description */
 		object_desc(o_name, sizeof (o_name), o_ptr, ODESC_ARTICLE | ODESC_FULL);
@@ -466,10 +466,10 @@ int context_menu_cave(struct cave *cave, int y, int x, int adjacent, int mx, int
 	{
 		/* Feature (apply mimic) */
 		const char *name;
-		int feat = f_info[cave->feat[y][x]].mimic;
+		int feat = f_info[cave_feat(cave, y, x)].mimic;
 
 		/* Require knowledge about grid, or ability to see grid */
-		if (!(cave->info[y][x] & (CAVE_MARK)) && !player_can_see_bold(y,x)) {
+		if (!(cave_info(cave, y, x) & (CAVE_MARK)) && !player_can_see_bold(y,x)) {
 			/* Forget feature */
 			feat = FEAT_NONE;
 		}
@@ -728,10 +728,10 @@ void do_cmd_use(cmd_code code, cmd_arg args[])
 	}
 	
 	/* Hack to make Glyph of Warding work properly */
-	if (cave->feat[py][px] == FEAT_GLYPH)
+	if (cave_feat(cave, py, px) == FEAT_GLYPH)
 	{
 		/* Push objects off the grid */
-		if (cave->o_idx[py][px]) push_object(py, px);
+		if (cave_o_idx(cave, py, px)) push_object(py, px);
 	}
 
 
@@ -680,9 +680,9 @@ static void textui_process_click(ui_event e)
       		/* switch with default */
       		if (e.mouse.button == 1) {
 			  	/* cmd_insert(CMD_ACTIVATE); */
-        		if (cave->feat[p_ptr->py][p_ptr->px] == FEAT_LESS)
+        		if (cave_feat(cave, p_ptr->py, p_ptr->px) == FEAT_LESS)
   			  		cmd_insert(CMD_GO_UP);
-        		else if (cave->feat[p_ptr->py][p_ptr->px] == FEAT_MORE)
+        		else if (cave_feat(cave, p_ptr->py, p_ptr->px) == FEAT_MORE)
   			  		cmd_insert(CMD_GO_DOWN);
       		} else if (e.mouse.button == 2)
 			  	cmd_insert(CMD_USE_UNAIMED);
@@ -697,7 +697,7 @@ static void textui_process_click(ui_event e)
 			  	/* cmd_insert(CMD_CHAR_SCREEN); */
     	} else {
       		if (e.mouse.button == 1) {
-        		if (cave->o_idx[y][x])
+        		if (cave_o_idx(cave, y, x))
 	  				cmd_insert(CMD_PICKUP);
         		else
   			  		cmd_insert(CMD_HOLD);
@@ -743,7 +743,7 @@ static void textui_process_click(ui_event e)
 	}
 
 	else if (e.mouse.button == 2) {
-    	int m_idx = cave->m_idx[y][x];
+    	int m_idx = cave_m_idx(cave, y, x);
     	if (m_idx && target_able(m_idx)) {
 			monster_type *m_ptr = cave_monster(cave, m_idx);
 			/* Set up target information */
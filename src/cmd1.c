@@ -80,7 +80,7 @@ bool search(bool verbose)
 			if (randint0(100) < chance)
 			{
 				/* Invisible trap */
-				if (cave->feat[y][x] == FEAT_INVIS)
+				if (cave_feat(cave, y, x) == FEAT_INVIS)
 				{
 					found = TRUE;
 
@@ -95,7 +95,7 @@ bool search(bool verbose)
 				}
 
 				/* Secret door */
-				if (cave->feat[y][x] == FEAT_SECRET)
+				if (cave_feat(cave, y, x) == FEAT_SECRET)
 				{
 					found = TRUE;
 
@@ -178,7 +178,7 @@ static void py_pickup_gold(void)
 
 
 	/* Pick up all the ordinary gold objects */
-	for (this_o_idx = cave->o_idx[py][px]; this_o_idx; this_o_idx = next_o_idx)
+	for (this_o_idx = cave_o_idx(cave, py, px); this_o_idx; this_o_idx = next_o_idx)
 	{
 		/* Get the object */
 		o_ptr = object_byid(this_o_idx);
@@ -376,14 +376,14 @@ int do_autopickup(void)
 	int floor_list[MAX_FLOOR_STACK + 1];
 
 	/* Nothing to pick up -- return */
-	if (!cave->o_idx[py][px]) return (0);
+	if (!cave_o_idx(cave, py, px)) return (0);
 
 	/* Always pickup gold, effortlessly */
 	py_pickup_gold();
 
 
 	/* Scan the remaining objects */
-	for (this_o_idx = cave->o_idx[py][px]; this_o_idx; this_o_idx = next_o_idx)
+	for (this_o_idx = cave_o_idx(cave, py, px); this_o_idx; this_o_idx = next_o_idx)
 	{
 		/* Get the object and the next object */
 		o_ptr = object_byid(this_o_idx);
@@ -483,7 +483,7 @@ byte py_pickup(int pickup)
 	py_pickup_gold();
 
 	/* Nothing else to pick up -- return */
-	if (!cave->o_idx[py][px]) return objs_picked_up;
+	if (!cave_o_idx(cave, py, px)) return objs_picked_up;
 
 	/* Tally objects that can be picked up.*/
 	floor_num = scan_floor(floor_list, N_ELEMENTS(floor_list), py, px, 0x03);
@@ -568,7 +568,7 @@ void move_player(int dir, bool disarm)
 	int y = py + ddy[dir];
 	int x = px + ddx[dir];
 
-	int m_idx = cave->m_idx[y][x];
+	int m_idx = cave_m_idx(cave, y, x);
 	struct monster *m_ptr = cave_monster(cave, m_idx);
 
 	/* Attack monsters */
@@ -586,7 +586,7 @@ void move_player(int dir, bool disarm)
 	}
 
 	/* Optionally alter traps/doors on movement */
-	else if (disarm && (cave->info[y][x] & CAVE_MARK) &&
+	else if (disarm && (cave_info(cave, y, x) & CAVE_MARK) &&
 			(cave_isknowntrap(cave, y, x) ||
 			cave_iscloseddoor(cave, y, x)))
 	{
@@ -604,21 +604,21 @@ void move_player(int dir, bool disarm)
 		disturb(p_ptr, 0, 0);
 
 		/* Notice unknown obstacles */
-		if (!(cave->info[y][x] & CAVE_MARK))
+		if (!(cave_info(cave, y, x) & CAVE_MARK))
 		{
 			/* Rubble */
-			if (cave->feat[y][x] == FEAT_RUBBLE)
+			if (cave_feat(cave, y, x) == FEAT_RUBBLE)
 			{
 				msgt(MSG_HITWALL, "You feel a pile of rubble blocking your way.");
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 				cave_light_spot(cave, y, x);
 			}
 
 			/* Closed door */
-			else if (cave->feat[y][x] < FEAT_SECRET)
+			else if (cave_feat(cave, y, x) < FEAT_SECRET)
 			{
 				msgt(MSG_HITWALL, "You feel a door blocking your way.");
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 				cave_light_spot(cave, y, x);
 			}
 
@@ -626,7 +626,7 @@ void move_player(int dir, bool disarm)
 			else
 			{
 				msgt(MSG_HITWALL, "You feel a wall blocking your way.");
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 				cave_light_spot(cave, y, x);
 			}
 		}
@@ -634,9 +634,9 @@ void move_player(int dir, bool disarm)
 		/* Mention known obstacles */
 		else
 		{
-			if (cave->feat[y][x] == FEAT_RUBBLE)
+			if (cave_feat(cave, y, x) == FEAT_RUBBLE)
 				msgt(MSG_HITWALL, "There is a pile of rubble blocking your way.");
-			else if (cave->feat[y][x] < FEAT_SECRET)
+			else if (cave_feat(cave, y, x) < FEAT_SECRET)
 				msgt(MSG_HITWALL, "There is a door blocking your way.");
 			else
 				msgt(MSG_HITWALL, "There is a wall blocking your way.");
@@ -647,8 +647,8 @@ void move_player(int dir, bool disarm)
 	else
 	{
 		/* See if trap detection status will change */
-		bool old_dtrap = ((cave->info2[py][px] & (CAVE2_DTRAP)) != 0);
-		bool new_dtrap = ((cave->info2[y][x] & (CAVE2_DTRAP)) != 0);
+		bool old_dtrap = ((cave_info2(cave, py, px) & (CAVE2_DTRAP)) != 0);
+		bool new_dtrap = ((cave_info2(cave, y, x) & (CAVE2_DTRAP)) != 0);
 
 		/* Note the change in the detect status */
 		if (old_dtrap != new_dtrap)
@@ -676,8 +676,8 @@ void move_player(int dir, bool disarm)
 			search(FALSE);
 
 		/* Handle "store doors" */
-		if ((cave->feat[p_ptr->py][p_ptr->px] >= FEAT_SHOP_HEAD) &&
-			(cave->feat[p_ptr->py][p_ptr->px] <= FEAT_SHOP_TAIL))
+		if ((cave_feat(cave, p_ptr->py, p_ptr->px) >= FEAT_SHOP_HEAD) &&
+			(cave_feat(cave, p_ptr->py, p_ptr->px) <= FEAT_SHOP_TAIL))
 		{
 			/* Disturb */
 			disturb(p_ptr, 0, 0);
@@ -693,7 +693,7 @@ void move_player(int dir, bool disarm)
 
 
 		/* Discover invisible traps */
-		if (cave->feat[y][x] == FEAT_INVIS)
+		if (cave_feat(cave, y, x) == FEAT_INVIS)
 		{
 			/* Disturb */
 			disturb(p_ptr, 0, 0);
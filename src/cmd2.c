@@ -38,7 +38,7 @@
 void do_cmd_go_up(cmd_code code, cmd_arg args[])
 {
 	/* Verify stairs */
-	if (cave->feat[p_ptr->py][p_ptr->px] != FEAT_LESS)
+	if (cave_feat(cave, p_ptr->py, p_ptr->px) != FEAT_LESS)
 	{
 		msg("I see no up staircase here.");
 		return;
@@ -72,7 +72,7 @@ void do_cmd_go_up(cmd_code code, cmd_arg args[])
 void do_cmd_go_down(cmd_code code, cmd_arg args[])
 {
 	/* Verify stairs */
-	if (cave->feat[p_ptr->py][p_ptr->px] != FEAT_MORE)
+	if (cave_feat(cave, p_ptr->py, p_ptr->px) != FEAT_MORE)
 	{
 		msg("I see no down staircase here.");
 		return;
@@ -148,7 +148,7 @@ s16b chest_check(int y, int x)
 
 
 	/* Scan all objects in the grid */
-	for (this_o_idx = cave->o_idx[y][x]; this_o_idx; this_o_idx = next_o_idx)
+	for (this_o_idx = cave_o_idx(cave, y, x); this_o_idx; this_o_idx = next_o_idx)
 	{
 		object_type *o_ptr;
 
@@ -490,7 +490,7 @@ int count_feats(int *y, int *x, bool (*test)(struct cave *cave, int y, int x), b
 		if (!in_bounds_fully(yy, xx)) continue;
 
 		/* Must have knowledge */
-		if (!(cave->info[yy][xx] & (CAVE_MARK))) continue;
+		if (!(cave_info(cave, yy, xx) & (CAVE_MARK))) continue;
 
 		/* Not looking for this feature */
 		if (!((*test)(cave, yy, xx))) continue;
@@ -575,7 +575,7 @@ int coords_to_dir(int y, int x)
 static bool do_cmd_open_test(int y, int x)
 {
 	/* Must have knowledge */
-	if (!(cave->info[y][x] & (CAVE_MARK))) {
+	if (!(cave_info(cave, y, x) & (CAVE_MARK))) {
 		msg("You see nothing there.");
 		return FALSE;
 	}
@@ -625,7 +625,7 @@ static bool do_cmd_open_aux(int y, int x)
 		if (p_ptr->timed[TMD_CONFUSED] || p_ptr->timed[TMD_IMAGE]) i = i / 10;
 
 		/* Extract the lock power */
-		j = cave->feat[y][x] - FEAT_DOOR_HEAD;
+		j = cave_feat(cave, y, x) - FEAT_DOOR_HEAD;
 
 		/* Extract the difficulty XXX XXX XXX */
 		j = i - (j * 4);
@@ -643,7 +643,7 @@ static bool do_cmd_open_aux(int y, int x)
 			cave_set_feat(cave, y, x, FEAT_OPEN);
 
 			/* Update the visuals */
-			p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+			p_ptr->update |= (PU_UPDATE_VIEW);
 
 			/* Experience */
 			/* Removed to avoid exploit by repeatedly locking and unlocking door */
@@ -670,7 +670,7 @@ static bool do_cmd_open_aux(int y, int x)
 		cave_set_feat(cave, y, x, FEAT_OPEN);
 
 		/* Update the visuals */
-		p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+		p_ptr->update |= (PU_UPDATE_VIEW);
 
 		/* Sound */
 		sound(MSG_OPENDOOR);
@@ -729,9 +729,9 @@ void do_cmd_open(cmd_code code, cmd_arg args[])
 
 
 	/* Monster */
-	if (cave->m_idx[y][x] > 0)
+	if (cave_m_idx(cave, y, x) > 0)
 	{
-		int m_idx = cave->m_idx[y][x];
+		int m_idx = cave_m_idx(cave, y, x);
 		struct monster *m_ptr = cave_monster(cave, m_idx);
 
 		/* Mimics surprise the player */
@@ -774,7 +774,7 @@ void do_cmd_open(cmd_code code, cmd_arg args[])
 static bool do_cmd_close_test(int y, int x)
 {
 	/* Must have knowledge */
-	if (!(cave->info[y][x] & (CAVE_MARK)))
+	if (!(cave_info(cave, y, x) & (CAVE_MARK)))
 	{
 		/* Message */
 		msg("You see nothing there.");
@@ -784,8 +784,8 @@ static bool do_cmd_close_test(int y, int x)
 	}
 
  	/* Require open/broken door */
-	if ((cave->feat[y][x] != FEAT_OPEN) &&
-	    (cave->feat[y][x] != FEAT_BROKEN))
+	if ((cave_feat(cave, y, x) != FEAT_OPEN) &&
+	    (cave_feat(cave, y, x) != FEAT_BROKEN))
 	{
 		/* Message */
 		msg("You see nothing there to close.");
@@ -814,7 +814,7 @@ static bool do_cmd_close_aux(int y, int x)
 	if (!do_cmd_close_test(y, x)) return (FALSE);
 
 	/* Broken door */
-	if (cave->feat[y][x] == FEAT_BROKEN)
+	if (cave_feat(cave, y, x) == FEAT_BROKEN)
 	{
 		/* Message */
 		msg("The door appears to be broken.");
@@ -827,7 +827,7 @@ static bool do_cmd_close_aux(int y, int x)
 		cave_set_feat(cave, y, x, FEAT_DOOR_HEAD);
 
 		/* Update the visuals */
-		p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+		p_ptr->update |= (PU_UPDATE_VIEW);
 
 		/* Sound */
 		sound(MSG_SHUTDOOR);
@@ -874,7 +874,7 @@ void do_cmd_close(cmd_code code, cmd_arg args[])
 
 
 	/* Monster */
-	if (cave->m_idx[y][x] > 0)
+	if (cave_m_idx(cave, y, x) > 0)
 	{
 		/* Message */
 		msg("There is a monster in the way!");
@@ -901,7 +901,7 @@ void do_cmd_close(cmd_code code, cmd_arg args[])
 static bool do_cmd_tunnel_test(int y, int x)
 {
 	/* Must have knowledge */
-	if (!(cave->info[y][x] & (CAVE_MARK)))
+	if (!(cave_info(cave, y, x) & (CAVE_MARK)))
 	{
 		/* Message */
 		msg("You see nothing there.");
@@ -944,16 +944,13 @@ static bool twall(int y, int x)
 	sound(MSG_DIG);
 
 	/* Forget the wall */
-	cave->info[y][x] &= ~(CAVE_MARK);
+	cave_info_off(cave, y, x, CAVE_MARK);
 
 	/* Remove the feature */
 	cave_set_feat(cave, y, x, FEAT_FLOOR);
 
 	/* Update the visuals */
-	p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
-
-	/* Fully update the flow */
-	p_ptr->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
+	p_ptr->update |= (PU_UPDATE_VIEW);
 
 	/* Result */
 	return (TRUE);
@@ -981,14 +978,17 @@ static bool do_cmd_tunnel_aux(int y, int x)
 	/* Sound XXX XXX XXX */
 	/* sound(MSG_DIG); */
 
+	/* Digging is noisy */
+	cave_make_noise(cave, p_ptr->py, p_ptr->px, NOISE_DIG);
+
 	/* Titanium */
-	if (cave->feat[y][x] >= FEAT_PERM_EXTRA)
+	if (cave_feat(cave, y, x) >= FEAT_PERM_EXTRA)
 	{
 		msg("This seems to be permanent rock.");
 	}
 
 	/* Granite */
-	else if (cave->feat[y][x] >= FEAT_WALL_EXTRA)
+	else if (cave_feat(cave, y, x) >= FEAT_WALL_EXTRA)
 	{
 		/* Tunnel */
 		if ((p_ptr->state.skills[SKILL_DIGGING] > 40 + randint0(1600)) && twall(y, x))
@@ -1006,20 +1006,20 @@ static bool do_cmd_tunnel_aux(int y, int x)
 	}
 
 	/* Quartz / Magma */
-	else if (cave->feat[y][x] >= FEAT_MAGMA)
+	else if (cave_feat(cave, y, x) >= FEAT_MAGMA)
 	{
 		bool okay = FALSE;
 		bool gold = FALSE;
 		bool hard = FALSE;
 
 		/* Found gold */
-		if (cave->feat[y][x] >= FEAT_MAGMA_H)
+		if (cave_feat(cave, y, x) >= FEAT_MAGMA_H)
 		{
 			gold = TRUE;
 		}
 
 		/* Extract "quartz" flag XXX XXX XXX */
-		if ((cave->feat[y][x] - FEAT_MAGMA) & 0x01)
+		if ((cave_feat(cave, y, x) - FEAT_MAGMA) & 0x01)
 		{
 			hard = TRUE;
 		}
@@ -1075,7 +1075,7 @@ static bool do_cmd_tunnel_aux(int y, int x)
 	}
 
 	/* Rubble */
-	else if (cave->feat[y][x] == FEAT_RUBBLE)
+	else if (cave_feat(cave, y, x) == FEAT_RUBBLE)
 	{
 		/* Remove the rubble */
 		if ((p_ptr->state.skills[SKILL_DIGGING] > randint0(200)) && twall(y, x))
@@ -1090,7 +1090,7 @@ static bool do_cmd_tunnel_aux(int y, int x)
 					ORIGIN_RUBBLE);
 
 				/* Observe the new object */
-				if (!squelch_item_ok(object_byid(cave->o_idx[y][x])) &&
+				if (!squelch_item_ok(object_byid(cave_o_idx(cave, y, x))) &&
 					    player_can_see_bold(y, x))
 					msg("You have found something!");
 			}
@@ -1105,7 +1105,7 @@ static bool do_cmd_tunnel_aux(int y, int x)
 	}
 
 	/* Secret doors */
-	else if (cave->feat[y][x] >= FEAT_SECRET)
+	else if (cave_feat(cave, y, x) >= FEAT_SECRET)
 	{
 		/* Tunnel */
 		if ((p_ptr->state.skills[SKILL_DIGGING] > 30 + randint0(1200)) && twall(y, x))
@@ -1187,7 +1187,7 @@ void do_cmd_tunnel(cmd_code code, cmd_arg args[])
 
 
 	/* Monster */
-	if (cave->m_idx[y][x] > 0)
+	if (cave_m_idx(cave, y, x) > 0)
 	{
 		/* Message */
 		msg("There is a monster in the way!");
@@ -1213,13 +1213,13 @@ void do_cmd_tunnel(cmd_code code, cmd_arg args[])
 static bool do_cmd_disarm_test(int y, int x)
 {
 	/* Must have knowledge */
-	if (!(cave->info[y][x] & (CAVE_MARK))) {
+	if (!(cave_info(cave, y, x) & (CAVE_MARK))) {
 		msg("You see nothing there.");
 		return FALSE;
 	}
 
 	/* Look for a closed, unlocked door to lock */
-	if (cave->feat[y][x] == FEAT_DOOR_HEAD)	return TRUE;
+	if (cave_feat(cave, y, x) == FEAT_DOOR_HEAD)	return TRUE;
 
 	/* Look for a trap */
 	if (!cave_isknowntrap(cave, y, x)) {
@@ -1309,7 +1309,7 @@ static bool do_cmd_disarm_aux(int y, int x)
 
 
 	/* Get the trap name */
-	name = f_info[cave->feat[y][x]].name;
+	name = f_info[cave_feat(cave, y, x)].name;
 
 	/* Get the "disarm" factor */
 	i = p_ptr->state.skills[SKILL_DISARM];
@@ -1339,7 +1339,7 @@ static bool do_cmd_disarm_aux(int y, int x)
 		player_exp_gain(p_ptr, power);
 
 		/* Forget the trap */
-		cave->info[y][x] &= ~(CAVE_MARK);
+		cave_info_off(cave, y, x, CAVE_MARK);
 
 		/* Remove the trap */
 		cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1417,7 +1417,7 @@ void do_cmd_disarm(cmd_code code, cmd_arg args[])
 
 
 	/* Monster */
-	if (cave->m_idx[y][x] > 0) {
+	if (cave_m_idx(cave, y, x) > 0) {
 		msg("There is a monster in the way!");
 		py_attack(y, x);
 	}
@@ -1427,7 +1427,7 @@ void do_cmd_disarm(cmd_code code, cmd_arg args[])
 		more = do_cmd_disarm_chest(y, x, o_idx);
 
 	/* Door to lock */
-	else if (cave->feat[y][x] == FEAT_DOOR_HEAD)
+	else if (cave_feat(cave, y, x) == FEAT_DOOR_HEAD)
 		more = do_cmd_lock_door(y, x);
 
 	/* Disarm trap */
@@ -1445,7 +1445,7 @@ void do_cmd_disarm(cmd_code code, cmd_arg args[])
 static bool do_cmd_bash_test(int y, int x)
 {
 	/* Must have knowledge */
-	if (!(cave->info[y][x] & (CAVE_MARK))) {
+	if (!(cave_info(cave, y, x) & (CAVE_MARK))) {
 		msg("You see nothing there.");
 		return (FALSE);
 	}
@@ -1481,12 +1481,15 @@ static bool do_cmd_bash_aux(int y, int x)
 	/* Message */
 	msg("You smash into the door!");
 
+	/* Bashing is noisy */
+	cave_make_noise(cave, p_ptr->py, p_ptr->px, NOISE_BASH);
+
 	/* Hack -- Bash power based on strength */
 	/* (Ranges from 3 to 20 to 100 to 200) */
 	bash = adj_str_blow[p_ptr->state.stat_ind[A_STR]];
 
 	/* Extract door power */
-	temp = ((cave->feat[y][x] - FEAT_DOOR_HEAD) & 0x07);
+	temp = ((cave_feat(cave, y, x) - FEAT_DOOR_HEAD) & 0x07);
 
 	/* Compare bash power to door power */
 	temp = (bash - (temp * 10));
@@ -1512,7 +1515,7 @@ static bool do_cmd_bash_aux(int y, int x)
 		msgt(MSG_OPENDOOR, "The door crashes open!");
 
 		/* Update the visuals */
-		p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+		p_ptr->update |= (PU_UPDATE_VIEW);
 	}
 
 	/* Saving throw against stun */
@@ -1584,7 +1587,7 @@ void do_cmd_bash(cmd_code code, cmd_arg args[])
 
 
 	/* Monster */
-	if (cave->m_idx[y][x] > 0)
+	if (cave_m_idx(cave, y, x) > 0)
 	{
 		/* Message */
 		msg("There is a monster in the way!");
@@ -1636,7 +1639,7 @@ void do_cmd_alter_aux(int dir)
 	}
 
 	/* Attack monsters */
-	if (cave->m_idx[y][x] > 0)
+	if (cave_m_idx(cave, y, x) > 0)
 		py_attack(y, x);
 
 	/* Tunnel through walls and rubble */
@@ -1704,7 +1707,7 @@ static bool get_spike(int *ip)
 static bool do_cmd_spike_test(int y, int x)
 {
 	/* Must have knowledge */
-	if (!(cave->info[y][x] & (CAVE_MARK))) {
+	if (!(cave_info(cave, y, x) & (CAVE_MARK))) {
 		msg("You see nothing there.");
 		return FALSE;
 	}
@@ -1716,7 +1719,7 @@ static bool do_cmd_spike_test(int y, int x)
 	}
 
 	/* Check that the door is not fully spiked */
-	if (!(cave->feat[y][x] < FEAT_DOOR_TAIL)) {
+	if (!(cave_feat(cave, y, x) < FEAT_DOOR_TAIL)) {
 		msg("You can't use more spikes on this door.");
 		return FALSE;
 	}
@@ -1769,7 +1772,7 @@ void do_cmd_spike(cmd_code code, cmd_arg args[])
 
 
 	/* Monster */
-	if (cave->m_idx[y][x] > 0)
+	if (cave_m_idx(cave, y, x) > 0)
 	{
 		/* Message */
 		msg("There is a monster in the way!");
@@ -1788,12 +1791,12 @@ void do_cmd_spike(cmd_code code, cmd_arg args[])
 		msg("You jam the door with a spike.");
 
 		/* Convert "locked" to "stuck" XXX XXX XXX */
-		if (cave->feat[y][x] < FEAT_DOOR_HEAD + 0x08)
-			cave->feat[y][x] += 0x08;
+		if (cave_feat(cave, y, x) < FEAT_DOOR_HEAD + 0x08)
+			cave_feat(cave, y, x) += 0x08;
 
 		/* Add one spike to the door */
-		if (cave->feat[y][x] < FEAT_DOOR_TAIL)
-			cave->feat[y][x] += 0x01;
+		if (cave_feat(cave, y, x) < FEAT_DOOR_TAIL)
+			cave_feat(cave, y, x) += 0x01;
 
 		/* Use up, and describe, a single spike, from the bottom */
 		inven_item_increase(item, -1);
@@ -1808,7 +1811,7 @@ void do_cmd_spike(cmd_code code, cmd_arg args[])
  */
 static bool do_cmd_walk_test(int y, int x)
 {
-	int m_idx = cave->m_idx[y][x];
+	int m_idx = cave_m_idx(cave, y, x);
 	struct monster *m_ptr = cave_monster(cave, m_idx);
 
 	/* Allow attack on visible monsters if unafraid */
@@ -1832,18 +1835,18 @@ static bool do_cmd_walk_test(int y, int x)
 	}
 
 	/* If we don't know the grid, allow attempts to walk into it */
-	if (!(cave->info[y][x] & CAVE_MARK))
+	if (!(cave_info(cave, y, x) & CAVE_MARK))
 		return TRUE;
 
 	/* Require open space */
 	if (!cave_floor_bold(y, x))
 	{
 		/* Rubble */
-		if (cave->feat[y][x] == FEAT_RUBBLE)
+		if (cave_feat(cave, y, x) == FEAT_RUBBLE)
 			msgt(MSG_HITWALL, "There is a pile of rubble in the way!");
 
 		/* Door */
-		else if (cave->feat[y][x] < FEAT_SECRET)
+		else if (cave_feat(cave, y, x) < FEAT_SECRET)
 			return TRUE;
 
 		/* Wall */
@@ -1963,6 +1966,31 @@ void do_cmd_pathfind(cmd_code code, cmd_arg args[])
 }
 
 
+/*
+ * Start travelling to a grid anywhere on the level.
+ *
+ * Note that travelling while confused is not allowed.
+ */
+void do_cmd_travel(cmd_code code, cmd_arg args[])
+{
+	/* Hack XXX XXX XXX */
+	int dir = 5;
+	if (player_confuse_dir(p_ptr, &dir, TRUE))
+	{
+		return;
+	}
+
+	if (findpath_travel(args[0].point.y, args[0].point.x))
+	{
+		p_ptr->running = 1000;
+		/* Calculate torch radius */
+		p_ptr->update |= (PU_TORCH);
+		p_ptr->running_withpathfind = TRUE;
+		run_step(0);
+	}
+}
+
+
 
 /*
  * Stay still.  Search.  Enter stores.
@@ -1990,8 +2018,8 @@ void do_cmd_hold(cmd_code code, cmd_arg args[])
 	do_autopickup();
 
 	/* Hack -- enter a store if we are on one */
-	if ((cave->feat[p_ptr->py][p_ptr->px] >= FEAT_SHOP_HEAD) &&
-	    (cave->feat[p_ptr->py][p_ptr->px] <= FEAT_SHOP_TAIL))
+	if ((cave_feat(cave, p_ptr->py, p_ptr->px) >= FEAT_SHOP_HEAD) &&
+	    (cave_feat(cave, p_ptr->py, p_ptr->px) <= FEAT_SHOP_TAIL))
 	{
 		/* Disturb */
 		disturb(p_ptr, 0, 0);
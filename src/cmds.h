@@ -47,6 +47,7 @@ void do_cmd_walk(cmd_code code, cmd_arg args[]);
 void do_cmd_jump(cmd_code code, cmd_arg args[]);
 void do_cmd_run(cmd_code code, cmd_arg args[]);
 void do_cmd_pathfind(cmd_code code, cmd_arg args[]);
+void do_cmd_travel(cmd_code code, cmd_arg args[]);
 void do_cmd_hold(cmd_code code, cmd_arg args[]);
 void do_cmd_pickup(cmd_code code, cmd_arg args[]);
 void do_cmd_autopickup(cmd_code code, cmd_arg args[]);
@@ -89,6 +89,9 @@
 /* Allow changing "visuals" at runtime */
 #define ALLOW_VISUALS
 
+/* Keep the common fields of a cave grid together, rather than one array each */
+#define CAVE_PACKED_GRIDS
+
 
 
 /*** Borg ***/
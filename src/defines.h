@@ -76,14 +76,14 @@
 
 
 /*
- * Number of grids in each dungeon (vertically)
+ * Number of grids in a standard dungeon level (vertically)
  * Must be a multiple of SCREEN_HGT
  * Must be less or equal to 256
  */
 #define DUNGEON_HGT		66
 
 /*
- * Number of grids in each dungeon (horizontally)
+ * Number of grids in a standard dungeon level (horizontally)
  * Must be a multiple of SCREEN_WID
  * Must be less or equal to 256
  */
@@ -740,11 +740,11 @@ enum
 
 
 /*
- * Determines if a map location is "meaningful"
+ * Determines if a map location is "meaningful" on the current level
  */
 #define in_bounds(Y,X) \
-	(((unsigned)(Y) < (unsigned)(DUNGEON_HGT)) && \
-	 ((unsigned)(X) < (unsigned)(DUNGEON_WID)))
+	(((unsigned)(Y) < (unsigned)(cave->height)) && \
+	 ((unsigned)(X) < (unsigned)(cave->width)))
 
 /*
  * Determines if a map location is fully inside the outer walls
@@ -752,8 +752,8 @@ enum
  * often we need to exclude the outer walls from calculations.
  */
 #define in_bounds_fully(Y,X) \
-	(((Y) > 0) && ((Y) < DUNGEON_HGT-1) && \
-	 ((X) > 0) && ((X) < DUNGEON_WID-1))
+	(((Y) > 0) && ((Y) < cave->height-1) && \
+	 ((X) > 0) && ((X) < cave->width-1))
 
 /*
  * Determine if a "legal" grid is a "floor" grid
@@ -763,7 +763,7 @@ enum
  * Note the use of the new "CAVE_WALL" flag.
  */
 #define cave_floor_bold(Y,X) \
-	(!(cave->info[Y][X] & (CAVE_WALL)))
+	(!(cave_info(cave, Y, X) & (CAVE_WALL)))
 
 /*
  * Determine if a "legal" grid is a "clean" floor grid
@@ -772,8 +772,8 @@ enum
  * Line 2 -- forbid normal objects
  */
 #define cave_clean_bold(Y,X) \
-	((cave->feat[Y][X] == FEAT_FLOOR) && \
-	 (cave->o_idx[Y][X] == 0))
+	((cave_feat(cave, Y, X) == FEAT_FLOOR) && \
+	 (cave_o_idx(cave, Y, X) == 0))
 
 /*
  * Determine if a "legal" grid is an "empty" floor grid
@@ -783,7 +783,7 @@ enum
  */
 #define cave_empty_bold(Y,X) \
 	(cave_floor_bold(Y,X) && \
-	 (cave->m_idx[Y][X] == 0))
+	 (cave_m_idx(cave, Y, X) == 0))
 
 /*
  * Determine if a "legal" grid is an "naked" floor grid
@@ -793,9 +793,9 @@ enum
  * Line 3 -- forbid player/monsters
  */
 #define cave_naked_bold(Y,X) \
-	((cave->feat[Y][X] == FEAT_FLOOR) && \
-	 (cave->o_idx[Y][X] == 0) && \
-	 (cave->m_idx[Y][X] == 0))
+	((cave_feat(cave, Y, X) == FEAT_FLOOR) && \
+	 (cave_o_idx(cave, Y, X) == 0) && \
+	 (cave_m_idx(cave, Y, X) == 0))
 
 
 /*
@@ -806,11 +806,11 @@ enum
  * Line 4-5 -- shop doors
  */
 #define cave_perma_bold(Y,X) \
-	((cave->feat[Y][X] >= FEAT_PERM_EXTRA) || \
-	 ((cave->feat[Y][X] == FEAT_LESS) || \
-	  (cave->feat[Y][X] == FEAT_MORE)) || \
-	 ((cave->feat[Y][X] >= FEAT_SHOP_HEAD) && \
-	  (cave->feat[Y][X] <= FEAT_SHOP_TAIL)))
+	((cave_feat(cave, Y, X) >= FEAT_PERM_EXTRA) || \
+	 ((cave_feat(cave, Y, X) == FEAT_LESS) || \
+	  (cave_feat(cave, Y, X) == FEAT_MORE)) || \
+	 ((cave_feat(cave, Y, X) >= FEAT_SHOP_HEAD) && \
+	  (cave_feat(cave, Y, X) <= FEAT_SHOP_TAIL)))
 
 
 /*
@@ -819,7 +819,7 @@ enum
  * Note the use of comparison to zero to force a "boolean" result
  */
 #define player_has_los_bold(Y,X) \
-	((cave->info[Y][X] & (CAVE_VIEW)) != 0)
+	((cave_info(cave, Y, X) & (CAVE_VIEW)) != 0)
 
 
 /*
@@ -828,7 +828,7 @@ enum
  * Note the use of comparison to zero to force a "boolean" result
  */
 #define player_can_see_bold(Y,X) \
-	((cave->info[Y][X] & (CAVE_SEEN)) != 0)
+	((cave_info(cave, Y, X) & (CAVE_SEEN)) != 0)
 
 
 /*
@@ -912,6 +912,53 @@ static void process_player_aux(void)
 }
 
 
+/*
+ * Whether the player is resting with nothing in view, in which case the
+ * screen is left alone (see redraw_if_watched())
+ */
+static bool rest_unwatched = FALSE;
+
+
+/*
+ * Decide, at the start of a player turn, whether the screen can be left
+ * alone until the next one.  It can while the player rests with no monster
+ * in view, as there is nothing to watch but the counters; those are still
+ * brought up to date every 32 turns of rest.
+ */
+static void check_rest_unwatched(void)
+{
+	int i;
+
+	rest_unwatched = FALSE;
+
+	if (!p_ptr->resting || !(p_ptr->resting_turn & 0x1F)) return;
+
+	for (i = 1; i < cave_monster_max(cave); i++)
+	{
+		monster_type *m_ptr = cave_monster(cave, i);
+
+		if (m_ptr->r_idx && m_ptr->ml) return;
+	}
+
+	rest_unwatched = TRUE;
+}
+
+
+/*
+ * Redraw stuff (if needed), unless the player is resting unwatched.  As
+ * disturb() stops the rest, the screen catches up as soon as anything
+ * happens.
+ */
+static void redraw_if_watched(void)
+{
+	if (!p_ptr->redraw) return;
+
+	if (rest_unwatched && p_ptr->resting) return;
+
+	redraw_stuff(p_ptr);
+}
+
+
 /*
  * Process the player
  *
@@ -936,6 +983,9 @@ static void process_player(void)
 
 	/*** Check for interrupts ***/
 
+	/* Decide whether to keep the screen up to date */
+	check_rest_unwatched();
+
 	/* Complete resting */
 	if (p_ptr->resting < 0)
 	{
@@ -1012,14 +1062,14 @@ static void process_player(void)
 		if (p_ptr->update) update_stuff(p_ptr);
 
 		/* Redraw stuff (if needed) */
-		if (p_ptr->redraw) redraw_stuff(p_ptr);
+		redraw_if_watched();
 
 
 		/* Place the cursor on the player */
 		move_cursor_relative(p_ptr->py, p_ptr->px);
 
 		/* Refresh (optional) */
-		Term_fresh();
+		if (!(rest_unwatched && p_ptr->resting)) Term_fresh();
 
 		/* Hack -- Pack Overflow */
 		pack_overflow();
@@ -1106,6 +1156,9 @@ static void process_player(void)
 			/* Check monster recall */
 			process_player_aux();
 
+			/* Use the wait for a command to build the next levels */
+			if (OPT(pregen_levels)) cave_pregenerate(p_ptr);
+
 			/* Place the cursor on the player */
 			move_cursor_relative(p_ptr->py, p_ptr->px);
 
@@ -1129,6 +1182,9 @@ static void process_player(void)
 			/* Increment the total energy counter */
 			p_ptr->total_energy += p_ptr->energy_use;
 
+			/* Let noises fade and the trail go cold */
+			cave_senses_tick(cave);
+
 			/* Hack -- constant hallucination */
 			if (p_ptr->timed[TMD_IMAGE])
 			{
@@ -1271,6 +1327,171 @@ void idle_update(void)
 }
 
 
+/*
+ * The energy a monster gets each game turn
+ */
+static int monster_turn_energy(const monster_type *m_ptr)
+{
+	int mspeed = m_ptr->mspeed;
+
+	/* Calculate the net speed */
+	if (m_ptr->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (m_ptr->m_timed[MON_TMD_SLOW])
+		mspeed -= 10;
+
+	return (extract_energy[mspeed]);
+}
+
+
+/*
+ * Give the player and all monsters the energy of "n" game turns.
+ *
+ * Returns the number of game turns after those until the player or a
+ * monster has the energy to act, which is 0 if one already has.
+ */
+static int give_energy(struct cave *c, int n)
+{
+	int i, gain, wait;
+
+	/* Give the player some energy */
+	gain = extract_energy[p_ptr->state.speed];
+	p_ptr->energy += n * gain;
+
+	/* Turns until the player can act */
+	wait = 0;
+	if (p_ptr->energy < 100)
+		wait = (100 - p_ptr->energy + gain - 1) / gain;
+
+	/* Give energy to all monsters */
+	for (i = cave_monster_max(c) - 1; i >= 1; i--)
+	{
+		monster_type *m_ptr = cave_monster(c, i);
+
+		/* Ignore "dead" monsters */
+		if (!m_ptr->r_idx) continue;
+
+		/* Give this monster some energy */
+		gain = monster_turn_energy(m_ptr);
+		m_ptr->energy += n * gain;
+
+		/* Let process_monsters() find it */
+		if (m_ptr->energy >= 100)
+		{
+			cave_monster_set_ready(c, i, TRUE);
+			wait = 0;
+		}
+
+		/* Turns until the first monster can act */
+		else if (wait)
+			wait = MIN(wait, (100 - m_ptr->energy + gain - 1) / gain);
+	}
+
+	return (wait);
+}
+
+
+/*
+ * The number of game turns, starting with this one, on which the main loop
+ * of dungeon() would do nothing but hand out energy, given that "wait" turns
+ * pass before anyone has the energy to act: the world is not due its next
+ * turn, and nothing is waiting to be compacted or redrawn.
+ *
+ * Each of those turns would give everyone the same energy as the last, so
+ * they can all be passed over at once with give_energy(), with the same
+ * outcome as playing them one by one.  Resting, paralysis and slow players
+ * spend most of their game turns like this.
+ */
+static int idle_turns(struct cave *c, int wait)
+{
+	/* Something to do before the turn starts */
+	if (p_ptr->leaving || p_ptr->notice || p_ptr->update)
+		return (0);
+
+	/* Something to redraw */
+	if (p_ptr->redraw && !(rest_unwatched && p_ptr->resting))
+		return (0);
+
+	/* Lists to compact (see dungeon()) */
+	if ((cave_monster_count(c) + 32 > z_info->m_max) ||
+			(cave_monster_count(c) + 32 < cave_monster_max(c)) ||
+			(o_cnt + 32 > z_info->o_max) || (o_cnt + 32 < o_max))
+		return (0);
+
+	/* Turns until process_world() has work to do */
+	return (MIN(wait, (10 - turn % 10) % 10));
+}
+
+
+/*
+ * Play the rest of a game turn once the player has acted: process the
+ * monsters and the world, then hand out the energy for the turn.  If "skip"
+ * is set, also pass straight over the turns after it on which nothing would
+ * happen.  The outcome is the same either way; the benchmark checks this.
+ *
+ * Returns FALSE if the player is leaving the level.
+ */
+bool process_game_turn(struct cave *c, bool skip)
+{
+	int n;
+
+	/* Process all of the monsters */
+	process_monsters(c, 100);
+
+	/* Notice stuff */
+	if (p_ptr->notice) notice_stuff(p_ptr);
+
+	/* Update stuff */
+	if (p_ptr->update) update_stuff(p_ptr);
+
+	/* Redraw stuff */
+	redraw_if_watched();
+
+	/* Hack -- Highlight the player */
+	move_cursor_relative(p_ptr->py, p_ptr->px);
+
+	/* Handle "leaving" */
+	if (p_ptr->leaving) return (FALSE);
+
+
+	/* Process the world */
+	process_world(c);
+
+	/* Notice stuff */
+	if (p_ptr->notice) notice_stuff(p_ptr);
+
+	/* Update stuff */
+	if (p_ptr->update) update_stuff(p_ptr);
+
+	/* Redraw stuff */
+	redraw_if_watched();
+
+	/* Hack -- Highlight the player */
+	move_cursor_relative(p_ptr->py, p_ptr->px);
+
+	/* Handle "leaving" */
+	if (p_ptr->leaving) return (FALSE);
+
+	/*** Apply energy ***/
+
+	/* Give the player and the monsters some energy */
+	n = give_energy(c, 1);
+
+	/* Count game turns */
+	turn++;
+
+	/* Pass straight over the turns on which nothing would happen */
+	n = skip ? idle_turns(c, n) : 0;
+	if (n)
+	{
+		give_energy(c, n);
+		turn += n;
+	}
+
+	return (TRUE);
+}
+
+
 /*
  * Interact with the current dungeon level.
  *
@@ -1279,14 +1500,9 @@ void idle_update(void)
  */
 static void dungeon(struct cave *c)
 {
-	monster_type *m_ptr;
-	int i;
-
-
-
 	/* Hack -- enforce illegal panel */
-	Term->offset_y = DUNGEON_HGT;
-	Term->offset_x = DUNGEON_WID;
+	Term->offset_y = c->height;
+	Term->offset_x = c->width;
 
 
 	/* Not leaving */
@@ -1463,7 +1679,7 @@ static void dungeon(struct cave *c)
 		if (p_ptr->update) update_stuff(p_ptr);
 
 		/* Redraw stuff */
-		if (p_ptr->redraw) redraw_stuff(p_ptr);
+		redraw_if_watched();
 
 		/* Hack -- Highlight the player */
 		move_cursor_relative(p_ptr->py, p_ptr->px);
@@ -1471,73 +1687,8 @@ static void dungeon(struct cave *c)
 		/* Handle "leaving" */
 		if (p_ptr->leaving) break;
 
-
-		/* Process all of the monsters */
-		process_monsters(c, 100);
-
-		/* Notice stuff */
-		if (p_ptr->notice) notice_stuff(p_ptr);
-
-		/* Update stuff */
-		if (p_ptr->update) update_stuff(p_ptr);
-
-		/* Redraw stuff */
-		if (p_ptr->redraw) redraw_stuff(p_ptr);
-
-		/* Hack -- Highlight the player */
-		move_cursor_relative(p_ptr->py, p_ptr->px);
-
-		/* Handle "leaving" */
-		if (p_ptr->leaving) break;
-
-
-		/* Process the world */
-		process_world(c);
-
-		/* Notice stuff */
-		if (p_ptr->notice) notice_stuff(p_ptr);
-
-		/* Update stuff */
-		if (p_ptr->update) update_stuff(p_ptr);
-
-		/* Redraw stuff */
-		if (p_ptr->redraw) redraw_stuff(p_ptr);
-
-		/* Hack -- Highlight the player */
-		move_cursor_relative(p_ptr->py, p_ptr->px);
-
-		/* Handle "leaving" */
-		if (p_ptr->leaving) break;
-
-		/*** Apply energy ***/
-
-		/* Give the player some energy */
-		p_ptr->energy += extract_energy[p_ptr->state.speed];
-
-		/* Give energy to all monsters */
-		for (i = cave_monster_max(cave) - 1; i >= 1; i--)
-		{
-			int mspeed;
-			
-			/* Access the monster */
-			m_ptr = cave_monster(cave, i);
-
-			/* Ignore "dead" monsters */
-			if (!m_ptr->r_idx) continue;
-
-			/* Calculate the net speed */
-			mspeed = m_ptr->mspeed;
-			if (m_ptr->m_timed[MON_TMD_FAST])
-				mspeed += 10;
-			if (m_ptr->m_timed[MON_TMD_SLOW])
-				mspeed -= 10;
-
-			/* Give this monster some energy */
-			m_ptr->energy += extract_energy[mspeed];
-		}
-
-		/* Count game turns */
-		turn++;
+		/* Play out the rest of the turn */
+		if (!process_game_turn(c, TRUE)) break;
 	}
 }
 
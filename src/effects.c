@@ -2009,7 +2009,7 @@ bool effect_do(effect_type effect, bool *ident, bool aware, int dir, int beam,
 			msgt(MSG_SUM_MONSTER, "You are enveloped in a cloud of smoke!");
 
 			/* Remove trap */
-			cave->info[py][px] &= ~(CAVE_MARK);
+			cave_info_off(cave, py, px, CAVE_MARK);
 			cave_set_feat(cave, py, px, FEAT_FLOOR);
 
 			for (i = 0; i < num; i++)
@@ -162,12 +162,14 @@ extern void dungeon_change_level(int dlev);
 extern void play_game(void);
 extern int value_check_aux1(const object_type *o_ptr);
 extern void idle_update(void);
+extern bool process_game_turn(struct cave *c, bool skip);
 
 /* melee2.c */
 extern bool make_attack_spell(int m_idx);
 
 /* pathfind.c */
 extern bool findpath(int y, int x);
+extern bool findpath_travel(int y, int x);
 extern void run_step(int dir);
 
 /* randart.c */
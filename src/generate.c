@@ -25,7 +25,9 @@
 #include "monster/mon-make.h"
 #include "monster/mon-spell.h"
 #include "object/tvalsval.h"
+#include "target.h"
 #include "trap.h"
+#include "z-bitboard.h"
 #include "z-queue.h"
 #include "z-type.h"
 
@@ -40,6 +42,17 @@ static struct dun_data *dun;
  */
 static int *cave_squares = NULL;
 
+/**
+ * Hooks for watching which profiles, rooms, vaults and pits get built.
+ */
+void (*gen_restart_hook)(struct cave *c) = NULL;
+void (*gen_vault_hook)(struct cave *c, const struct vault *v_ptr) = NULL;
+void (*gen_pit_hook)(struct cave *c, const pit_profile *pit) = NULL;
+void (*gen_profile_hook)(struct cave *c, const struct cave_profile *profile,
+	bool done, bool built) = NULL;
+void (*gen_room_hook)(struct cave *c, const struct room_profile *profile,
+	bool done, bool built) = NULL;
+
 static bool town_gen(struct cave *c, struct player *p);
 
 static bool default_gen(struct cave *c, struct player *p);
@@ -346,60 +359,54 @@ static bool cave_find(struct cave *c, int *y, int *x, cave_predicate pred)
 
 
 /**
- * Locate a square in y1 <= y < y2, x1 <= x < x2 which satisfies the given
- * predicate.
+ * Locate an empty square for y1 <= y < y2, x1 <= x < x2.
+ *
+ * Every empty square in the range is equally likely: they are counted in
+ * c->empty_grids, and one is picked by its rank.
  */
-static bool cave_find_in_range(struct cave *c, int *y, int y1, int y2,
-	int *x, int x1, int x2, cave_predicate pred)
+static bool find_empty_range(struct cave *c, int *y, int y1, int y2, int *x, int x1, int x2)
 {
-	int yd = y2 - y1;
-	int xd = x2 - x1;
-	int n = yd * xd;
-	int i, found;
+	int n = bitboard_count_rect(c->empty_grids, y1, x1, y2 - 1, x2 - 1);
 
-	/* Allocate the squares, and randomize their order */
-	int *squares = C_ZNEW(n, int);
-	for (i = 0; i < n; i++) squares[i] = i;
-
-	/* Do the actual search */
-	found = _find_in_range(c, y, y1, y2, x, x1, x2, squares, pred);
-
-	/* Deallocate memory */
-	FREE(squares);
-
-	/* Return whether or not we found an empty square */
-	return found;
+	if (!n) return FALSE;
+	return bitboard_select_rect(c->empty_grids, y1, x1, y2 - 1, x2 - 1,
+		randint0(n), y, x);
 }
 
 
 /**
  * Locate an empty square for 0 <= y < ymax, 0 <= x < xmax.
+ *
+ * Every empty square is equally likely. A randomly chosen square is left
+ * in (y, x) if there are none.
  */
 static bool find_empty(struct cave *c, int *y, int *x)
 {
-	return cave_find(c, y, x, cave_isempty);
-}
-
+	if (find_empty_range(c, y, 0, c->height, x, 0, c->width)) return TRUE;
 
-/**
- * Locate an empty square for y1 <= y < y2, x1 <= x < x2.
- */
-static bool find_empty_range(struct cave *c, int *y, int y1, int y2, int *x, int x1, int x2)
-{
-	return cave_find_in_range(c, y, y1, y2, x, x1, x2, cave_isempty);
+	*y = randint0(c->height);
+	*x = randint0(c->width);
+	return FALSE;
 }
 
 
 /**
  * Locate a grid nearby (y0, x0) within +/- yd, xd.
+ *
+ * Every grid of the range which is in bounds is equally likely.
  */
 static bool find_nearby_grid(struct cave *c, int *y, int y0, int yd, int *x, int x0, int xd)
 {
-	int y1 = y0 - yd;
-	int x1 = x0 - xd;
-	int y2 = y0 + yd + 1;
-	int x2 = x0 + xd + 1;
-	return cave_find_in_range(c, y, y1, y2, x, x1, x2, cave_in_bounds);
+	int y1 = MAX(y0 - yd, 0);
+	int x1 = MAX(x0 - xd, 0);
+	int y2 = MIN(y0 + yd, c->height - 1);
+	int x2 = MIN(x0 + xd, c->width - 1);
+
+	if (y1 > y2 || x1 > x2) return FALSE;
+
+	*y = rand_range(y1, y2);
+	*x = rand_range(x1, x2);
+	return TRUE;
 }
 
 
@@ -454,7 +461,7 @@ static void new_player_spot(struct cave *c, struct player *p)
 	int y, x;
 
 	/* Try to find a good place to put the player */
-	cave_find_in_range(c, &y, 0, c->height, &x, 0, c->width, cave_isstart);
+	cave_find(c, &y, &x, cave_isstart);
 
 	/* Create stairs the player came down if allowed and necessary */
 	if (OPT(birth_no_stairs)) {
@@ -729,7 +736,7 @@ static bool alloc_object(struct cave *c, int set, int typ, int depth, byte origi
 		find_empty(c, &y, &x);
 
 		/* See if our spot is in a room or not */
-		room = (c->info[y][x] & CAVE_ROOM) ? TRUE : FALSE;
+		room = (cave_info(c, y, x) & CAVE_ROOM) ? TRUE : FALSE;
 
 		/* If we are ok with a corridor and we're in one, we're done */
 		if (set & SET_CORR && !room) break;
@@ -768,8 +775,8 @@ static void build_streamer(struct cave *c, int feat, int chance)
 	int y, x, dir;
 
 	/* Hack -- Choose starting point */
-	y = rand_spread(DUNGEON_HGT / 2, 10);
-	x = rand_spread(DUNGEON_WID / 2, 15);
+	y = rand_spread(c->height / 2, 10);
+	x = rand_spread(c->width / 2, 15);
 
 	/* Choose a random direction */
 	dir = ddd[randint0(8)];
@@ -896,11 +903,8 @@ static void vault_monsters(struct cave *c, int y1, int x1, int depth, int num)
  */
 static void generate_room(struct cave *c, int y1, int x1, int y2, int x2, int light)
 {
-	int y, x;
 	int add = CAVE_ROOM | (light ? CAVE_GLOW : 0);
-	for (y = y1; y <= y2; y++)
-		for (x = x1; x <= x2; x++)
-			c->info[y][x] |= add;
+	cave_info_fill(c, y1, x1, y2, x2, add, TRUE);
 }
 
 
@@ -947,7 +951,7 @@ static void fill_xrange(struct cave *c, int y, int x1, int x2, int feat, int inf
 	int x;
 	for (x = x1; x <= x2; x++) {
 		cave_set_feat(c, y, x, feat);
-		c->info[y][x] |= info;
+		cave_info_on(c, y, x, info);
 	}
 }
 
@@ -960,7 +964,7 @@ static void fill_yrange(struct cave *c, int x, int y1, int y2, int feat, int inf
 	int y;
 	for (y = y1; y <= y2; y++) {
 		cave_set_feat(c, y, x, feat);
-		c->info[y][x] |= info;
+		cave_info_on(c, y, x, info);
 	}
 }
 
@@ -1693,6 +1697,7 @@ static bool build_nest(struct cave *c, int y0, int x0)
 
 	/* Describe */
 	ROOM_LOG("Monster nest (%s)", pit_info[pit_idx].name);
+	if (gen_pit_hook) gen_pit_hook(c, &pit_info[pit_idx]);
 
 	/* Increase the level rating */
 	c->mon_rating += (5 + pit_info[pit_idx].ave / 10);
@@ -1805,6 +1810,7 @@ static bool build_pit(struct cave *c, int y0, int x0)
 		return FALSE;
 
 	ROOM_LOG("Monster pit (%s)", pit_info[pit_idx].name);
+	if (gen_pit_hook) gen_pit_hook(c, &pit_info[pit_idx]);
 
 	/* Sort the entries XXX XXX XXX */
 	for (i = 0; i < 16 - 1; i++) {
@@ -1891,16 +1897,164 @@ static bool build_pit(struct cave *c, int y0, int x0)
 	return TRUE;
 }
 
+/*** Compiled vaults and room templates ***/
+
+/**
+ * Work out how a room template grid is laid. Returns FALSE for a non-grid.
+ */
+static bool room_grid(const char *t, struct stamp_op *op, bool *place)
+{
+	op->feat = FEAT_FLOOR;
+	op->info = CAVE_ROOM;
+	*place = FALSE;
+
+	switch (*t) {
+		case ' ': return FALSE;
+		case '%': op->feat = FEAT_WALL_OUTER; break;
+		case '#': op->feat = FEAT_WALL_SOLID; break;
+		case '+': case 'x': case '=': case '~': case '!': op->sym = *t; break;
+		case '1': case '2': case '3': case '4': case '5':
+		case '6': case '7': case '8': case '9': {
+			op->sym = *t;
+			op->num = atoi(t);
+			break;
+		}
+	}
+
+	return TRUE;
+}
+
 /**
- * Build a room template from its string representation.
+ * Work out how a vault grid is laid. Returns FALSE for a non-grid.
  */
+static bool vault_grid(const char *t, struct stamp_op *op, bool *place)
+{
+	op->feat = FEAT_FLOOR;
+	op->info = CAVE_ROOM | CAVE_ICKY;
+	*place = FALSE;
+
+	switch (*t) {
+		case ' ': return FALSE;
+		case '%': {
+			/* In this case, the square isn't really part of the
+			 * vault, but rather is part of the "door step" to the
+			 * vault. We don't mark it icky so that the tunneling
+			 * code knows its allowed to remove this wall. */
+			op->feat = FEAT_WALL_OUTER;
+			op->info = CAVE_ROOM;
+			break;
+		}
+		case '#': op->feat = FEAT_WALL_INNER; break;
+		case 'X': op->feat = FEAT_PERM_INNER; break;
+		case '+': case '^': case '*': op->sym = *t; break;
+		case '&': case '@': case '9': case '8': case ',': *place = TRUE; break;
+	}
 
+	return TRUE;
+}
 
-static void build_room_template(struct cave *c, int y0, int x0, int ymax, int xmax, int doors, const char *data)
+/**
+ * Compile the text of a vault or room template, read as rows of wid
+ * characters, into a stamp. Runs of plain grids along a row are merged into
+ * one step.
+ */
+static struct stamp *stamp_compile(const char *text, int hgt, int wid,
+		bool (*grid)(const char *t, struct stamp_op *op, bool *place))
 {
-	int dx, dy, x, y, rnddoors, doorpos, info;
+	struct stamp *s = mem_zalloc(sizeof(*s));
+	size_t size = hgt * wid;
 	const char *t;
+	int dx, dy;
+
+	s->ops = C_ZNEW(size, struct stamp_op);
+	s->places = C_ZNEW(size, struct stamp_op);
+
+	for (t = text, dy = 0; t && dy < hgt && *t; dy++) {
+		for (dx = 0; dx < wid && *t; dx++, t++) {
+			struct stamp_op op, *last;
+			bool place;
+
+			WIPE(&op, struct stamp_op);
+			op.dy = dy;
+			op.dx = dx;
+			op.len = 1;
+			if (!grid(t, &op, &place)) continue;
+
+			if (place) {
+				s->places[s->n_places] = op;
+				s->places[s->n_places++].sym = *t;
+			}
+
+			/* Extend the last run if this grid carries on from it */
+			last = s->n_ops ? &s->ops[s->n_ops - 1] : NULL;
+			if (!op.sym && last && !last->sym && last->dy == dy &&
+					last->dx + last->len == dx && last->feat == op.feat &&
+					last->info == op.info && last->len < 255) {
+				last->len++;
+				continue;
+			}
+
+			s->ops[s->n_ops++] = op;
+		}
+	}
+
+	s->ops = mem_realloc(s->ops, MAX(s->n_ops, 1) * sizeof(*s->ops));
+	s->places = mem_realloc(s->places,
+		MAX(s->n_places, 1) * sizeof(*s->places));
+
+	return s;
+}
+
+/**
+ * Compile a vault's text into a stamp.
+ */
+struct stamp *stamp_compile_vault(const struct vault *v)
+{
+	return stamp_compile(v->text, v->hgt, v->wid, vault_grid);
+}
+
+/**
+ * Compile a room template's text into a stamp.
+ */
+struct stamp *stamp_compile_room(const struct room_template *t)
+{
+	return stamp_compile(t->text, t->hgt, t->wid, room_grid);
+}
+
+void stamp_free(struct stamp *s)
+{
+	if (!s) return;
+	mem_free(s->ops);
+	mem_free(s->places);
+	mem_free(s);
+}
+
+/**
+ * Lay down a run of grids from a stamp.
+ */
+static void stamp_run(struct cave *c, int y, int x, const struct stamp_op *op,
+		int info)
+{
+	int i;
+
+	for (i = 0; i < op->len; i++) {
+		cave_set_feat(c, y, x + i, op->feat);
+		cave_info_on(c, y, x + i, op->info | info);
+	}
+}
+
+/**
+ * Build a room template from its compiled layout.
+ */
+static void build_room_template(struct cave *c, int y0, int x0,
+		const struct room_template *t_ptr)
+{
+	const struct stamp *s = t_ptr->stamp;
+	int y1 = y0 - (t_ptr->hgt / 2);
+	int x1 = x0 - (t_ptr->wid / 2);
+	int x, y, rnddoors, info;
 	bool rndwalls, light;
+	size_t i;
 
 	assert(c);
 
@@ -1912,111 +2066,101 @@ static void build_room_template(struct cave *c, int y0, int x0, int ymax, int xm
 
 	/* Set the random door position here so it generates doors in all squares
 	 * marked with the same number */
-	rnddoors = randint1(doors);
+	rnddoors = randint1(t_ptr->dor);
 
 	/* Decide whether optional walls will be generated this time */
 	rndwalls = one_in_(2) ? TRUE : FALSE;
 
 	/* Place dungeon features and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the location */
-			x = x0 - (xmax / 2) + dx;
-			y = y0 - (ymax / 2) + dy;
+	for (i = 0; i < s->n_ops; i++) {
+		const struct stamp_op *op = &s->ops[i];
 
-			/* Skip non-grids */
-			if (*t == ' ') continue;
+		/* Extract the location */
+		x = x1 + op->dx;
+		y = y1 + op->dy;
 
-			/* Lay down a floor */
-			cave_set_feat(c, y, x, FEAT_FLOOR);
+		/* Plain grids are laid in one go */
+		if (!op->sym) {
+			stamp_run(c, y, x, op, info);
+			continue;
+		}
 
-			/* Debugging assertion */
-			assert(cave_isempty(c, y, x));
+		/* Lay down a floor */
+		cave_set_feat(c, y, x, FEAT_FLOOR);
 
-			/* Analyze the grid */
-			switch (*t) {
-				case '%': cave_set_feat(c, y, x, FEAT_WALL_OUTER); break;
-				case '#': cave_set_feat(c, y, x, FEAT_WALL_SOLID); break;
-				case '+': place_secret_door(c, y, x); break;
-				case 'x': {
+		/* Debugging assertion */
+		assert(cave_isempty(c, y, x));
 
-					/* If optional walls are generated, put a wall in this square */
+		/* Analyze the grid */
+		switch (op->sym) {
+			case '+': place_secret_door(c, y, x); break;
+			case 'x': {
 
-					if (rndwalls)
-						cave_set_feat(c, y, x, FEAT_WALL_SOLID);
-					break;
-				}
-				case '=': {
+				/* If optional walls are generated, put a wall in this square */
 
-					/* If optional walls are generated, put a door in this square */
+				if (rndwalls)
+					cave_set_feat(c, y, x, FEAT_WALL_SOLID);
+				break;
+			}
+			case '=': {
 
-					if (rndwalls)
-						place_secret_door(c, y, x);
-					break;
-				}
-				case '~': {
+				/* If optional walls are generated, put a door in this square */
 
-					/* Put something nice in this square
-					 * Object (80%) or Stairs (20%) */
-					if (randint0(100) < 80)
-						place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_SPECIAL);
-					else
-						place_random_stairs(c, y, x);
+				if (rndwalls)
+					place_secret_door(c, y, x);
+				break;
+			}
+			case '~': {
 
-					/* Some monsters to guard it */
-					vault_monsters(c, y, x, c->depth + 2, randint0(2) + 3);
+				/* Put something nice in this square
+				 * Object (80%) or Stairs (20%) */
+				if (randint0(100) < 80)
+					place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_SPECIAL);
+				else
+					place_random_stairs(c, y, x);
 
-					/* And some traps too */
-					vault_traps(c, y, x, 4, 4, randint0(3) + 2);
+				/* Some monsters to guard it */
+				vault_monsters(c, y, x, c->depth + 2, randint0(2) + 3);
 
-					break;
-				}
-				case '!': {
+				/* And some traps too */
+				vault_traps(c, y, x, 4, 4, randint0(3) + 2);
 
-					/* Create some interesting stuff nearby */
+				break;
+			}
+			case '!': {
 
-					/* A few monsters */
-					vault_monsters(c, y - 3, x - 3, c->depth + randint0(2), randint1(2));
-					vault_monsters(c, y + 3, x + 3, c->depth + randint0(2), randint1(2));
+				/* Create some interesting stuff nearby */
 
-					/* And maybe a bit of treasure */
+				/* A few monsters */
+				vault_monsters(c, y - 3, x - 3, c->depth + randint0(2), randint1(2));
+				vault_monsters(c, y + 3, x + 3, c->depth + randint0(2), randint1(2));
 
-					if (one_in_(2))
-						vault_objects(c, y - 2, x + 2, c->depth, 1 + randint0(2));
+				/* And maybe a bit of treasure */
 
-					if (one_in_(2))
-						vault_objects(c, y + 2, x - 2, c->depth, 1 + randint0(2));
+				if (one_in_(2))
+					vault_objects(c, y - 2, x + 2, c->depth, 1 + randint0(2));
 
-					break;
+				if (one_in_(2))
+					vault_objects(c, y + 2, x - 2, c->depth, 1 + randint0(2));
 
-				}
-				case '1':
-				case '2':
-				case '3':
-				case '4':
-				case '5':
-				case '6':
-				case '7':
-				case '8':
-				case '9': {
-
-					/* Check if this is chosen random door position */
-
-					doorpos = atoi(t);
-
-					if (doorpos == rnddoors)
-						place_secret_door(c, y, x);
-					else
-						cave_set_feat(c, y, x, FEAT_WALL_SOLID);
+				break;
 
-					break;
-				}
 			}
+			default: {
 
-		/* Part of a room */
-		c->info[y][x] |= info;
+				/* Check if this is chosen random door position */
 
+				if (op->num == rnddoors)
+					place_secret_door(c, y, x);
+				else
+					cave_set_feat(c, y, x, FEAT_WALL_SOLID);
+
+				break;
+			}
 		}
+
+		/* Part of a room */
+		cave_info_on(c, y, x, info);
 	}
 }
 
@@ -2035,7 +2179,7 @@ static bool build_room_template_type(struct cave*c, int y0, int x0, int typ, con
 	ROOM_LOG("Room template (%s)", t_ptr->name);
 
 	/* Build the room */
-	build_room_template(c, y0, x0, t_ptr->hgt, t_ptr->wid, t_ptr->dor, t_ptr->text);
+	build_room_template(c, y0, x0, t_ptr);
 
 	return TRUE;
 }
@@ -2050,112 +2194,99 @@ static bool build_template(struct cave *c, int y0, int x0)
 
 
 /**
- * Build a vault from its string representation.
+ * Build a vault from its compiled layout.
  */
-static void build_vault(struct cave *c, int y0, int x0, int ymax, int xmax, const char *data)
+static void build_vault(struct cave *c, int y0, int x0, const struct vault *v_ptr)
 {
-	int dx, dy, x, y;
-	const char *t;
-	bool icky;
+	const struct stamp *s = v_ptr->stamp;
+	int y1 = y0 - (v_ptr->hgt / 2);
+	int x1 = x0 - (v_ptr->wid / 2);
+	int x, y;
+	size_t i;
 
 	assert(c);
 
-	/* Place dungeon features and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the location */
-			x = x0 - (xmax / 2) + dx;
-			y = y0 - (ymax / 2) + dy;
+	/* Place dungeon features, doors and traps */
+	for (i = 0; i < s->n_ops; i++) {
+		const struct stamp_op *op = &s->ops[i];
 
-			/* Skip non-grids */
-			if (*t == ' ') continue;
+		/* Extract the location */
+		x = x1 + op->dx;
+		y = y1 + op->dy;
 
-			/* Lay down a floor */
-			cave_set_feat(c, y, x, FEAT_FLOOR);
+		/* Plain grids are laid in one go */
+		if (!op->sym) {
+			stamp_run(c, y, x, op, 0);
+			continue;
+		}
 
-			/* Debugging assertion */
-			assert(cave_isempty(c, y, x));
-
-			/* By default vault squares are marked icky */
-			icky = TRUE;
-
-			/* Analyze the grid */
-			switch (*t) {
-				case '%': {
-					/* In this case, the square isn't really part of the
-					 * vault, but rather is part of the "door step" to the
-					 * vault. We don't mark it icky so that the tunneling
-					 * code knows its allowed to remove this wall. */
-					cave_set_feat(c, y, x, FEAT_WALL_OUTER);
-					icky = FALSE;
-					break;
-				}
-				case '#': cave_set_feat(c, y, x, FEAT_WALL_INNER); break;
-				case 'X': cave_set_feat(c, y, x, FEAT_PERM_INNER); break;
-				case '+': place_secret_door(c, y, x); break;
-				case '^': place_trap(c, y, x); break;
-				case '*': {
-					/* Treasure or a trap */
-					if (randint0(100) < 75)
-						place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_VAULT);
-					else
-						place_trap(c, y, x);
-					break;
-				}
-			}
+		/* Lay down a floor */
+		cave_set_feat(c, y, x, FEAT_FLOOR);
 
-			/* Part of a vault */
-			c->info[y][x] |= CAVE_ROOM;
-			if (icky) c->info[y][x] |= CAVE_ICKY;
+		/* Debugging assertion */
+		assert(cave_isempty(c, y, x));
+
+		/* Analyze the grid */
+		switch (op->sym) {
+			case '+': place_secret_door(c, y, x); break;
+			case '^': place_trap(c, y, x); break;
+			case '*': {
+				/* Treasure or a trap */
+				if (randint0(100) < 75)
+					place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_VAULT);
+				else
+					place_trap(c, y, x);
+				break;
+			}
 		}
+
+		/* Part of a vault */
+		cave_info_on(c, y, x, op->info);
 	}
 
 
 	/* Place dungeon monsters and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the grid */
-			x = x0 - (xmax / 2) + dx;
-			y = y0 - (ymax / 2) + dy;
-
-			/* Hack -- skip "non-grids" */
-			if (*t == ' ') continue;
-
-			/* Analyze the symbol */
-			switch (*t) {
-				case '&': pick_and_place_monster(c, y, x, c->depth + 5, TRUE, TRUE,
-					ORIGIN_DROP_VAULT); break;
-				case '@': pick_and_place_monster(c, y, x, c->depth + 11, TRUE, TRUE,
-					ORIGIN_DROP_VAULT); break;
-
-				case '9': {
-					/* Meaner monster, plus treasure */
-					pick_and_place_monster(c, y, x, c->depth + 9, TRUE, TRUE,
-						ORIGIN_DROP_VAULT);
-					place_object(c, y, x, c->depth + 7, TRUE, FALSE,
-						ORIGIN_VAULT);
-					break;
-				}
+	for (i = 0; i < s->n_places; i++) {
+		const struct stamp_op *op = &s->places[i];
+
+		/* Extract the grid */
+		x = x1 + op->dx;
+		y = y1 + op->dy;
+
+		/* Analyze the symbol */
+		switch (op->sym) {
+			case '&': pick_and_place_monster(c, y, x, c->depth + 5, TRUE, TRUE,
+				ORIGIN_DROP_VAULT); break;
+			case '@': pick_and_place_monster(c, y, x, c->depth + 11, TRUE, TRUE,
+				ORIGIN_DROP_VAULT); break;
+
+			case '9': {
+				/* Meaner monster, plus treasure */
+				pick_and_place_monster(c, y, x, c->depth + 9, TRUE, TRUE,
+					ORIGIN_DROP_VAULT);
+				place_object(c, y, x, c->depth + 7, TRUE, FALSE,
+					ORIGIN_VAULT);
+				break;
+			}
+
+			case '8': {
+				/* Nasty monster and treasure */
+				pick_and_place_monster(c, y, x, c->depth + 40, TRUE, TRUE,
+					ORIGIN_DROP_VAULT);
+				place_object(c, y, x, c->depth + 20, TRUE, TRUE,
+					ORIGIN_VAULT);
+				break;
+			}
 
-				case '8': {
-					/* Nasty monster and treasure */
-					pick_and_place_monster(c, y, x, c->depth + 40, TRUE, TRUE,
+			case ',': {
+				/* Monster and/or object */
+				if (randint0(100) < 50)
+					pick_and_place_monster(c, y, x, c->depth + 3, TRUE, TRUE,
 						ORIGIN_DROP_VAULT);
-					place_object(c, y, x, c->depth + 20, TRUE, TRUE,
+				if (randint0(100) < 50)
+					place_object(c, y, x, c->depth + 7, FALSE, FALSE,
 						ORIGIN_VAULT);
-					break;
-				}
-
-				case ',': {
-					/* Monster and/or object */
-					if (randint0(100) < 50)
-						pick_and_place_monster(c, y, x, c->depth + 3, TRUE, TRUE,
-							ORIGIN_DROP_VAULT);
-					if (randint0(100) < 50)
-						place_object(c, y, x, c->depth + 7, FALSE, FALSE,
-							ORIGIN_VAULT);
-					break;
-				}
+				break;
 			}
 		}
 	}
@@ -2174,12 +2305,13 @@ static bool build_vault_type(struct cave*c, int y0, int x0, int typ, const char
 	}
 
 	ROOM_LOG("%s (%s)", label, v_ptr->name);
+	if (gen_vault_hook) gen_vault_hook(c, v_ptr);
 
 	/* Boost the rating */
 	c->mon_rating += v_ptr->rat;
 
 	/* Build the vault */
-	build_vault(c, y0, x0, v_ptr->hgt, v_ptr->wid, v_ptr->text);
+	build_vault(c, y0, x0, v_ptr);
 
 	return TRUE;
 }
@@ -2323,21 +2455,21 @@ static void build_tunnel(struct cave *c, int row1, int col1, int row2, int col2)
 		if (cave_isperm(c, tmp_row, tmp_col)) continue;
 
 		/* Avoid "solid" granite walls */
-		if (c->feat[tmp_row][tmp_col] == FEAT_WALL_SOLID) continue;
+		if (cave_feat(c, tmp_row, tmp_col) == FEAT_WALL_SOLID) continue;
 
 		/* Pierce "outer" walls of rooms */
-		if (c->feat[tmp_row][tmp_col] == FEAT_WALL_OUTER) {
+		if (cave_feat(c, tmp_row, tmp_col) == FEAT_WALL_OUTER) {
 			/* Get the "next" location */
 			y = tmp_row + row_dir;
 			x = tmp_col + col_dir;
 
 			/* Hack -- Avoid outer/solid permanent walls */
-			if (c->feat[y][x] == FEAT_PERM_SOLID) continue;
-			if (c->feat[y][x] == FEAT_PERM_OUTER) continue;
+			if (cave_feat(c, y, x) == FEAT_PERM_SOLID) continue;
+			if (cave_feat(c, y, x) == FEAT_PERM_OUTER) continue;
 
 			/* Hack -- Avoid outer/solid granite walls */
-			if (c->feat[y][x] == FEAT_WALL_OUTER) continue;
-			if (c->feat[y][x] == FEAT_WALL_SOLID) continue;
+			if (cave_feat(c, y, x) == FEAT_WALL_OUTER) continue;
+			if (cave_feat(c, y, x) == FEAT_WALL_SOLID) continue;
 
 			/* Accept this location */
 			row1 = tmp_row;
@@ -2353,16 +2485,16 @@ static void build_tunnel(struct cave *c, int row1, int col1, int row2, int col2)
 			/* Forbid re-entry near this piercing */
 			for (y = row1 - 1; y <= row1 + 1; y++)
 				for (x = col1 - 1; x <= col1 + 1; x++)
-					if (c->feat[y][x] == FEAT_WALL_OUTER)
+					if (cave_feat(c, y, x) == FEAT_WALL_OUTER)
 						cave_set_feat(c, y, x, FEAT_WALL_SOLID);
 
-		} else if (c->info[tmp_row][tmp_col] & (CAVE_ROOM)) {
+		} else if (cave_info(c, tmp_row, tmp_col) & (CAVE_ROOM)) {
 			/* Travel quickly through rooms */
 			/* Accept the location */
 			row1 = tmp_row;
 			col1 = tmp_col;
 
-		} else if (c->feat[tmp_row][tmp_col] >= FEAT_WALL_EXTRA) {
+		} else if (cave_feat(c, tmp_row, tmp_col) >= FEAT_WALL_EXTRA) {
 			/* Tunnel through all other walls */
 			/* Accept this location */
 			row1 = tmp_row;
@@ -2519,6 +2651,7 @@ static bool room_build(struct cave *c, int by0, int bx0, struct room_profile pro
 	int allocated;
 	int y, x;
 	int by, bx;
+	bool built;
 
 	/* Enforce the room profile's minimum depth */
 	if (c->depth < profile.level) return FALSE;
@@ -2547,7 +2680,10 @@ static bool room_build(struct cave *c, int by0, int bx0, struct room_profile pro
 	x = ((bx1 + bx2 + 1) * BLOCK_WID) / 2;
 
 	/* Try to build a room */
-	if (!profile.builder(c, y, x)) return FALSE;
+	if (gen_room_hook) gen_room_hook(c, &profile, FALSE, FALSE);
+	built = profile.builder(c, y, x);
+	if (gen_room_hook) gen_room_hook(c, &profile, TRUE, built);
+	if (!built) return FALSE;
 
 	/* Save the room location */
 	if (dun->cent_n < CENT_MAX) {
@@ -2579,8 +2715,7 @@ static bool room_build(struct cave *c, int by0, int bx0, struct room_profile pro
 static void set_cave_dimensions(struct cave *c, int h, int w)
 {
 	int i, n = h * w;
-	c->height = h;
-	c->width = w;
+	cave_resize(c, h, w);
 	if (cave_squares != NULL) FREE(cave_squares);
 	cave_squares = C_ZNEW(n, int);
 	for (i = 0; i < n; i++) cave_squares[i] = i;
@@ -2627,7 +2762,7 @@ static bool default_gen(struct cave *c, struct player *p) {
 	//ROOM_LOG("height=%d  width=%d  nrooms=%d", c->height, c->width, num_rooms);
 
 	/* Initially fill with basic granite */
-	fill_rectangle(c, 0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1, FEAT_WALL_EXTRA);
+	fill_rectangle(c, 0, 0, c->height - 1, c->width - 1, FEAT_WALL_EXTRA);
 
 	/* Actual maximum number of rooms on this level */
 	dun->row_rooms = c->height / BLOCK_HGT;
@@ -2703,7 +2838,7 @@ static bool default_gen(struct cave *c, struct player *p) {
 	}
 
 	/* Generate permanent walls around the edge of the dungeon */
-	draw_rectangle(c, 0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1, FEAT_PERM_SOLID);
+	draw_rectangle(c, 0, 0, c->height - 1, c->width - 1, FEAT_PERM_SOLID);
 
 	/* Hack -- Scramble the room order */
 	for (i = 0; i < dun->cent_n; i++) {
@@ -2922,7 +3057,7 @@ static bool labyrinth_gen(struct cave *c, struct player *p) {
 	set_cave_dimensions(c, h + 2, w + 2);
 
 	/* Fill whole level with perma-rock */
-	fill_rectangle(c, 0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1, FEAT_PERM_SOLID);
+	fill_rectangle(c, 0, 0, c->height - 1, c->width - 1, FEAT_PERM_SOLID);
 
 	/* Fill the labyrinth area with rock */
 	fill_rectangle(c, 1, 1, h, w, soft ? FEAT_WALL_SOLID : FEAT_PERM_SOLID);
@@ -2939,7 +3074,7 @@ static bool labyrinth_gen(struct cave *c, struct player *p) {
 			int k = lab_toi(y, x, w);
 			sets[k] = k;
 			cave_set_feat(c, y + 1, x + 1, FEAT_FLOOR);
-			if (lit) c->info[y + 1][x + 1] |= CAVE_GLOW;
+			if (lit) cave_info_on(c, y + 1, x + 1, CAVE_GLOW);
 		}
 	}
 
@@ -2968,7 +3103,7 @@ static bool labyrinth_gen(struct cave *c, struct player *p) {
 			int sa = sets[a];
 			int sb = sets[b];
 			cave_set_feat(c, y + 1, x + 1, FEAT_FLOOR);
-			if (lit) c->info[y + 1][x + 1] |= CAVE_GLOW;
+			if (lit) cave_info_on(c, y + 1, x + 1, CAVE_GLOW);
 
 			for (k = 0; k < n; k++) {
 				if (sets[k] == sb) sets[k] = sa;
@@ -3062,8 +3197,8 @@ static void init_cavern(struct cave *c, struct player *p, int density) {
 	int count = (size * density) / 100;
 
 	/* Fill the edges with perma-rock, and rest with rock */
-	draw_rectangle(c, 0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1, FEAT_PERM_SOLID);
-	fill_rectangle(c, 1, 1, DUNGEON_HGT - 2, DUNGEON_WID - 2, FEAT_WALL_SOLID);
+	draw_rectangle(c, 0, 0, c->height - 1, c->width - 1, FEAT_PERM_SOLID);
+	fill_rectangle(c, 1, 1, c->height - 2, c->width - 2, FEAT_WALL_SOLID);
 
 	while (count > 0) {
 		int y = randint1(h - 2);
@@ -3076,52 +3211,35 @@ static void init_cavern(struct cave *c, struct player *p, int density) {
 }
 
 /**
- * Return the number of walls (0-8) adjacent to this square.
- */
-static int count_adj_walls(struct cave *c, int y, int x) {
-	int yd, xd;
-	int count = 0;
-
-	for (yd = -1; yd <= 1; yd++) {
-		for (xd = -1; xd <= 1; xd++) {
-			if (yd == 0 && xd == 0) continue;
-			if (cave_isfloor(c, y + yd, x + xd)) continue;
-			count++;
-		}
-	}
-
-	return count;
-}
-
-/**
- * Run a single pass of the cellular automata rules (4,5) on the dungeon.
+ * Run the cellular automata rules (4,5) on the dungeon a number of times.
+ *
+ * The floor is copied into a bitboard, so each pass counts the neighbours of
+ * 64 grids at once: a grid with more than five adjacent walls (fewer than
+ * three floors) becomes wall, and one with fewer than four (more than four
+ * floors) becomes floor.
  */
-static void mutate_cavern(struct cave *c) {
-	int y, x;
+static void mutate_cavern(struct cave *c, int times) {
+	int y, x, i;
 	int h = c->height;
 	int w = c->width;
 
-	int *temp = C_ZNEW(h * w, int);
+	struct bitboard *floor = bitboard_new(h, w);
 
-	for (y = 1; y < h - 1; y++) {
-		for (x = 1; x < w - 1; x++) {
-			int count = count_adj_walls(c, y, x);
-			if (count > 5)
-				temp[y * w + x] = FEAT_WALL_SOLID;
-			else if (count < 4)
-				temp[y * w + x] = FEAT_FLOOR;
-			else
-				temp[y * w + x] = cave->feat[y][x];
-		}
-	}
+	for (y = 0; y < h; y++)
+		for (x = 0; x < w; x++)
+			if (cave_isfloor(c, y, x)) bitboard_put(floor, y, x, TRUE);
+
+	for (i = 0; i < times; i++)
+		bitboard_smooth(floor, 3, 4);
 
 	for (y = 1; y < h - 1; y++) {
 		for (x = 1; x < w - 1; x++) {
-			cave_set_feat(c, y, x, temp[y * w + x]);
+			cave_set_feat(c, y, x, bitboard_get(floor, y, x) ?
+				FEAT_FLOOR : FEAT_WALL_SOLID);
 		}
 	}
 
-	FREE(temp);
+	bitboard_free(floor);
 }
 
 /**
@@ -3157,73 +3275,90 @@ static void glow_point(struct cave *c, int y, int x) {
 	int i, j;
 	for (i = -1; i <= -1; i++)
 		for (j = -1; j <= -1; j++)
-			c->info[y + i][x + j] |= CAVE_GLOW;
+			cave_info_on(c, y + i, x + j, CAVE_GLOW);
 }
 #endif
 
 /**
- * Color a particular point, and all adjacent points.
+ * Find the representative of a point in the union-find forest.
  */
-static void build_color_point(struct cave *c, int colors[], int counts[], int y, int x, int color, bool diagonal) {
-	int h = c->height;
-	int w = c->width;
-	int size = h * w;
-	struct queue *queue = q_new(size);
-
-	int dslimit = diagonal ? 8 : 4;
-
-	int *added = C_ZNEW(size, int);
-	array_filler(added, 0, size);
-
-	q_push_int(queue, lab_toi(y, x, w));
-
-	counts[color] = 0;
-
-	while (q_len(queue) > 0) {
-		int i, y2, x2;
-		int n2 = q_pop_int(queue);
-
-		lab_toyx(n2, w, &y2, &x2);
-
-		if (ignore_point(cave, colors, y2, x2)) continue;
-
-		colors[n2] = color;
-		counts[color]++;
-
-		/*if (lit) glow_point(c, y2, x2);*/
-
-		for (i = 0; i < dslimit; i++) {
-			int y3 = y2 + yds[i];
-			int x3 = x2 + xds[i];
-			int n3 = lab_toi(y3, x3, w);
-			if (ignore_point(cave, colors, y3, x3)) continue;
-			if (added[n3]) continue;
-
-			q_push_int(queue, n3);
-			added[n3] = 1;
-		}
+static int find_root(int parent[], int n) {
+	while (parent[n] != n) {
+		parent[n] = parent[parent[n]];
+		n = parent[n];
 	}
+	return n;
+}
 
-	FREE(added);
-	q_free(queue);
+/**
+ * Join the sets of two points in the union-find forest.
+ */
+static void join_roots(int parent[], int n1, int n2) {
+	int r1 = find_root(parent, n1);
+	int r2 = find_root(parent, n2);
+
+	if (r1 < r2) parent[r2] = r1;
+	else if (r2 < r1) parent[r1] = r2;
 }
 
 /**
  * Create a color for each "NESW contiguous" region of the dungeon.
  */
 static void build_colors(struct cave *c, int colors[], int counts[], bool diagonal) {
-	int y, x;
+	int y, x, i;
 	int h = c->height;
 	int w = c->width;
+	int size = h * w;
 	int color = 1;
 
+	/* Earlier neighbours in scan order: west, north, then the diagonals */
+	int dslimit = diagonal ? 4 : 2;
+	int ys[] = {0, -1, -1, -1};
+	int xs[] = {-1, 0, -1, 1};
+
+	int *parent = C_ZNEW(size, int);
+	int *root_color = C_ZNEW(size, int);
+
+	/* Join each point to the points before it which it touches */
 	for (y = 0; y < h; y++) {
 		for (x = 0; x < w; x++) {
-			if (ignore_point(cave, colors, y, x)) continue;
-			build_color_point(cave, colors, counts, y, x, color, diagonal);
+			int n = lab_toi(y, x, w);
+
+			if (ignore_point(c, colors, y, x)) {
+				parent[n] = -1;
+				continue;
+			}
+			parent[n] = n;
+
+			for (i = 0; i < dslimit; i++) {
+				int y2 = y + ys[i];
+				int x2 = x + xs[i];
+				int n2 = lab_toi(y2, x2, w);
+
+				if (y2 < 0 || x2 < 0 || x2 >= w) continue;
+				if (parent[n2] < 0) continue;
+				join_roots(parent, n, n2);
+			}
+		}
+	}
+
+	/* Number the regions in the order they are first reached */
+	for (i = 0; i < size; i++) {
+		int root;
+
+		if (parent[i] < 0) continue;
+		root = find_root(parent, i);
+		if (!root_color[root]) {
+			root_color[root] = color;
+			counts[color] = 0;
 			color++;
 		}
+		colors[i] = root_color[root];
+		counts[colors[i]]++;
 	}
+
+	FREE(parent);
+	FREE(root_color);
 }
 
 /**
@@ -3289,8 +3424,13 @@ static void fix_colors(int colors[], int counts[], int from, int to, int size) {
 
 /**
  * Create a tunnel connecting a region to one of its nearest neighbors.
+ *
+ * previous[] records which square each square was reached from; it is only
+ * valid for squares whose seen[] entry is pass, so that the arrays can be
+ * shared between calls without being cleared.
  */
-static void join_region(struct cave *c, int colors[], int counts[], int color) {
+static void join_region(struct cave *c, int colors[], int counts[], int color,
+		int previous[], int seen[], int pass) {
 	int i;
 	int h = c->height;
 	int w = c->width;
@@ -3299,17 +3439,12 @@ static void join_region(struct cave *c, int colors[], int counts[], int color) {
 	/* Allocate a processing queue */
 	struct queue *queue = q_new(size);
 
-	/* Allocate an array to keep track of handled squares, and which square
-	 * we reached them from.
-	 */
-	int *previous = C_ZNEW(size, int);
-	array_filler(previous, -1, size);
-
 	/* Push all squares of the given color onto the queue */
 	for (i = 0; i < size; i++) {
 		if (colors[i] == color) {
 			q_push_int(queue, i);
 			previous[i] = i;
+			seen[i] = pass;
 		}
 	}
 
@@ -3356,15 +3491,15 @@ static void join_region(struct cave *c, int colors[], int counts[], int color) {
 
 			/* If the cell hasn't already been procssed, add it to the queue */
 			n2 = lab_toi(y, x, w);
-			if (previous[n2] >= 0) continue;
+			if (seen[n2] == pass) continue;
 			q_push_int(queue, n2);
 			previous[n2] = n;
+			seen[n2] = pass;
 		}
 	}
 
 	/* Free the memory we've allocated */
 	q_free(queue);
-	FREE(previous);
 }
 
 
@@ -3376,15 +3511,22 @@ static void join_regions(struct cave *c, int colors[], int counts[]) {
 	int w = c->width;
 	int size = h * w;
 	int num = count_colors(counts, size);
+	int pass = 0;
+
+	int *previous = C_ZNEW(size, int);
+	int *seen = C_ZNEW(size, int);
 
 	/* While we have multiple colors (i.e. disconnected regions), join one of
 	 * the regions to another one.
 	 */
 	while (num > 1) {
 		int color = first_color(counts, size);
-		join_region(c, colors, counts, color);
+		join_region(c, colors, counts, color, previous, seen, ++pass);
 		num--;
 	}
+
+	FREE(previous);
+	FREE(seen);
 }
 
 
@@ -3459,7 +3601,7 @@ bool cavern_gen(struct cave *c, struct player *p) {
 		for (tries = 0; tries < MAX_CAVERN_TRIES; tries++) {
 			/* Build a random cavern and mutate it a number of times */
 			init_cavern(c, p, density);
-			for (i = 0; i < times; i++) mutate_cavern(c);
+			mutate_cavern(c, times);
 
 			/* If there are enough open squares then we're done */
 			openc = open_count(c);
@@ -3632,7 +3774,7 @@ static bool town_gen(struct cave *c, struct player *p) {
 	 */
 
 	/* Start with solid walls, and then create some floor in the middle */
-	fill_rectangle(c, 0, 0, DUNGEON_HGT - 1, DUNGEON_WID - 1, FEAT_PERM_SOLID);
+	fill_rectangle(c, 0, 0, c->height - 1, c->width - 1, FEAT_PERM_SOLID);
 	fill_rectangle(c, 1, 1, c->height -2, c->width - 2, FEAT_FLOOR);
 
 	/* Build stuff */
@@ -3658,25 +3800,29 @@ static void cave_clear(struct cave *c, struct player *p) {
 	wipe_o_list(c);
 	wipe_mon_list(c, p);
 
+	/* The player's view of the old level goes with it */
+	cave_view_reset(c);
+
 	/* Clear flags and flow information. */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-		for (x = 0; x < DUNGEON_WID; x++) {
+	cave_info_fill(c, 0, 0, c->height - 1, c->width - 1, 0xFF, FALSE);
+
+	for (y = 0; y < c->height; y++) {
+		for (x = 0; x < c->width; x++) {
 			/* Erase features */
-			c->feat[y][x] = 0;
+			cave_feat(c, y, x) = 0;
 
 			/* Erase flags */
-			c->info[y][x] = 0;
-			c->info2[y][x] = 0;
+			cave_info2(c, y, x) = 0;
 
 			/* Erase flow */
-			c->cost[y][x] = 0;
-			c->when[y][x] = 0;
+			cave_cost(c, y, x) = 0;
+			cave_when(c, y, x) = 0;
 
 			/* Erase monsters/player */
-			c->m_idx[y][x] = 0;
+			cave_set_m_idx(c, y, x, 0);
 
 			/* Erase items */
-			c->o_idx[y][x] = 0;
+			cave_set_o_idx(c, y, x, 0);
 		}
 	}
 
@@ -3703,8 +3849,8 @@ static void place_feeling(struct cave *c)
 		for(j = 0; j < tries; j++){
 
 			/* Pick a random dungeon coordinate */
-			y = randint0(DUNGEON_HGT);
-			x = randint0(DUNGEON_WID);
+			y = randint0(c->height);
+			x = randint0(c->width);
 
 			/* Check to see if it is not a wall */
 			if (cave_iswall(c,y,x))
@@ -3715,7 +3861,7 @@ static void place_feeling(struct cave *c)
 				continue;
 
 			/* Set the cave square appropriately */
-			c->info2[y][x] |= CAVE2_FEEL;
+			cave_info2(c, y, x) |= CAVE2_FEEL;
 
 			break;
 
@@ -3796,11 +3942,11 @@ static void clear_dun_data(struct dun_data *d) {
 }
 
 /**
- * Generate a random level.
+ * Generate a random level from the current RNG stream.
  *
  * Confusingly, this function also generate the town level (level 0).
  */
-void cave_generate(struct cave *c, struct player *p) {
+static void cave_generate_aux(struct cave *c, struct player *p) {
 	const char *error = "no generation";
 	int tries = 0;
 
@@ -3814,6 +3960,7 @@ void cave_generate(struct cave *c, struct player *p) {
 
 		error = NULL;
 		cave_clear(c, p);
+		if (gen_restart_hook) gen_restart_hook(c);
 
 		/* Mark the dungeon as being unready (to avoid artifact loss, etc) */
 		character_dungeon = FALSE;
@@ -3823,8 +3970,12 @@ void cave_generate(struct cave *c, struct player *p) {
 		clear_dun_data(dun);
 
 		if (p->depth == 0) {
+			bool ok;
+
 			dun->profile = &town_profile;
-			dun->profile->builder(c, p);
+			if (gen_profile_hook) gen_profile_hook(c, dun->profile, FALSE, FALSE);
+			ok = dun->profile->builder(c, p);
+			if (gen_profile_hook) gen_profile_hook(c, dun->profile, TRUE, ok);
 		} else {
 			int perc = randint0(100);
 			int last = NUM_CAVE_PROFILES - 1;
@@ -3836,7 +3987,9 @@ void cave_generate(struct cave *c, struct player *p) {
 				profile = dun->profile = &cave_profiles[i];
 				if (i < last && profile->cutoff < perc) continue;
 
+				if (gen_profile_hook) gen_profile_hook(c, profile, FALSE, FALSE);
 				ok = dun->profile->builder(c, p);
+				if (gen_profile_hook) gen_profile_hook(c, profile, TRUE, ok);
 				if (ok) break;
 			}
 		}
@@ -3883,3 +4036,327 @@ void cave_generate(struct cave *c, struct player *p) {
 
 	c->created_at = turn;
 }
+
+
+/*** Level seeds ***/
+
+/**
+ * Every level is generated from its own 64-bit seed, kept in cave->seed, on
+ * a copy of the RNG which is thrown away afterwards. The same seed and depth
+ * give the same level, provided the rest of the game is the same: which
+ * artifacts and uniques already exist, and which stairs the player arrives
+ * by.
+ */
+
+/**
+ * Draw a fresh level seed from the main RNG.
+ */
+static u64b random_seed(void)
+{
+	u64b seed = 0;
+	int i;
+
+	for (i = 0; i < 4; i++)
+		seed = (seed << 16) | randint0(0x10000);
+
+	return seed;
+}
+
+/**
+ * Build a level on its own seed.
+ */
+static void cave_generate_seeded(struct cave *c, struct player *p, u64b seed)
+{
+	rand_state save;
+
+	Rand_state_save(&save);
+	Rand_quick = FALSE;
+	Rand_state_init64(seed);
+
+	cave_generate_aux(c, p);
+	c->seed = seed;
+
+	Rand_state_restore(&save);
+}
+
+
+/*** Speculative generation of the next levels ***/
+
+/**
+ * With the pregen_levels option, the levels above and below are built
+ * while the player is deciding what to do, and one of them is swapped in
+ * when the player leaves. Each level is generated from its own seed, taken
+ * from the level being left, so that the same level results whether or not
+ * it was built in advance, and the main RNG stream is left alone.
+ */
+struct pregen_level {
+	struct cave *c;
+	int depth;			/* -1 if unused */
+	s32b parent;		/* created_at of the level it was built from */
+	bool up_stair;		/* player->create_up_stair it was built for */
+	bool down_stair;	/* player->create_down_stair it was built for */
+	int py, px;
+	struct object *objects;	/* o_list as generated */
+	s16b o_max, o_cnt;
+	s16b num_repro;
+};
+
+static struct pregen_level pregen[2] = {
+	{ NULL, -1 },
+	{ NULL, -1 }
+};
+
+/**
+ * The seed for the level at depth, when leaving the level made at parent.
+ */
+static u64b level_seed(int depth, s32b parent)
+{
+	u64b h = ((u64b)seed_flavor << 32) ^ ((u64b)depth * 0x9E3779B97F4A7C15ULL)
+		^ ((u64b)(u32b)parent * 0xBF58476D1CE4E5B9ULL);
+
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+	return h;
+}
+
+/**
+ * Forget the levels built in advance.
+ */
+static void pregen_forget(void)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(pregen); i++) {
+		struct pregen_level *l = &pregen[i];
+
+		l->depth = -1;
+		FREE(l->objects);
+
+		/* Leave nothing for cave_clear() to find later */
+		if (l->c) {
+			l->c->mon_max = 1;
+			l->c->mon_cnt = 0;
+		}
+	}
+}
+
+/**
+ * Build the level at depth into l, as if the player had just left the
+ * current level for it, and then put everything back as it was.
+ */
+static void pregen_build(struct pregen_level *l, struct player *p, int depth,
+	bool up_stair, bool down_stair)
+{
+	struct player p_save = *p;
+	struct cave *cave_save = cave;
+	struct target_state target;
+	struct object *objects;
+	s16b o_max_save = o_max, o_cnt_save = o_cnt, num_repro_save = num_repro;
+	s16b *cur_num;
+	bool *created;
+	monster_lore *lore;
+	int i;
+
+	/* Save everything generation touches outside the cave */
+	objects = C_ZNEW(z_info->o_max, struct object);
+	memcpy(objects, object_byid(0), z_info->o_max * sizeof(*objects));
+	cur_num = C_ZNEW(z_info->r_max, s16b);
+	for (i = 0; i < z_info->r_max; i++)
+		cur_num[i] = r_info[i].cur_num;
+	created = C_ZNEW(z_info->a_max, bool);
+	for (i = 0; i < z_info->a_max; i++)
+		created[i] = a_info[i].created;
+	lore = C_ZNEW(z_info->r_max, monster_lore);
+	memcpy(lore, l_list, z_info->r_max * sizeof(*lore));
+	target_save(&target);
+
+	/* Let go of the current level, as leaving it would */
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		monster_type *m_ptr = cave_monster(cave, i);
+		if (m_ptr->r_idx) r_info[m_ptr->r_idx].cur_num--;
+	}
+	for (i = 1; i < o_max; i++) {
+		object_type *o_ptr = object_byid(i);
+		if (o_ptr->kind && o_ptr->artifact && !object_was_sensed(o_ptr) &&
+				(!OPT(birth_no_preserve) || o_ptr->held_m_idx))
+			o_ptr->artifact->created = FALSE;
+	}
+	C_WIPE(object_byid(0), z_info->o_max, struct object);
+	o_max = 1;
+	o_cnt = 0;
+
+	/* Build the level */
+	if (!l->c) l->c = cave_new();
+	cave = l->c;
+	p->depth = depth;
+	p->create_up_stair = up_stair;
+	p->create_down_stair = down_stair;
+
+	cave_generate_seeded(cave, p, level_seed(depth, cave_save->created_at));
+
+	l->depth = depth;
+	l->parent = cave_save->created_at;
+	l->up_stair = up_stair;
+	l->down_stair = down_stair;
+	l->py = p->py;
+	l->px = p->px;
+	l->objects = C_ZNEW(z_info->o_max, struct object);
+	memcpy(l->objects, object_byid(0), z_info->o_max * sizeof(*objects));
+	l->o_max = o_max;
+	l->o_cnt = o_cnt;
+	l->num_repro = num_repro;
+
+	/* Put everything back */
+	cave = cave_save;
+	*p = p_save;
+	memcpy(object_byid(0), objects, z_info->o_max * sizeof(*objects));
+	o_max = o_max_save;
+	o_cnt = o_cnt_save;
+	num_repro = num_repro_save;
+	for (i = 0; i < z_info->r_max; i++)
+		r_info[i].cur_num = cur_num[i];
+	for (i = 0; i < z_info->a_max; i++)
+		a_info[i].created = created[i];
+	memcpy(l_list, lore, z_info->r_max * sizeof(*lore));
+	target_restore(&target);
+	character_dungeon = TRUE;
+
+	mem_free(objects);
+	mem_free(cur_num);
+	mem_free(created);
+	mem_free(lore);
+
+	/* Anything drawn while building belonged to the other level */
+	p->redraw |= (PR_MAP);
+}
+
+/**
+ * Swap a level built in advance into c, if there is one which matches
+ * where the player is going and is still consistent with the game, such
+ * as not holding a unique which has since been killed. The current level
+ * is cleared either way.
+ */
+static bool pregen_take(struct cave *c, struct player *p)
+{
+	struct pregen_level *l = NULL;
+	struct cave tmp;
+	size_t i;
+	int j;
+
+	for (i = 0; i < N_ELEMENTS(pregen); i++) {
+		if (pregen[i].depth == p->depth && pregen[i].parent == c->created_at
+				&& pregen[i].up_stair == p->create_up_stair
+				&& pregen[i].down_stair == p->create_down_stair)
+			l = &pregen[i];
+	}
+	if (!l) return FALSE;
+
+	cave_clear(c, p);
+
+	for (j = 1; j < cave_monster_max(l->c); j++) {
+		monster_type *m_ptr = cave_monster(l->c, j);
+		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+
+		if (m_ptr->r_idx && rf_has(r_ptr->flags, RF_UNIQUE) &&
+				r_ptr->cur_num >= r_ptr->max_num)
+			return FALSE;
+	}
+	for (j = 1; j < l->o_max; j++) {
+		if (l->objects[j].kind && l->objects[j].artifact &&
+				l->objects[j].artifact->created)
+			return FALSE;
+	}
+
+	/* Take over its monsters and objects */
+	for (j = 1; j < cave_monster_max(l->c); j++) {
+		monster_type *m_ptr = cave_monster(l->c, j);
+		if (m_ptr->r_idx) r_info[m_ptr->r_idx].cur_num++;
+	}
+	memcpy(object_byid(0), l->objects,
+		z_info->o_max * sizeof(*l->objects));
+	o_max = l->o_max;
+	o_cnt = l->o_cnt;
+	num_repro = l->num_repro;
+	for (j = 1; j < o_max; j++) {
+		object_type *o_ptr = object_byid(j);
+		if (o_ptr->kind && o_ptr->artifact)
+			o_ptr->artifact->created = TRUE;
+	}
+
+	/* Swap the grids in */
+	tmp = *c;
+	*c = *l->c;
+	*l->c = tmp;
+
+	p->py = l->py;
+	p->px = l->px;
+	p->create_up_stair = FALSE;
+	p->create_down_stair = FALSE;
+
+	character_dungeon = TRUE;
+	c->created_at = turn;
+
+	return TRUE;
+}
+
+/**
+ * Generate a level for the player's depth, using a level built in advance
+ * if there is a suitable one.
+ */
+void cave_generate(struct cave *c, struct player *p) {
+	if (OPT(pregen_levels) && c == cave) {
+		if (!pregen_take(c, p))
+			cave_generate_seeded(c, p, level_seed(p->depth, c->created_at));
+	} else {
+		cave_generate_seeded(c, p, random_seed());
+	}
+
+	pregen_forget();
+}
+
+/**
+ * Generate the level for the player's depth from a given seed, such as the
+ * cave->seed of an earlier level, to get that level back.
+ */
+void cave_generate_from_seed(struct cave *c, struct player *p, u64b seed) {
+	cave_generate_seeded(c, p, seed);
+	pregen_forget();
+}
+
+/**
+ * Spend some spare time building the levels the player could go to next:
+ * one level per call, and none if the player is already waiting to act.
+ */
+void cave_pregenerate(struct player *p)
+{
+	ui_event e;
+
+	/* Don't give the game away */
+	if (OPT(cheat_room) || OPT(cheat_hear)) return;
+
+	/* Only while the player is thinking */
+	if (Term_inkey(&e, FALSE, FALSE) == 0) return;
+
+	/* The town is quick to make and depends on the time of day */
+	if (pregen[0].depth < 0 && p->depth + 1 < MAX_DEPTH)
+		pregen_build(&pregen[0], p, p->depth + 1, TRUE, FALSE);
+	else if (pregen[1].depth < 0 && p->depth > 1)
+		pregen_build(&pregen[1], p, p->depth - 1, FALSE, TRUE);
+}
+
+/**
+ * Free the spare caves.
+ */
+void cave_pregen_free(void)
+{
+	size_t i;
+
+	pregen_forget();
+	for (i = 0; i < N_ELEMENTS(pregen); i++) {
+		if (pregen[i].c) cave_free(pregen[i].c);
+		pregen[i].c = NULL;
+	}
+}
@@ -15,6 +15,10 @@ void place_random_door(struct cave *c, int y, int x);
 extern struct room_template *random_room_template(int typ);
 extern struct vault *random_vault(int typ);
 
+struct stamp *stamp_compile_vault(const struct vault *v);
+struct stamp *stamp_compile_room(const struct room_template *t);
+void stamp_free(struct stamp *s);
+
 struct tunnel_profile {
 	const char *name;
     int rnd; /* % chance of choosing random direction */
@@ -107,4 +111,22 @@ typedef struct pit_profile {
 } pit_profile;
 
 
+/*
+ * Optional hooks for watching level generation (used by the stats and
+ * bench modes). gen_restart_hook is called at the start of each generation
+ * attempt, so anything recorded by the other hooks during a failed attempt
+ * can be thrown away.
+ *
+ * gen_profile_hook and gen_room_hook are called just before (done FALSE)
+ * and just after (done TRUE) each cave or room builder runs; built is only
+ * meaningful once the builder is done.
+ */
+extern void (*gen_restart_hook)(struct cave *c);
+extern void (*gen_vault_hook)(struct cave *c, const struct vault *v_ptr);
+extern void (*gen_pit_hook)(struct cave *c, const pit_profile *pit);
+extern void (*gen_profile_hook)(struct cave *c,
+	const struct cave_profile *profile, bool done, bool built);
+extern void (*gen_room_hook)(struct cave *c,
+	const struct room_profile *profile, bool done, bool built);
+
 #endif /* !GENERATE_H */
@@ -27,12 +27,14 @@
 #include "keymap.h"
 #include "init.h"
 #include "monster/init.h"
+#include "monster/mon-make.h"
 #include "monster/mon-msg.h"
 #include "monster/mon-util.h"
 #include "object/slays.h"
 #include "object/tvalsval.h"
 #include "option.h"
 #include "parser.h"
+#include "pathfind.h"
 #include "prefs.h"
 #include "randname.h"
 #include "squelch.h"
@@ -2330,8 +2332,15 @@ static errr run_parse_v(struct parser *p) {
 }
 
 static errr finish_parse_v(struct parser *p) {
+	struct vault *v;
+
 	vaults = parser_priv(p);
 	parser_destroy(p);
+
+	/* Compile each vault's text for the generator */
+	for (v = vaults; v; v = v->next)
+		v->stamp = stamp_compile_vault(v);
+
 	return 0;
 }
 
@@ -2342,6 +2351,7 @@ static void cleanup_v(void)
 		next = v->next;
 		mem_free(v->name);
 		mem_free(v->text);
+		stamp_free(v->stamp);
 		mem_free(v);
 	}
 }
@@ -2404,8 +2414,15 @@ static errr run_parse_room(struct parser *p) {
 }
 
 static errr finish_parse_room(struct parser *p) {
+	struct room_template *t;
+
 	room_templates = parser_priv(p);
 	parser_destroy(p);
+
+	/* Compile each template's text for the generator */
+	for (t = room_templates; t; t = t->next)
+		t->stamp = stamp_compile_room(t);
+
 	return 0;
 }
 
@@ -2416,6 +2433,7 @@ static void cleanup_room(void)
 		next = t->next;
 		mem_free(t->name);
 		mem_free(t->text);
+		stamp_free(t->stamp);
 		mem_free(t);
 	}
 }
@@ -3183,6 +3201,12 @@ static errr init_other(void)
 	/* Used by "update_view()" */
 	(void)vinfo_init();
 
+	/* Used by "los()" */
+	(void)los_init();
+
+	/* Used by "project_path()" */
+	(void)project_path_init();
+
 
 	/*** Prepare entity arrays ***/
 
@@ -3549,6 +3573,8 @@ void cleanup_angband(void)
 	/* Free the allocation tables */
 	free_obj_alloc();
 	FREE(alloc_race_table);
+	free_mon_alloc();
+	free_travel_map();
 
 	event_remove_all_handlers();
 
@@ -3569,6 +3595,7 @@ void cleanup_angband(void)
 	FREE(temp_g);
 
 	cave_free(cave);
+	cave_pregen_free();
 
 	/* Free the stacked monster messages */
 	FREE(mon_msg);
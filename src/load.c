@@ -1951,6 +1951,55 @@ int rd_misc_2(void)
 	return 0;
 }
 
+
+int rd_misc_3(void)
+{
+	byte tmp8u;
+	u16b tmp16u;
+	u32b seed_hi, seed_lo;
+	
+	/* Read the randart version */
+	strip_bytes(4);
+
+	/* Read the randart seed */
+	rd_u32b(&seed_randart);
+
+	/* Skip the flags */
+	strip_bytes(12);
+
+
+	/* Hack -- the two "special seeds" */
+	rd_u32b(&seed_flavor);
+	rd_u32b(&seed_town);
+
+
+	/* Special stuff */
+	rd_u16b(&p_ptr->panic_save);
+	rd_u16b(&p_ptr->total_winner);
+	rd_u16b(&p_ptr->noscore);
+
+
+	/* Read "death" */
+	rd_byte(&tmp8u);
+	p_ptr->is_dead = tmp8u;
+
+	/* Read "feeling" */
+	rd_byte(&tmp8u);
+	cave->feeling = tmp8u;
+	rd_u16b(&tmp16u);
+	cave->feeling_squares = tmp16u;
+
+	rd_s32b(&cave->created_at);
+	rd_u32b(&seed_hi);
+	rd_u32b(&seed_lo);
+	cave->seed = ((u64b)seed_hi << 32) | seed_lo;
+
+	/* Current turn */
+	rd_s32b(&turn);
+
+	return 0;
+}
+
 int rd_player_hp(void)
 {
 	int i;
@@ -2456,9 +2505,9 @@ int rd_stores_1(void) { return rd_stores(rd_item_1); } /* remove post-3.3 */
  * The monsters/objects must be loaded in the same order
  * that they were stored, since the actual indexes matter.
  *
- * Note that the size of the dungeon is now hard-coded to
- * DUNGEON_HGT by DUNGEON_WID, and any dungeon with another
- * size will be silently discarded by this routine.
+ * The grids are stored as a rows by cols block, which is DUNGEON_HGT by
+ * DUNGEON_WID in older savefiles whatever the size of the level; grids
+ * which lie outside the level itself are skipped.
  *
  * Note that dungeon objects, including objects held by monsters, are
  * placed directly into the dungeon, using "object_copy()", which will
@@ -2468,13 +2517,14 @@ int rd_stores_1(void) { return rd_stores(rd_item_1); } /* remove post-3.3 */
  * After loading the monsters, the objects being held by monsters are
  * linked directly into those monsters.
  */
-int rd_dungeon(void)
+static int rd_dungeon_aux(bool full_size)
 {
 	int i, y, x;
 
 	s16b depth;
 	s16b py, px;
 	s16b ymax, xmax;
+	int rows, cols;
 
 	byte count;
 	byte tmp8u;
@@ -2504,22 +2554,32 @@ int rd_dungeon(void)
 		return (0);
 	}
 
-	cave->width = xmax;
-	cave->height = ymax;
+	/* Ignore illegal dungeons */
+	if ((ymax <= 0) || (ymax > 256) || (xmax <= 0) || (xmax > 256) ||
+	    (full_size && ((ymax > DUNGEON_HGT) || (xmax > DUNGEON_WID))))
+	{
+		note(format("Ignoring illegal dungeon size (%d,%d)", ymax, xmax));
+		return (-1);
+	}
 
 	/* Ignore illegal dungeons */
-	if ((px < 0) || (px >= DUNGEON_WID) ||
-	    (py < 0) || (py >= DUNGEON_HGT))
+	if ((px < 0) || (px >= xmax) ||
+	    (py < 0) || (py >= ymax))
 	{
 		note(format("Ignoring illegal player location (%d,%d).", py, px));
 		return (1);
 	}
 
+	/* Make room for the level */
+	cave_resize(cave, ymax, xmax);
+	rows = full_size ? DUNGEON_HGT : ymax;
+	cols = full_size ? DUNGEON_WID : xmax;
+
 
 	/*** Run length decoding ***/
 
 	/* Load the dungeon data */
-	for (x = y = 0; y < DUNGEON_HGT; )
+	for (x = y = 0; y < rows; )
 	{
 		/* Grab RLE info */
 		rd_byte(&count);
@@ -2529,22 +2589,23 @@ int rd_dungeon(void)
 		for (i = count; i > 0; i--)
 		{
 			/* Extract "info" */
-			cave->info[y][x] = tmp8u;
+			if (y < ymax && x < xmax)
+				cave_info_set(cave, y, x, tmp8u);
 
 			/* Advance/Wrap */
-			if (++x >= DUNGEON_WID)
+			if (++x >= cols)
 			{
 				/* Wrap */
 				x = 0;
 
 				/* Advance/Wrap */
-				if (++y >= DUNGEON_HGT) break;
+				if (++y >= rows) break;
 			}
 		}
 	}
 
 	/* Load the dungeon data */
-	for (x = y = 0; y < DUNGEON_HGT; )
+	for (x = y = 0; y < rows; )
 	{
 		/* Grab RLE info */
 		rd_byte(&count);
@@ -2554,16 +2615,17 @@ int rd_dungeon(void)
 		for (i = count; i > 0; i--)
 		{
 			/* Extract "info" */
-			cave->info2[y][x] = tmp8u;
+			if (y < ymax && x < xmax)
+				cave_info2(cave, y, x) = tmp8u;
 
 			/* Advance/Wrap */
-			if (++x >= DUNGEON_WID)
+			if (++x >= cols)
 			{
 				/* Wrap */
 				x = 0;
 
 				/* Advance/Wrap */
-				if (++y >= DUNGEON_HGT) break;
+				if (++y >= rows) break;
 			}
 		}
 	}
@@ -2572,7 +2634,7 @@ int rd_dungeon(void)
 	/*** Run length decoding ***/
 
 	/* Load the dungeon data */
-	for (x = y = 0; y < DUNGEON_HGT; )
+	for (x = y = 0; y < rows; )
 	{
 		/* Grab RLE info */
 		rd_byte(&count);
@@ -2582,16 +2644,17 @@ int rd_dungeon(void)
 		for (i = count; i > 0; i--)
 		{
 			/* Extract "feat" */
-			cave_set_feat(cave, y, x, tmp8u);
+			if (y < ymax && x < xmax)
+				cave_set_feat(cave, y, x, tmp8u);
 
 			/* Advance/Wrap */
-			if (++x >= DUNGEON_WID)
+			if (++x >= cols)
 			{
 				/* Wrap */
 				x = 0;
 
 				/* Advance/Wrap */
-				if (++y >= DUNGEON_HGT) break;
+				if (++y >= rows) break;
 			}
 		}
 	}
@@ -2620,6 +2683,9 @@ int rd_dungeon(void)
 	return 0;
 }
 
+int rd_dungeon_2(void) { return rd_dungeon_aux(FALSE); }
+int rd_dungeon_1(void) { return rd_dungeon_aux(TRUE); }
+
 /* Read the floor object list */
 static int rd_objects(rd_item_t rd_item_version)
 {
@@ -2688,10 +2754,10 @@ static int rd_objects(rd_item_t rd_item_version)
 			/* ToDo: Verify coordinates */
 
 			/* Link the object to the pile */
-			o_ptr->next_o_idx = cave->o_idx[y][x];
+			o_ptr->next_o_idx = cave_o_idx(cave, y, x);
 
 			/* Link the floor to the object */
-			cave->o_idx[y][x] = o_idx;
+			cave_set_o_idx(cave, y, x, o_idx);
 		}
 	}
 
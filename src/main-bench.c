@@ -0,0 +1,782 @@
+/*
+ * File: main-bench.c
+ * Purpose: Pseudo-UI for benchmarking level generation (borrows heavily
+ * from main-stats.c)
+ *
+ * Copyright (c) 2011 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_BENCH
+
+#include "birth.h"
+#include "buildid.h"
+#include "generate.h"
+#include "init.h"
+#include "main.h"
+#include "monster/monster.h"
+#include <time.h>
+#include <sys/resource.h>
+
+#define BENCH_MAX_NAMES		32
+#define BENCH_DEFAULT_SEED	42
+#define BENCH_LOS_STEP		10
+
+/*
+ * Times and counts for one named cave profile or room builder.
+ */
+struct bench_timer {
+	const char *name;
+	u32b calls;		/* builder calls */
+	u32b built;		/* calls which succeeded */
+	u32b levels;	/* finished levels built by this profile */
+	clock_t time;	/* total time in the builder */
+	clock_t start;	/* start of the current call */
+};
+
+/*
+ * Times for line of sight queries, each made by walking the line, from the
+ * table, and from a batched source.
+ */
+struct bench_los {
+	u32b queries;
+	u32b seen;		/* queries with line of sight */
+	u32b mismatches;	/* queries where the table or batch disagreed */
+	clock_t walk;
+	clock_t table;
+	clock_t batch;
+};
+
+/*
+ * Times for playing game turns on each level, once turn by turn and once
+ * passing over idle turns as the game does.
+ */
+struct bench_turns {
+	u32b levels;
+	u32b turns;		/* game turns played each way */
+	u32b steps;		/* calls to process_game_turn() when passing over */
+	u32b mismatches;	/* levels where the two ways ended up differently */
+	clock_t step;
+	clock_t skip;
+};
+
+/*
+ * Results for one depth.
+ */
+struct bench_depth {
+	u32b levels;
+	u32b tries;		/* passes through the cave_generate() loop */
+	clock_t time;
+};
+
+static u32b num_levels = 100;
+static u32b seed_base = BENCH_DEFAULT_SEED;
+static bool depths[MAX_DEPTH];
+static bool quiet = FALSE;
+static bool time_los = FALSE;
+static u32b num_turns = 0;
+static char json_path[1024];
+static int running_bench = 0;
+
+static struct bench_depth depth_data[MAX_DEPTH];
+static struct bench_timer profiles[BENCH_MAX_NAMES];
+static struct bench_timer rooms[BENCH_MAX_NAMES];
+static int num_profiles = 0;
+static int num_rooms = 0;
+static struct bench_los los_data;
+static struct bench_turns turns_data;
+
+/* The profile which built the current level, and its passes so far */
+static struct bench_timer *last_profile;
+static u32b level_tries;
+
+static struct bench_timer *bench_timer_find(struct bench_timer *list,
+	int *n, const char *name)
+{
+	int i;
+
+	for (i = 0; i < *n; i++)
+		if (streq(list[i].name, name)) return &list[i];
+
+	if (*n == BENCH_MAX_NAMES) quit("Too many builders to time!");
+
+	list[*n].name = name;
+	return &list[(*n)++];
+}
+
+static void bench_timer_update(struct bench_timer *t, bool done, bool built)
+{
+	if (!done) {
+		t->start = clock();
+		return;
+	}
+
+	t->time += clock() - t->start;
+	t->calls++;
+	if (built) t->built++;
+}
+
+/*
+ * Generation hooks
+ */
+static void bench_gen_restart(struct cave *c)
+{
+	level_tries++;
+	last_profile = NULL;
+}
+
+static void bench_gen_profile(struct cave *c,
+	const struct cave_profile *profile, bool done, bool built)
+{
+	struct bench_timer *t = bench_timer_find(profiles, &num_profiles,
+		profile->name);
+
+	bench_timer_update(t, done, built);
+	if (done && built) last_profile = t;
+}
+
+static void bench_gen_room(struct cave *c, const struct room_profile *profile,
+	bool done, bool built)
+{
+	bench_timer_update(bench_timer_find(rooms, &num_rooms, profile->name),
+		done, built);
+}
+
+/* A minimal character, copied from main-stats.c */
+static void bench_init_character(void)
+{
+	player_init(p_ptr);
+
+	OPT(birth_randarts) = FALSE;
+	OPT(birth_no_selling) = FALSE;
+	OPT(auto_more) = TRUE;
+
+	p_ptr->wizard = 1;
+	p_ptr->psex = 0;
+	p_ptr->race = races;
+	p_ptr->class = classes;
+	p_ptr->max_lev = p_ptr->lev = 1;
+	p_ptr->expfact = p_ptr->race->r_exp + p_ptr->class->c_exp;
+	p_ptr->hitdie = p_ptr->race->r_mhp + p_ptr->class->c_mhp;
+	p_ptr->mhp = p_ptr->chp = 2000;
+	p_ptr->player_hp[0] = p_ptr->hitdie;
+
+	Rand_quick = FALSE;
+	Rand_state_init(seed_base);
+	seed_flavor = randint0(0x10000000);
+	seed_town = randint0(0x10000000);
+
+	store_reset();
+	flavor_init();
+	p_ptr->playing = TRUE;
+	p_ptr->autosave = FALSE;
+}
+
+/**
+ * Time line of sight from every BENCH_LOS_STEPth open grid of the level to
+ * each open grid within LOS_RADIUS of it, three ways.
+ */
+static void bench_los_level(struct cave *c)
+{
+	struct bench_los *l = &los_data;
+	u32b seen[3] = { 0, 0, 0 };
+	int pass, y1, x1, y2, x2;
+
+	for (pass = 0; pass < 3; pass++) {
+		clock_t start = clock();
+
+		for (y1 = 0; y1 < c->height; y1 += BENCH_LOS_STEP) {
+			for (x1 = 0; x1 < c->width; x1 += BENCH_LOS_STEP) {
+				struct los_source from;
+				int y_lo = MAX(0, y1 - LOS_RADIUS);
+				int y_hi = MIN(c->height - 1, y1 + LOS_RADIUS);
+				int x_lo = MAX(0, x1 - LOS_RADIUS);
+				int x_hi = MIN(c->width - 1, x1 + LOS_RADIUS);
+
+				if (cave_info(c, y1, x1) & CAVE_WALL) continue;
+
+				los_source_init(&from, y1, x1);
+				for (y2 = y_lo; y2 <= y_hi; y2++) {
+					for (x2 = x_lo; x2 <= x_hi; x2++) {
+						bool v;
+
+						if (cave_info(c, y2, x2) & CAVE_WALL) continue;
+
+						if (pass == 0)
+							v = los_walk(c, y1, x1, y2, x2);
+						else if (pass == 1)
+							v = los(y1, x1, y2, x2);
+						else
+							v = los_from(&from, y2, x2);
+
+						seen[pass] += v;
+					}
+				}
+			}
+		}
+
+		if (pass == 0) l->walk += clock() - start;
+		else if (pass == 1) l->table += clock() - start;
+		else l->batch += clock() - start;
+	}
+
+	/* Count the queries, and check the answers outside the timing */
+	for (y1 = 0; y1 < c->height; y1 += BENCH_LOS_STEP) {
+		for (x1 = 0; x1 < c->width; x1 += BENCH_LOS_STEP) {
+			struct los_source from;
+			int y_lo = MAX(0, y1 - LOS_RADIUS);
+			int y_hi = MIN(c->height - 1, y1 + LOS_RADIUS);
+			int x_lo = MAX(0, x1 - LOS_RADIUS);
+			int x_hi = MIN(c->width - 1, x1 + LOS_RADIUS);
+
+			if (cave_info(c, y1, x1) & CAVE_WALL) continue;
+
+			los_source_init(&from, y1, x1);
+			for (y2 = y_lo; y2 <= y_hi; y2++) {
+				for (x2 = x_lo; x2 <= x_hi; x2++) {
+					bool v;
+
+					if (cave_info(c, y2, x2) & CAVE_WALL) continue;
+
+					v = los_walk(c, y1, x1, y2, x2);
+					l->queries++;
+					if (los(y1, x1, y2, x2) != v ||
+							los_from(&from, y2, x2) != v)
+						l->mismatches++;
+				}
+			}
+		}
+	}
+	l->seen += seen[0];
+}
+
+/**
+ * A checksum of what playing game turns changes: the turn, the player's
+ * energy, hit points and food, every monster, and the random number state.
+ */
+static u32b bench_turn_state(struct cave *c)
+{
+	rand_state r;
+	u32b h = turn;
+	int i;
+
+	h = h * 31 + p_ptr->energy;
+	h = h * 31 + p_ptr->chp;
+	h = h * 31 + p_ptr->food;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *m = cave_monster(c, i);
+
+		h = h * 31 + m->r_idx;
+		h = h * 31 + m->fy * 256 + m->fx;
+		h = h * 31 + m->hp;
+		h = h * 31 + m->energy;
+	}
+
+	Rand_state_save(&r);
+	h = h * 31 + r.i;
+	for (i = 0; i < RAND_DEG; i++)
+		h = h * 31 + r.state[i];
+
+	return h;
+}
+
+/**
+ * Build the level for seed and play num_turns game turns on it, with the
+ * player holding still, noting the state after every tenth turn in states[].
+ * If skip is set, idle turns are passed over as they are in the game, which
+ * always stops on every tenth turn. Returns the number of states noted.
+ */
+static u32b bench_play_turns(u64b seed, bool skip, u32b *states, u32b *steps,
+	clock_t *time)
+{
+	s32b end;
+	u32b n = 0;
+	clock_t start;
+	int i;
+
+	for (i = 0; i < z_info->a_max; i++)
+		a_info[i].created = FALSE;
+
+	cave_generate_from_seed(cave, p_ptr, seed);
+	Rand_state_init64(seed);
+	character_generated = character_dungeon = TRUE;
+	p_ptr->leaving = FALSE;
+
+	/* Start on the level afresh, as dungeon() does */
+	p_ptr->update |= (PU_BONUS | PU_HP | PU_MANA | PU_SPELLS | PU_TORCH);
+	p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_DISTANCE);
+	p_ptr->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
+	update_stuff(p_ptr);
+
+	start = clock();
+	for (end = turn + num_turns; turn < end; (*steps)++) {
+		/* The player holds, and always survives */
+		while (p_ptr->energy >= 100 && !p_ptr->leaving) {
+			process_monsters(cave, (byte)(p_ptr->energy + 1));
+			p_ptr->energy -= 100;
+			p_ptr->chp = p_ptr->mhp;
+		}
+
+		if (p_ptr->leaving || !process_game_turn(cave, skip)) break;
+
+		if (turn % 10 == 0) states[n++] = bench_turn_state(cave);
+	}
+	*time += clock() - start;
+
+	character_generated = character_dungeon = FALSE;
+	return n;
+}
+
+/**
+ * Check that passing over idle game turns doesn't change the outcome of
+ * playing them: play the level for seed turn by turn, then again passing
+ * over idle turns, from the same state and random numbers, and compare.
+ */
+static void bench_turns_level(u64b seed)
+{
+	struct bench_turns *t = &turns_data;
+	struct player saved = *p_ptr;
+	s32b saved_turn = turn;
+	u32b *step_states = C_ZNEW(num_turns / 10 + 1, u32b);
+	u32b *skip_states = C_ZNEW(num_turns / 10 + 1, u32b);
+	u32b steps = 0, n_step, n_skip;
+
+	n_step = bench_play_turns(seed, FALSE, step_states, &steps, &t->step);
+	*p_ptr = saved;
+	turn = saved_turn;
+
+	steps = 0;
+	n_skip = bench_play_turns(seed, TRUE, skip_states, &steps, &t->skip);
+	*p_ptr = saved;
+	turn = saved_turn;
+
+	t->levels++;
+	t->turns += num_turns;
+	t->steps += steps;
+	if (n_step != n_skip ||
+			memcmp(step_states, skip_states, n_step * sizeof(u32b)))
+		t->mismatches++;
+
+	FREE(step_states);
+	FREE(skip_states);
+}
+
+/**
+ * Generate num_levels levels at depth. Level n is generated from the level
+ * seed (seed_base << 32) + n at every depth, and artifacts are forgotten
+ * each time, so that a level depends only on its seed and depth and can be
+ * rebuilt with cave_generate_from_seed().
+ */
+static void bench_depth(int depth)
+{
+	struct bench_depth *d = &depth_data[depth];
+	u32b n;
+	int i;
+
+	for (n = 0; n < num_levels; n++) {
+		clock_t start;
+
+		for (i = 0; i < z_info->a_max; i++)
+			a_info[i].created = FALSE;
+
+		dungeon_change_level(depth);
+
+		level_tries = 0;
+		last_profile = NULL;
+
+		start = clock();
+		cave_generate_from_seed(cave, p_ptr, ((u64b)seed_base << 32) + n);
+		d->time += clock() - start;
+
+		if (time_los) bench_los_level(cave);
+		if (num_turns) bench_turns_level(((u64b)seed_base << 32) + n);
+
+		d->levels++;
+		d->tries += level_tries;
+		if (last_profile) last_profile->levels++;
+	}
+}
+
+static double bench_secs(clock_t t)
+{
+	return (double)t / CLOCKS_PER_SEC;
+}
+
+static double bench_rate(u32b n, clock_t t)
+{
+	return t ? n / bench_secs(t) : 0.0;
+}
+
+static long bench_peak_rss(void)
+{
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage)) return 0;
+	return usage.ru_maxrss;
+}
+
+static void bench_report(void)
+{
+	u32b levels = 0, tries = 0;
+	clock_t time = 0;
+	int i;
+
+	printf("\n%5s %8s %10s %8s %9s\n", "depth", "levels", "levels/s",
+		"retries", "secs");
+	for (i = 0; i < MAX_DEPTH; i++) {
+		struct bench_depth *d = &depth_data[i];
+		if (!d->levels) continue;
+
+		printf("%5d %8u %10.1f %8u %9.3f\n", i, d->levels,
+			bench_rate(d->levels, d->time), d->tries - d->levels,
+			bench_secs(d->time));
+		levels += d->levels;
+		tries += d->tries;
+		time += d->time;
+	}
+	printf("%5s %8u %10.1f %8u %9.3f\n", "total", levels,
+		bench_rate(levels, time), tries - levels, bench_secs(time));
+
+	printf("\n%-16s %8s %8s %8s %10s %9s\n", "profile", "levels", "calls",
+		"failed", "levels/s", "secs");
+	for (i = 0; i < num_profiles; i++) {
+		struct bench_timer *t = &profiles[i];
+		printf("%-16s %8u %8u %8u %10.1f %9.3f\n", t->name, t->levels,
+			t->calls, t->calls - t->built, bench_rate(t->levels, t->time),
+			bench_secs(t->time));
+	}
+
+	printf("\n%-16s %8s %8s %10s %9s\n", "room", "calls", "built",
+		"usec/call", "secs");
+	for (i = 0; i < num_rooms; i++) {
+		struct bench_timer *t = &rooms[i];
+		printf("%-16s %8u %8u %10.1f %9.3f\n", t->name, t->calls, t->built,
+			t->calls ? 1e6 * bench_secs(t->time) / t->calls : 0.0,
+			bench_secs(t->time));
+	}
+
+	if (los_data.queries) {
+		struct bench_los *l = &los_data;
+
+		printf("\n%-16s %10s %9s\n", "los", "nsec/query", "secs");
+		printf("%-16s %10.1f %9.3f\n", "walk",
+			1e9 * bench_secs(l->walk) / l->queries, bench_secs(l->walk));
+		printf("%-16s %10.1f %9.3f\n", "table",
+			1e9 * bench_secs(l->table) / l->queries, bench_secs(l->table));
+		printf("%-16s %10.1f %9.3f\n", "batch",
+			1e9 * bench_secs(l->batch) / l->queries, bench_secs(l->batch));
+		printf("%u queries, %u with line of sight, %u mismatches\n",
+			l->queries, l->seen, l->mismatches);
+	}
+
+	if (turns_data.levels) {
+		struct bench_turns *t = &turns_data;
+
+		printf("\n%-16s %10s %9s\n", "turns", "nsec/turn", "secs");
+		printf("%-16s %10.1f %9.3f\n", "step",
+			1e9 * bench_secs(t->step) / t->turns, bench_secs(t->step));
+		printf("%-16s %10.1f %9.3f\n", "skip",
+			1e9 * bench_secs(t->skip) / t->turns, bench_secs(t->skip));
+		printf("%u turns on %u levels, %u passed over, %u mismatches\n",
+			t->turns, t->levels, t->turns - t->steps, t->mismatches);
+	}
+
+	printf("\nPeak memory: %ld kB\n", bench_peak_rss());
+}
+
+/**
+ * Write a JSON string; builder names are plain text, but be safe.
+ */
+static void bench_json_string(ang_file *f, const char *s)
+{
+	file_putf(f, "\"");
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			file_putf(f, "\\%c", *s);
+		else if ((unsigned char)*s < 0x20)
+			file_putf(f, "\\u%04x", *s);
+		else
+			file_putf(f, "%c", *s);
+	}
+	file_putf(f, "\"");
+}
+
+static void bench_json_timers(ang_file *f, const char *key,
+	struct bench_timer *list, int n, bool levels)
+{
+	int i;
+
+	file_putf(f, "  \"%s\": [", key);
+	for (i = 0; i < n; i++) {
+		struct bench_timer *t = &list[i];
+
+		file_putf(f, "%s\n    {\"name\": ", i ? "," : "");
+		bench_json_string(f, t->name);
+		file_putf(f, ", \"calls\": %u, \"built\": %u, \"seconds\": %.6f",
+			t->calls, t->built, bench_secs(t->time));
+		if (levels)
+			file_putf(f, ", \"levels\": %u, \"levels_per_sec\": %.3f",
+				t->levels, bench_rate(t->levels, t->time));
+		else
+			file_putf(f, ", \"usec_per_call\": %.3f",
+				t->calls ? 1e6 * bench_secs(t->time) / t->calls : 0.0);
+		file_putf(f, "}");
+	}
+	file_putf(f, "\n  ]");
+}
+
+static bool bench_write_json(const char *path)
+{
+	ang_file *f = file_open(path, MODE_WRITE, FTYPE_TEXT);
+	u32b levels = 0, tries = 0;
+	clock_t time = 0;
+	bool first = TRUE;
+	int i;
+
+	if (!f) return FALSE;
+
+	file_putf(f, "{\n  \"version\": ");
+	bench_json_string(f, buildver);
+	file_putf(f, ",\n  \"seed\": %u,\n  \"levels_per_depth\": %u,\n",
+		seed_base, num_levels);
+
+	file_putf(f, "  \"depths\": [");
+	for (i = 0; i < MAX_DEPTH; i++) {
+		struct bench_depth *d = &depth_data[i];
+		if (!d->levels) continue;
+
+		file_putf(f, "%s\n    {\"depth\": %d, \"levels\": %u, "
+			"\"retries\": %u, \"seconds\": %.6f, \"levels_per_sec\": %.3f}",
+			first ? "" : ",", i, d->levels, d->tries - d->levels,
+			bench_secs(d->time), bench_rate(d->levels, d->time));
+		first = FALSE;
+
+		levels += d->levels;
+		tries += d->tries;
+		time += d->time;
+	}
+	file_putf(f, "\n  ],\n");
+
+	bench_json_timers(f, "profiles", profiles, num_profiles, TRUE);
+	file_putf(f, ",\n");
+	bench_json_timers(f, "rooms", rooms, num_rooms, FALSE);
+	file_putf(f, ",\n");
+
+	file_putf(f, "  \"total\": {\"levels\": %u, \"retries\": %u, "
+		"\"seconds\": %.6f, \"levels_per_sec\": %.3f},\n", levels,
+		tries - levels, bench_secs(time), bench_rate(levels, time));
+	if (los_data.queries) {
+		struct bench_los *l = &los_data;
+
+		file_putf(f, "  \"los\": {\"queries\": %u, \"seen\": %u, "
+			"\"mismatches\": %u, \"walk_seconds\": %.6f, "
+			"\"table_seconds\": %.6f, \"batch_seconds\": %.6f},\n",
+			l->queries, l->seen, l->mismatches, bench_secs(l->walk),
+			bench_secs(l->table), bench_secs(l->batch));
+	}
+	if (turns_data.levels) {
+		struct bench_turns *t = &turns_data;
+
+		file_putf(f, "  \"turns\": {\"levels\": %u, \"turns\": %u, "
+			"\"passed_over\": %u, \"mismatches\": %u, "
+			"\"step_seconds\": %.6f, \"skip_seconds\": %.6f},\n",
+			t->levels, t->turns, t->turns - t->steps, t->mismatches,
+			bench_secs(t->step), bench_secs(t->skip));
+	}
+	file_putf(f, "  \"peak_rss_kb\": %ld\n}\n", bench_peak_rss());
+
+	return file_close(f);
+}
+
+static errr run_bench(void)
+{
+	int depth;
+
+	gen_restart_hook = bench_gen_restart;
+	gen_profile_hook = bench_gen_profile;
+	gen_room_hook = bench_gen_room;
+
+	bench_init_character();
+
+	for (depth = 0; depth < MAX_DEPTH; depth++) {
+		if (!depths[depth]) continue;
+
+		if (!quiet) {
+			printf("Generating %u levels at depth %d...\n", num_levels,
+				depth);
+			fflush(stdout);
+		}
+
+		bench_depth(depth);
+	}
+
+	gen_restart_hook = NULL;
+	gen_profile_hook = NULL;
+	gen_room_hook = NULL;
+
+	if (!quiet) bench_report();
+
+	if (json_path[0] && !bench_write_json(json_path))
+		quit_fmt("Couldn't write %s!", json_path);
+
+	cleanup_angband();
+	if (turns_data.mismatches)
+		quit("Passing over idle game turns changed the outcome!");
+	quit(NULL);
+	exit(0);
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+
+static errr term_xtra_bench(int n, int v) {
+	if (n != TERM_XTRA_EVENT || running_bench)
+		return 0;
+
+	running_bench = 1;
+	return run_bench();
+}
+
+static errr term_curs_bench(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_bench(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_bench(int x, int y, int n, byte a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = TRUE;
+	t->never_frosh = TRUE;
+
+	t->xtra_hook = term_xtra_bench;
+	t->curs_hook = term_curs_bench;
+	t->wipe_hook = term_wipe_bench;
+	t->text_hook = term_text_bench;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+/**
+ * Parse a list of depths such as "1,5,10-20" into depths[].
+ */
+static bool bench_parse_depths(const char *s)
+{
+	while (*s) {
+		char *end;
+		long lo = strtol(s, &end, 10), hi = lo;
+
+		if (end == s) return FALSE;
+		if (*end == '-') {
+			s = end + 1;
+			hi = strtol(s, &end, 10);
+			if (end == s) return FALSE;
+		}
+		if (lo < 0 || hi >= MAX_DEPTH || lo > hi) return FALSE;
+
+		for (; lo <= hi; lo++)
+			depths[lo] = TRUE;
+
+		s = end;
+		if (*s == ',') s++;
+		else if (*s) return FALSE;
+	}
+
+	return TRUE;
+}
+
+const char help_bench[] = "Level generation benchmark mode, subopts -q(uiet) -n(# of levels per depth) -d(epths) -S(eed) -l(os timing) -t(urns to play) -o(utput JSON file)";
+
+/*
+ * Usage:
+ *
+ * angband -mbench -- [-q] [-nNNNN] [-dLIST] [-SNNNN] [-l] [-tNNNN] [-oFILE]
+ *
+ *   -q      Quiet mode (no progress messages or report)
+ *   -nNNNN  Generate NNNN levels at each depth (default: 100)
+ *   -dLIST  Generate levels at the depths in LIST, such as 0,5,10-20
+ *           (default: 0,1,10,30,50,98)
+ *   -SNNNN  Seed level N at each depth with (NNNN << 32) + N (default: 42)
+ *   -l      Also time los() against walking each line on every level
+ *   -tNNNN  Also play NNNN game turns on every level, turn by turn and
+ *           passing over idle turns, and fail unless both end up the same
+ *   -oFILE  Write the results to FILE as JSON
+ */
+
+errr init_bench(int argc, char *argv[]) {
+	int i;
+	bool any_depth = FALSE;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (streq(argv[i], "-q")) {
+			quiet = TRUE;
+			continue;
+		}
+		if (prefix(argv[i], "-n")) {
+			num_levels = MAX(1, atoi(&argv[i][2]));
+			continue;
+		}
+		if (prefix(argv[i], "-d")) {
+			if (!bench_parse_depths(&argv[i][2]))
+				quit_fmt("init-bench: bad depths '%s'", &argv[i][2]);
+			any_depth = TRUE;
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = strtoul(&argv[i][2], NULL, 10);
+			continue;
+		}
+		if (streq(argv[i], "-l")) {
+			time_los = TRUE;
+			continue;
+		}
+		if (prefix(argv[i], "-t")) {
+			num_turns = atoi(&argv[i][2]) / 10 * 10;
+			continue;
+		}
+		if (prefix(argv[i], "-o")) {
+			my_strcpy(json_path, &argv[i][2], sizeof(json_path));
+			continue;
+		}
+		printf("init-bench: bad argument '%s'\n", argv[i]);
+	}
+
+	if (!any_depth)
+		bench_parse_depths("0,1,10,30,50,98");
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_BENCH */
@@ -22,14 +22,19 @@
 
 #include "birth.h"
 #include "buildid.h"
+#include "generate.h"
 #include "init.h"
 #include "monster/mon-make.h"
 #include "object/pval.h"
 #include "object/tvalsval.h"
+#include "stats/counters.h"
 #include "stats/db.h"
 #include "stats/structs.h"
 #include <stddef.h>
 #include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
@@ -41,6 +46,8 @@
 #define TOP_POWER		999
 #define TOP_PVAL		 25
 #define RUNS_PER_CHECKPOINT	20000
+#define MAX_WORKERS		 64
+#define SHARD_MAGIC		0x53545332 /* "STS2" */
 
 /* For ref, e_max is ~200, a_max is ~140, r_max is ~650,
 	ORIGIN_STATS is 14, OF_MAX is ~120 */
@@ -50,6 +57,11 @@
 static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
+static u32b seed_base = 0;
+static int num_workers = 1;
+static u32b checkpoint_runs = RUNS_PER_CHECKPOINT;
+static bool resume = FALSE;
+static char resume_name[256];
 static bool quiet = FALSE;
 static int nextkey = 0;
 static int running_stats = 0;
@@ -57,46 +69,81 @@ static char *ANGBAND_DIR_STATS;
 
 static int *consumables_index, *consumables_rev_index;
 static int *wearables_index, *wearables_rev_index;
-static int *pval_flags_index, *pval_flags_rev_index;
 static int wearable_count = 0;
 static int consumable_count = 0;
-static int pval_flags_count = 0;
+static int vault_max = 0;
 
-struct wearables_data {
-	u32b count;
-	u32b dice[TOP_DICE][TOP_SIDES];
-	u32b ac[TOP_AC];
-	u32b hit[TOP_PLUS];
-	u32b dam[TOP_PLUS];
-/*	u32b power[TOP_POWER]; not enough memory - add it later in bands */
-	u32b *affixes;
-	u32b *themes;
-	u32b flags[OF_MAX];
-	u32b *pval_flags[TOP_PVAL];
-};
+/* Vaults and pits built in the current generation attempt */
+static u32b *gen_vaults, *gen_pits;
 
 static struct level_data {
 	u32b *monsters;
-/*  u32b *vaults;  Add these later - requires passing into generate.c
-	u32b *pits; */
+	u32b *vaults;
+	u32b *pits;
 	u32b obj_feelings[OBJ_FEEL_MAX];
 	u32b mon_feelings[MON_FEEL_MAX];
 	long long gold[ORIGIN_STATS];
 	u32b *artifacts[ORIGIN_STATS];
 	u32b *consumables[ORIGIN_STATS];
-	struct wearables_data *wearables[ORIGIN_STATS];
+	u32b *wearables[ORIGIN_STATS];
 } level_data[LEVEL_MAX];
 
+/**
+ * The histograms for each wearable kind are almost all zero, so rather
+ * than dense arrays per level, origin and kind they are kept in one sparse
+ * counter store. The key packs the level, origin, wearable index, field
+ * and up to two indices within the field.
+ */
+enum wearables_field {
+	WEAR_DICE,		/* [dd][ds] */
+	WEAR_AC,		/* [ac] */
+	WEAR_HIT,		/* [to_finesse] */
+	WEAR_DAM,		/* [to_prowess] */
+	WEAR_POWER,		/* [power] */
+	WEAR_AFFIXES,	/* [e_idx] */
+	WEAR_THEMES,	/* [theme] */
+	WEAR_FLAGS,		/* [of_idx] */
+	WEAR_PVAL_FLAGS	/* [pval][of_idx] */
+};
+
+static struct counter_store *wearables_hist;
+
+static unsigned long long wear_key(int level, int origin, int idx,
+	enum wearables_field field, int i, int j)
+{
+	return ((unsigned long long)level << 52) |
+		((unsigned long long)origin << 48) |
+		((unsigned long long)idx << 36) |
+		((unsigned long long)field << 32) |
+		((unsigned long long)i << 16) | (unsigned long long)j;
+}
+
+static void wear_unkey(unsigned long long key, int *level, int *origin,
+	int *idx, enum wearables_field *field, int *i, int *j)
+{
+	*level = (key >> 52) & 0x7F;
+	*origin = (key >> 48) & 0x0F;
+	*idx = (key >> 36) & 0xFFF;
+	*field = (key >> 32) & 0x0F;
+	*i = (key >> 16) & 0xFFFF;
+	*j = key & 0xFFFF;
+}
+
+static void wear_count(int level, int origin, int idx,
+	enum wearables_field field, int i, int j)
+{
+	counters_add(wearables_hist, wear_key(level, origin, idx, field, i, j), 1);
+}
+
 static void create_indices()
 {
 	int i;
+	struct vault *v;
 
 	consumables_index = C_ZNEW(z_info->k_max, int);
 	consumables_rev_index = C_ZNEW(z_info->k_max, int);
 	wearables_index = C_ZNEW(z_info->k_max, int);
 	wearables_rev_index = C_ZNEW(z_info->k_max, int);
-	pval_flags_index = C_ZNEW(OF_MAX, int);
-	pval_flags_rev_index = C_ZNEW(OF_MAX, int);
 
 	for (i = 0; i < z_info->k_max; i++) {
 
@@ -116,67 +163,53 @@ static void create_indices()
 		}
 	}
 
-	for (i = 0; i < OF_MAX; i++)
-		if (flag_uses_pval(i)) {
-			pval_flags_index[i] = ++pval_flags_count;
-			pval_flags_rev_index[pval_flags_count] = i;
-		}
+	for (v = vaults; v; v = v->next)
+		if ((int)v->vidx >= vault_max)
+			vault_max = v->vidx + 1;
 }
 
 static void alloc_memory()
 {
-	int i, j, k, l;
+	int i, j;
 
 	for (i = 0; i < LEVEL_MAX; i++) {
 		level_data[i].monsters = C_ZNEW(z_info->r_max, u32b);
-/*		level_data[i].vaults = C_ZNEW(z_info->v_max, u32b);
-		level_data[i].pits = C_ZNEW(z_info->pit_max, u32b); */
+		level_data[i].vaults = C_ZNEW(vault_max, u32b);
+		level_data[i].pits = C_ZNEW(z_info->pit_max + 1, u32b);
 
 		for (j = 0; j < ORIGIN_STATS; j++) {
 			level_data[i].artifacts[j] = C_ZNEW(z_info->a_max, u32b);
 			level_data[i].consumables[j] = C_ZNEW(consumable_count + 1, u32b);
-			level_data[i].wearables[j]
-				= C_ZNEW(wearable_count + 1, struct wearables_data);
-
-			for (k = 0; k < wearable_count + 1; k++) {
-				level_data[i].wearables[j][k].affixes
-					= C_ZNEW(z_info->e_max, u32b);
-				level_data[i].wearables[j][k].themes
-					= C_ZNEW(z_info->theme_max, u32b);
-				for (l = 0; l < TOP_PVAL; l++)
-					level_data[i].wearables[j][k].pval_flags[l]
-						= C_ZNEW(pval_flags_count + 1, u32b);
-			}
+			level_data[i].wearables[j] = C_ZNEW(wearable_count + 1, u32b);
 		}
 	}
+
+	wearables_hist = counters_new();
+
+	gen_vaults = C_ZNEW(vault_max, u32b);
+	gen_pits = C_ZNEW(z_info->pit_max + 1, u32b);
 }
 
 static void free_stats_memory(void)
 {
-	int i, j, k, l;
+	int i, j;
 	for (i = 0; i < LEVEL_MAX; i++) {
 		mem_free(level_data[i].monsters);
-/*		mem_free(level_data[i].vaults);
- 		mem_free(level_data[i].pits); */
+		mem_free(level_data[i].vaults);
+		mem_free(level_data[i].pits);
 		for (j = 0; j < ORIGIN_STATS; j++) {
 			mem_free(level_data[i].artifacts[j]);
 			mem_free(level_data[i].consumables[j]);
-			for (k = 0; k < wearable_count + 1; k++) {
-				for (l = 0; l < TOP_PVAL; l++) {
-					mem_free(level_data[i].wearables[j][k].pval_flags[l]);
-				}
-				mem_free(level_data[i].wearables[j][k].affixes);
-				mem_free(level_data[i].wearables[j][k].themes);
-			}
 			mem_free(level_data[i].wearables[j]);
 		}
 	}
+	counters_free(wearables_hist);
+	mem_free(gen_vaults);
+	mem_free(gen_pits);
 	mem_free(consumables_index);
 	mem_free(consumables_rev_index);
 	mem_free(wearables_index);
 	mem_free(wearables_rev_index);
-	mem_free(pval_flags_index);
-	mem_free(pval_flags_rev_index);
 	string_free(ANGBAND_DIR_STATS);
 }
 
@@ -219,16 +252,20 @@ static void generate_player_for_stats()
 	p_ptr->sc_birth = p_ptr->sc;
 }
 
-static void initialize_character(void)
+/*
+ * Each run is seeded from seed_base and its run number, so that a given
+ * run produces the same dungeon whichever process ends up making it.
+ */
+static void initialize_character(u32b run)
 {
-	u32b seed;
+	u32b seed = seed_base + run;
+	int i;
 
 	if (!quiet) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
 	Rand_quick = FALSE;
 	Rand_state_init(seed);
 
@@ -244,6 +281,10 @@ static void initialize_character(void)
 		do_randart(seed_randart, TRUE);
 	}
 
+	/* store_reset() avoids the previous owner, so forget the last run's */
+	for (i = 0; i < MAX_STORES; i++)
+		stores[i].owner = NULL;
+
 	store_reset();
 	flavor_init();
 	p_ptr->playing = TRUE;
@@ -303,18 +344,14 @@ static void log_all_objects(int level)
 {
 	int x, y, i;
 
-	for (y = 1; y < DUNGEON_HGT - 1; y++) {
-		for (x = 1; x < DUNGEON_WID - 1; x++) {
+	for (y = 1; y < cave->height - 1; y++) {
+		for (x = 1; x < cave->width - 1; x++) {
 			object_type *o_ptr = get_first_object(y, x);
 
 			if (o_ptr) do {
-			/*	u32b o_power = 0; */
-
 				/* Mark object as fully known */
 				object_notice_everything(o_ptr);
 
-/*				o_power = object_power(o_ptr, FALSE, NULL, TRUE); */
-
 				/* Capture gold amounts */
 				if (o_ptr->tval == TV_GOLD)
 					level_data[level].gold[o_ptr->origin] += o_ptr->extent;
@@ -325,30 +362,41 @@ static void log_all_objects(int level)
 
 				/* Capture kind details */
 				if (wearable_p(o_ptr)) {
-					struct wearables_data *w
-						= &level_data[level].wearables[o_ptr->origin][wearables_index[o_ptr->kind->kidx]];
-
-					w->count++;
-					w->dice[MIN(o_ptr->dd, TOP_DICE - 1)][MIN(o_ptr->ds, TOP_SIDES - 1)]++;
-					w->ac[MIN(MAX(o_ptr->ac + o_ptr->to_a, 0), TOP_AC - 1)]++;
-					w->hit[MIN(MAX(o_ptr->to_finesse, 0), TOP_PLUS - 1)]++;
-					w->dam[MIN(MAX(o_ptr->to_prowess, 0), TOP_PLUS - 1)]++;
+					int origin = o_ptr->origin;
+					int idx = wearables_index[o_ptr->kind->kidx];
+					s32b power = object_power(o_ptr, FALSE, NULL, TRUE);
+
+					level_data[level].wearables[origin][idx]++;
+					wear_count(level, origin, idx, WEAR_DICE,
+						MIN(o_ptr->dd, TOP_DICE - 1),
+						MIN(o_ptr->ds, TOP_SIDES - 1));
+					wear_count(level, origin, idx, WEAR_AC,
+						MIN(MAX(o_ptr->ac + o_ptr->to_a, 0), TOP_AC - 1), 0);
+					wear_count(level, origin, idx, WEAR_HIT,
+						MIN(MAX(o_ptr->to_finesse, 0), TOP_PLUS - 1), 0);
+					wear_count(level, origin, idx, WEAR_DAM,
+						MIN(MAX(o_ptr->to_prowess, 0), TOP_PLUS - 1), 0);
+					wear_count(level, origin, idx, WEAR_POWER,
+						MIN(MAX(power, 0), TOP_POWER - 1), 0);
 
 					/* Capture egos */
 					if (o_ptr->theme)
-						w->themes[o_ptr->theme->index]++;
+						wear_count(level, origin, idx, WEAR_THEMES,
+							o_ptr->theme->index, 0);
 
 					for (i = 0; i < MAX_AFFIXES; i++)
 						if (o_ptr->affix[i])
-							w->affixes[o_ptr->affix[i]->eidx]++;
+							wear_count(level, origin, idx, WEAR_AFFIXES,
+								o_ptr->affix[i]->eidx, 0);
 
 					/* Capture object flags */
 					for (i = of_next(o_ptr->flags, FLAG_START); i != FLAG_END;
 							i = of_next(o_ptr->flags, i + 1)) {
-						w->flags[i]++;
+						wear_count(level, origin, idx, WEAR_FLAGS, i, 0);
 						if (flag_uses_pval(i)) {
 							int p = o_ptr->pval[which_pval(o_ptr, i)];
-							w->pval_flags[MIN(MAX(p, 0), TOP_PVAL - 1)][pval_flags_index[i]]++;
+							wear_count(level, origin, idx, WEAR_PVAL_FLAGS,
+								MIN(MAX(p, 0), TOP_PVAL - 1), i);
 						}
 					}
 				} else
@@ -359,9 +407,29 @@ static void log_all_objects(int level)
 	}
 }
 
+/*
+ * Generation hooks: note the vaults and pits built, forgetting them if
+ * the attempt is abandoned.
+ */
+static void stats_gen_restart(struct cave *c)
+{
+	C_WIPE(gen_vaults, vault_max, u32b);
+	C_WIPE(gen_pits, z_info->pit_max + 1, u32b);
+}
+
+static void stats_gen_vault(struct cave *c, const struct vault *v_ptr)
+{
+	gen_vaults[v_ptr->vidx]++;
+}
+
+static void stats_gen_pit(struct cave *c, const pit_profile *pit)
+{
+	gen_pits[pit->pit_idx]++;
+}
+
 static void descend_dungeon(void)
 {
-	int level;
+	int level, i;
 	u16b obj_f, mon_f;
 
 	clock_t last = 0;
@@ -382,6 +450,12 @@ static void descend_dungeon(void)
 		dungeon_change_level(level);
 		cave_generate(cave, p_ptr);
 
+		/* Store vaults and pits from the attempt that succeeded */
+		for (i = 0; i < vault_max; i++)
+			level_data[level].vaults[i] += gen_vaults[i];
+		for (i = 0; i <= z_info->pit_max; i++)
+			level_data[level].pits[i] += gen_pits[i];
+
 		/* Store level feelings */
 		obj_f = cave->feeling / 10;
 		mon_f = cave->feeling - (10 * obj_f);
@@ -1056,6 +1130,11 @@ static int stats_dump_info(void)
 	err = stats_db_exec(sql_buf);
 	if (err) return err;
 
+	strnfmt(sql_buf, 256, "INSERT INTO metadata VALUES('seed',%u);",
+		seed_base);
+	err = stats_db_exec(sql_buf);
+	if (err) return err;
+
 	err = stats_dump_artifacts();
 	if (err) return err;
 
@@ -1114,6 +1193,8 @@ static int stats_dump_info(void)
  *     theme_type_map -- map between themes and tvals/svals, with alloc_min/max
  * Count tables:
  *     monsters
+ *     vaults
+ *     pits
  *     obj_feelings
  *     mon_feelings
  *     gold
@@ -1124,6 +1205,7 @@ static int stats_dump_info(void)
  *     wearables_ac
  *     wearables_hit
  *     wearables_dam
+ *     wearables_power
  *     wearables_egos
  *     wearables_flags
  *     wearables_pval_flags
@@ -1223,6 +1305,12 @@ static bool stats_prep_db(void)
 	err = stats_db_exec("CREATE TABLE monsters(level INT, count INT, k_idx INT, UNIQUE (level, k_idx) ON CONFLICT REPLACE);");
 	if (err) return false;
 
+	err = stats_db_exec("CREATE TABLE vaults(level INT, count INT, v_idx INT, UNIQUE (level, v_idx) ON CONFLICT REPLACE);");
+	if (err) return false;
+
+	err = stats_db_exec("CREATE TABLE pits(level INT, count INT, pit_idx INT, UNIQUE (level, pit_idx) ON CONFLICT REPLACE);");
+	if (err) return false;
+
 	err = stats_db_exec("CREATE TABLE obj_feelings(level INT, count INT, feeling INT, UNIQUE (level, feeling) ON CONFLICT REPLACE);");
 	if (err) return false;
 
@@ -1253,6 +1341,9 @@ static bool stats_prep_db(void)
 	err = stats_db_exec("CREATE TABLE wearables_dam(level INT, count INT, k_idx INT, origin INT, to_prowess INT, UNIQUE (level, k_idx, origin, to_prowess) ON CONFLICT REPLACE);");
 	if (err) return false;
 
+	err = stats_db_exec("CREATE TABLE wearables_power(level INT, count INT, k_idx INT, origin INT, power INT, UNIQUE (level, k_idx, origin, power) ON CONFLICT REPLACE);");
+	if (err) return false;
+
 	err = stats_db_exec("CREATE TABLE wearables_affixes(level INT, count INT, k_idx INT, origin INT, e_idx INT, UNIQUE (level, k_idx, origin, e_idx) ON CONFLICT REPLACE);");
 	if (err) return false;
 
@@ -1278,6 +1369,10 @@ static int stats_level_data_offsetof(const char *member)
 {
 	if (streq(member, "monsters"))
 		return offsetof(struct level_data, monsters);
+	else if (streq(member, "vaults"))
+		return offsetof(struct level_data, vaults);
+	else if (streq(member, "pits"))
+		return offsetof(struct level_data, pits);
 	else if (streq(member, "obj_feelings"))
 		return offsetof(struct level_data, obj_feelings);
 	else if (streq(member, "mon_feelings"))
@@ -1295,43 +1390,11 @@ static int stats_level_data_offsetof(const char *member)
 	assert(0);
 }
 
-/**
- * Find the offset of the given member of the wearables_data struct. Not
- * elegant.
- */
-static int stats_wearables_data_offsetof(const char *member)
-{
-	if (streq(member, "count"))
-		return offsetof(struct wearables_data, count);
-	else if (streq(member, "dice"))
-		return offsetof(struct wearables_data, dice);
-	else if (streq(member, "ac"))
-		return offsetof(struct wearables_data, ac);
-	else if (streq(member, "hit"))
-		return offsetof(struct wearables_data, hit);
-	else if (streq(member, "dam"))
-		return offsetof(struct wearables_data, dam);
-	else if (streq(member, "affixes"))
-		return offsetof(struct wearables_data, affixes);
-	else if (streq(member, "themes"))
-		return offsetof(struct wearables_data, themes);
-	else if (streq(member, "flags"))
-		return offsetof(struct wearables_data, flags);
-	else if (streq(member, "pval_flags"))
-		return offsetof(struct wearables_data, pval_flags);
-
-	/* We should not get to this point. */
-	assert(0);
-}
-
 static int stats_write_db_level_data(const char *table, int max_idx)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
 	int err, level, i, offset;
 
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	err = stats_db_bulk_table(table, 3);
 	if (err) return err;
 
 	offset = stats_level_data_offsetof(table);
@@ -1347,32 +1410,31 @@ static int stats_write_db_level_data(const char *table, int max_idx)
 			{
 				count = *((long long *)((byte *)&level_data[level] + offset) + i);
 			}
+			else if (streq(table, "monsters") || streq(table, "vaults")
+				|| streq(table, "pits"))
+			{
+				/* Pointer member, not an array */
+				count = (*((u32b **)((byte *)&level_data[level] + offset)))[i];
+			}
 			else
 			{
 				count = *((u32b *)((byte *)&level_data[level] + offset) + i);
 			}
-			if (!count) continue;
 
-			err = stats_db_bind_ints(sql_stmt, 3, 0,
-				level, count, i);
+			err = stats_db_bulk_row(level, count, 1, i);
 			if (err) return err;
-
-			STATS_DB_STEP_RESET(sql_stmt)
 		}
 	}
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
 static int stats_write_db_level_data_items(const char *table, int max_idx, 
 	bool translate_consumables)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
 	int err, level, origin, i, offset;
 
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	err = stats_db_bulk_table(table, 4);
 	if (err) return err;
 
 	offset = stats_level_data_offsetof(table);
@@ -1386,28 +1448,22 @@ static int stats_write_db_level_data_items(const char *table, int max_idx,
 				/* This arcane expression finds the value of 
 				 * level_data[level].<table>[origin][i] */
 				u32b count = ((u32b **)((byte *)&level_data[level] + offset))[origin][i];
-				if (!count) continue;
 
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, 
+				err = stats_db_bulk_row(level, count, 2,
 					translate_consumables ? consumables_rev_index[i] : i, origin);
 				if (err) return err;
-
-				STATS_DB_STEP_RESET(sql_stmt)
 			}
 		}
 	}
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
 static int stats_write_db_wearables_count(void)
 {
-	sqlite3_stmt *sql_stmt;
 	int err, level, origin, k_idx, idx;
 
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO wearables_count VALUES(?,?,?,?);");
+	err = stats_db_bulk_table("wearables_count", 4);
 	if (err) return err;
 
 	for (level = 1; level < LEVEL_MAX; level++)
@@ -1416,147 +1472,58 @@ static int stats_write_db_wearables_count(void)
 		{
 			for (idx = 0; idx < wearable_count + 1; idx++)
 			{
-				u32b count = level_data[level].wearables[origin][idx].count;
-				/* Skip if object did not appear */
-				if (!count) continue;
+				u32b count = level_data[level].wearables[origin][idx];
 
 				k_idx = wearables_rev_index[idx];
 
 				/* Skip if pile */
 				if (! k_idx) continue;
 
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, k_idx, origin);
+				err = stats_db_bulk_row(level, count, 2, k_idx, origin);
 				if (err) return err;
-
-				STATS_DB_STEP_RESET(sql_stmt)
-			}
-		}
-	}
-
-	return sqlite3_finalize(sql_stmt);
-}
-
-/**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
- */
-static int stats_write_db_wearables_array(const char *field, int max_val, bool array_p)
-{
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, offset;
-
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
-
-	offset = stats_wearables_data_offsetof(field);
-
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				k_idx = wearables_rev_index[idx];
-
-				/* Skip if pile */
-				if (! k_idx) continue;
-
-				for (i = 0; i < max_val; i++)
-				{
-					/* This arcane expression finds the value of
-					 * level_data[level].wearables[origin][idx].<field>[i] */
-					u32b count;
-					if (array_p)
-					{
-						count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i];
-					}
-					else
-					{
-						count = ((u32b *)*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset)))[i];
-					}
-					if (!count) continue;
-
-					err = stats_db_bind_ints(sql_stmt, 5, 0,
-						level, count, k_idx, origin, i);
-					if (err) return err;
-
-					STATS_DB_STEP_RESET(sql_stmt)
-				}
 			}
 		}
 	}
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
 /**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
+ * Write one field of the wearables histograms to its table, which has one
+ * or two index columns after k_idx and origin.
  */
-static int stats_write_db_wearables_2d_array(const char *field, 
-	int max_val1, int max_val2, bool array_p, bool translate_pval_flags)
+static int stats_write_db_wearables_hist(const char *field,
+	enum wearables_field which, int num_idx)
 {
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, j, offset;
+	char table[64];
+	int err, level, origin, idx, i, j;
+	enum wearables_field f;
+	unsigned long long key;
+	u32b count;
+	size_t iter = 0;
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
+	strnfmt(table, sizeof(table), "wearables_%s", field);
+	err = stats_db_bulk_table(table, num_idx + 4);
 	if (err) return err;
 
-	offset = stats_wearables_data_offsetof(field);
-
-	for (level = 1; level < LEVEL_MAX; level++)
+	while (counters_next(wearables_hist, &iter, &key, &count))
 	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				k_idx = wearables_rev_index[idx];
-
-				/* Skip if pile */
-				if (! k_idx) continue;
-
-				for (i = 0; i < max_val1; i++)
-				{
-					for (j = 0; j < max_val2; j++)
-					{
-						/* This arcane expression finds the value of
-				 		* level_data[level].wearables[origin][idx].<field>[i][j] */
-						u32b count;
-						int real_j = translate_pval_flags ? pval_flags_rev_index[j] : j; 
-
-						if (i == 0 && real_j == 0) continue;
-
-						if (array_p)
-						{
-							count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i * max_val2 + j];
-						}
-						else
-						{
-							count = *(*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset) + i) + j);
-						}
-						if (!count) continue;
-
-						err = stats_db_bind_ints(sql_stmt, 6, 0,
-							level, count, k_idx, origin, i, real_j);
-						if (err) return err;
-
-						STATS_DB_STEP_RESET(sql_stmt)
-					}
-				}
-			}
-		}
+		wear_unkey(key, &level, &origin, &idx, &f, &i, &j);
+		if (f != which) continue;
+
+		/* Skip the town, and piles */
+		if (!level || !wearables_rev_index[idx]) continue;
+
+		if (num_idx == 1)
+			err = stats_db_bulk_row(level, count, 3,
+				wearables_rev_index[idx], origin, i);
+		else if (i || j)
+			err = stats_db_bulk_row(level, count, 4,
+				wearables_rev_index[idx], origin, i, j);
+		if (err) return err;
 	}
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
 static int stats_write_db(u32b run)
@@ -1565,7 +1532,7 @@ static int stats_write_db(u32b run)
 	int err;
 
 	/* Wrap entire write into a transaction */
-	err = stats_db_exec("BEGIN TRANSACTION;");
+	err = stats_db_bulk_begin();
 	if (err) return err;
 
 	strnfmt(sql_buf, 256,
@@ -1576,6 +1543,12 @@ static int stats_write_db(u32b run)
 	err = stats_write_db_level_data("monsters", z_info->r_max);
 	if (err) return err;
 
+	err = stats_write_db_level_data("vaults", vault_max);
+	if (err) return err;
+
+	err = stats_write_db_level_data("pits", z_info->pit_max + 1);
+	if (err) return err;
+
 	err = stats_write_db_level_data("obj_feelings", OBJ_FEEL_MAX);
 	if (err) return err;
 
@@ -1595,50 +1568,367 @@ static int stats_write_db(u32b run)
 	err = stats_write_db_wearables_count();
 	if (err) return err;
 
-	err = stats_write_db_wearables_2d_array("dice", TOP_DICE, TOP_SIDES, true, false);
+	err = stats_write_db_wearables_hist("dice", WEAR_DICE, 2);
 	if (err) return err;
 
-	err = stats_write_db_wearables_array("ac", TOP_AC, true);
+	err = stats_write_db_wearables_hist("ac", WEAR_AC, 1);
 	if (err) return err;
 
-	err = stats_write_db_wearables_array("hit", TOP_PLUS, true);
+	err = stats_write_db_wearables_hist("hit", WEAR_HIT, 1);
 	if (err) return err;
 
-	err = stats_write_db_wearables_array("dam", TOP_PLUS, true);
+	err = stats_write_db_wearables_hist("dam", WEAR_DAM, 1);
 	if (err) return err;
 
-	err = stats_write_db_wearables_array("affixes", z_info->e_max, false);
+	err = stats_write_db_wearables_hist("power", WEAR_POWER, 1);
 	if (err) return err;
-	err = stats_write_db_wearables_array("themes", z_info->theme_max, false);
+
+	err = stats_write_db_wearables_hist("affixes", WEAR_AFFIXES, 1);
+	if (err) return err;
+
+	err = stats_write_db_wearables_hist("themes", WEAR_THEMES, 1);
 	if (err) return err;
 
-	err = stats_write_db_wearables_array("flags", OF_MAX, true);
+	err = stats_write_db_wearables_hist("flags", WEAR_FLAGS, 1);
 	if (err) return err;
 
-	err = stats_write_db_wearables_2d_array("pval_flags", TOP_PVAL, pval_flags_count + 1, false, true);
+	err = stats_write_db_wearables_hist("pval_flags", WEAR_PVAL_FLAGS, 2);
 	if (err) return err;
 
 	/* Commit transaction */
-	err = stats_db_exec("COMMIT;");
+	err = stats_db_bulk_end();
 	if (err) return err;
 
+	if (!quiet) {
+		printf("\nCheckpoint after %d runs:\n", run - 1);
+		stats_db_bulk_report();
+	}
+
 	return SQLITE_OK;
 }
 
+/*** Checkpoint files, for resuming runs and merging parallel workers ***/
+
+/**
+ * Function type for visiting one array of counters in level_data. Most
+ * counters are u32b; wide is set for the long long gold totals.
+ */
+typedef void (*stats_counter_visitor)(void *counters, size_t n, bool wide,
+	void *data);
+
+/**
+ * Visit every counter array in level_data, always in the same order.
+ */
+static void stats_walk_counters(stats_counter_visitor visit, void *data)
+{
+	int level, origin;
+
+	for (level = 0; level < LEVEL_MAX; level++) {
+		struct level_data *ld = &level_data[level];
+
+		visit(ld->monsters, z_info->r_max, FALSE, data);
+		visit(ld->vaults, vault_max, FALSE, data);
+		visit(ld->pits, z_info->pit_max + 1, FALSE, data);
+		visit(ld->obj_feelings, OBJ_FEEL_MAX, FALSE, data);
+		visit(ld->mon_feelings, MON_FEEL_MAX, FALSE, data);
+		visit(ld->gold, ORIGIN_STATS, TRUE, data);
+
+		for (origin = 0; origin < ORIGIN_STATS; origin++) {
+			visit(ld->artifacts[origin], z_info->a_max, FALSE, data);
+			visit(ld->consumables[origin], consumable_count + 1, FALSE,
+				data);
+			visit(ld->wearables[origin], wearable_count + 1, FALSE, data);
+		}
+	}
+}
+
+/**
+ * A shard stores only the nonzero counters, as (gap, value) pairs of
+ * variable-length integers. The gap is the distance in walk order from the
+ * previous stored counter; a zero gap ends the walk. The wearables
+ * histograms follow, as a count and then (key, value) pairs.
+ */
+struct stats_shard {
+	ang_file *f;
+	u32b pos;		/* walk position of the current counter, from 1 */
+	u32b last;		/* walk position of the last counter stored */
+	u32b next;		/* reading only: position of the next stored counter */
+	unsigned long long value;	/* reading only: its value */
+	bool ok;
+};
+
+static void stats_shard_put(struct stats_shard *sh, unsigned long long v)
+{
+	while (v >= 0x80) {
+		if (!file_writec(sh->f, (byte)(v & 0x7F) | 0x80)) sh->ok = FALSE;
+		v >>= 7;
+	}
+	if (!file_writec(sh->f, (byte)v)) sh->ok = FALSE;
+}
+
+static unsigned long long stats_shard_get(struct stats_shard *sh)
+{
+	unsigned long long v = 0;
+	int shift = 0;
+	byte b;
+
+	do {
+		if (!file_readc(sh->f, &b) || shift > 63) {
+			sh->ok = FALSE;
+			return 0;
+		}
+		v |= (unsigned long long)(b & 0x7F) << shift;
+		shift += 7;
+	} while (b & 0x80);
+
+	return v;
+}
+
+static void stats_shard_write_counters(void *counters, size_t n, bool wide,
+	void *data)
+{
+	struct stats_shard *sh = data;
+	size_t i;
+
+	for (i = 0; i < n; i++, sh->pos++) {
+		unsigned long long v = wide ? ((long long *)counters)[i]
+			: ((u32b *)counters)[i];
+		if (!v) continue;
+
+		stats_shard_put(sh, sh->pos - sh->last);
+		stats_shard_put(sh, v);
+		sh->last = sh->pos;
+	}
+}
+
+static void stats_shard_read_next(struct stats_shard *sh)
+{
+	u32b gap = stats_shard_get(sh);
+
+	/* A zero gap (or a read error) means no more counters */
+	if (!gap || !sh->ok) {
+		sh->next = 0;
+		return;
+	}
+
+	sh->next = sh->last + gap;
+	sh->value = stats_shard_get(sh);
+	sh->last = sh->next;
+}
+
+static void stats_shard_add_counters(void *counters, size_t n, bool wide,
+	void *data)
+{
+	struct stats_shard *sh = data;
+	size_t i;
+
+	for (i = 0; i < n; i++, sh->pos++) {
+		if (sh->pos != sh->next) continue;
+
+		if (wide)
+			((long long *)counters)[i] += sh->value;
+		else
+			((u32b *)counters)[i] += sh->value;
+
+		stats_shard_read_next(sh);
+	}
+}
+
+/**
+ * The header records the sizes of the variable-length arrays, so that a
+ * shard from a different game version is rejected rather than misread.
+ */
+static u32b stats_shard_header[10];
+
+static void stats_shard_fill_header(void)
+{
+	stats_shard_header[0] = SHARD_MAGIC;
+	stats_shard_header[1] = LEVEL_MAX;
+	stats_shard_header[2] = z_info->r_max;
+	stats_shard_header[3] = z_info->a_max;
+	stats_shard_header[4] = z_info->e_max;
+	stats_shard_header[5] = z_info->theme_max;
+	stats_shard_header[6] = consumable_count;
+	stats_shard_header[7] = wearable_count;
+	stats_shard_header[8] = vault_max;
+	stats_shard_header[9] = z_info->pit_max;
+}
+
+/**
+ * Write the header, the n values in info, and all nonzero counters in
+ * level_data to the file at path.
+ */
+static bool stats_write_shard(const char *path, const u32b *info, size_t n)
+{
+	struct stats_shard sh = { NULL, 1, 0, 0, 0, TRUE };
+	size_t i, iter = 0;
+	unsigned long long key;
+	u32b count;
+
+	sh.f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!sh.f) return FALSE;
+
+	stats_shard_fill_header();
+	for (i = 0; i < N_ELEMENTS(stats_shard_header); i++)
+		stats_shard_put(&sh, stats_shard_header[i]);
+	for (i = 0; i < n; i++)
+		stats_shard_put(&sh, info[i]);
+
+	stats_walk_counters(stats_shard_write_counters, &sh);
+	stats_shard_put(&sh, 0);
+
+	stats_shard_put(&sh, wearables_hist->used);
+	while (counters_next(wearables_hist, &iter, &key, &count)) {
+		stats_shard_put(&sh, key);
+		stats_shard_put(&sh, count);
+	}
+
+	if (!file_close(sh.f)) return FALSE;
+	return sh.ok;
+}
+
+/**
+ * Read the n values in info from the file at path and, if counters is set,
+ * add the counters stored there to those in level_data.
+ */
+static bool stats_read_shard(const char *path, u32b *info, size_t n,
+	bool counters)
+{
+	struct stats_shard sh = { NULL, 1, 0, 0, 0, TRUE };
+	size_t i;
+	unsigned long long num;
+
+	sh.f = file_open(path, MODE_READ, -1);
+	if (!sh.f) return FALSE;
+
+	stats_shard_fill_header();
+	for (i = 0; i < N_ELEMENTS(stats_shard_header); i++)
+		if (stats_shard_get(&sh) != stats_shard_header[i])
+			sh.ok = FALSE;
+	for (i = 0; i < n && sh.ok; i++)
+		info[i] = stats_shard_get(&sh);
+
+	if (sh.ok && counters) {
+		stats_shard_read_next(&sh);
+		stats_walk_counters(stats_shard_add_counters, &sh);
+
+		/* Everything stored should have been consumed */
+		if (sh.next) sh.ok = FALSE;
+
+		for (num = stats_shard_get(&sh); num && sh.ok; num--) {
+			unsigned long long key = stats_shard_get(&sh);
+			u32b count = stats_shard_get(&sh);
+
+			if (sh.ok) counters_add(wearables_hist, key, count);
+		}
+	}
+
+	file_close(sh.f);
+	return sh.ok;
+}
+
+/**
+ * The run settings and progress saved in each checkpoint, ahead of the
+ * counters. Settings given on the command line are ignored on resuming,
+ * in favour of these.
+ */
+enum {
+	CKPT_SEED,
+	CKPT_RUNS,
+	CKPT_WORKERS,
+	CKPT_RANDARTS,
+	CKPT_NO_SELLING,
+	CKPT_DONE,		/* last run whose counters are included */
+	CKPT_MAX
+};
+
+/**
+ * Each process making runs keeps its own checkpoint beside the database,
+ * numbered by worker; a serial run is worker 0 of 1.
+ */
+static void stats_checkpoint_path(char *buf, size_t len, int worker)
+{
+	strnfmt(buf, len, "%s.%d.ckpt", stats_db_filename(), worker);
+}
+
+/**
+ * Each run saves its counters here, for the process which forked it.
+ */
+static void stats_run_path(char *buf, size_t len, int worker)
+{
+	strnfmt(buf, len, "%s.%d.run", stats_db_filename(), worker);
+}
+
+/**
+ * Save level_data as worker's checkpoint, with done as the last run made.
+ * The old checkpoint is only replaced once the new one is complete.
+ */
+static bool stats_write_checkpoint(int worker, u32b done)
+{
+	char path[1024], tmp[1024];
+	u32b info[CKPT_MAX];
+
+	info[CKPT_SEED] = seed_base;
+	info[CKPT_RUNS] = num_runs;
+	info[CKPT_WORKERS] = num_workers;
+	info[CKPT_RANDARTS] = randarts;
+	info[CKPT_NO_SELLING] = no_selling;
+	info[CKPT_DONE] = done;
+
+	stats_checkpoint_path(path, sizeof(path), worker);
+	strnfmt(tmp, sizeof(tmp), "%s.tmp", path);
+
+	if (!stats_write_shard(tmp, info, CKPT_MAX)) return FALSE;
+	return file_move(tmp, path);
+}
+
+/**
+ * Add worker's checkpoint to level_data, returning the last run it
+ * includes, or first - 1 if the worker never saved one.
+ */
+static u32b stats_read_checkpoint(int worker, u32b first)
+{
+	char path[1024];
+	u32b info[CKPT_MAX];
+
+	stats_checkpoint_path(path, sizeof(path), worker);
+	if (!file_exists(path)) return first - 1;
+
+	if (!stats_read_shard(path, info, CKPT_MAX, TRUE))
+		quit_fmt("Couldn't read checkpoint %s!", path);
+
+	return info[CKPT_DONE];
+}
+
+static void stats_delete_checkpoints(void)
+{
+	char path[1024], tmp[1024];
+	int w;
+
+	for (w = 0; w < num_workers; w++) {
+		stats_checkpoint_path(path, sizeof(path), w);
+		strnfmt(tmp, sizeof(tmp), "%s.tmp", path);
+		file_delete(path);
+		file_delete(tmp);
+		stats_run_path(path, sizeof(path), w);
+		file_delete(path);
+	}
+}
+
 /**
  * Call with the number of runs that have been completed.
  */
 
 #define STATS_PROGRESS_BAR_LEN 30
 
-void progress_bar(u32b run, time_t start) {
+void progress_bar(u32b run, u32b total, time_t start) {
 	u32b i;
-	u32b n = (run * STATS_PROGRESS_BAR_LEN) / num_runs;
-	u32b p10 = ((long long)run * 1000) / num_runs;
+	u32b n = (run * STATS_PROGRESS_BAR_LEN) / total;
+	u32b p10 = ((long long)run * 1000) / total;
 
 	time_t delta = time(NULL) - start;
-	u32b togo = num_runs - run;
-	u32b expect = delta ? ((long long)delta * (long long)togo) / run
+	u32b togo = total - run;
+	u32b expect = (delta && run) ? ((long long)delta * (long long)togo) / run
 		: 0;
 
 	int h = expect / 3600;
@@ -1648,7 +1938,7 @@ void progress_bar(u32b run, time_t start) {
 	printf("\r|");
 	for (i = 0; i < n; i++) printf("*");
 	for (i = 0; i < STATS_PROGRESS_BAR_LEN - n; i++) printf(" ");
-	printf("| %d/%d (%5.1f%%) %3d:%02d:%02d ", run, num_runs, p10/10.0, h, m, s);
+	printf("| %d/%d (%5.1f%%) %3d:%02d:%02d ", run, total, p10/10.0, h, m, s);
 	fflush(stdout);
 }
 
@@ -1663,82 +1953,297 @@ static void stats_cleanup_angband_run(void)
 	if (p_ptr->history) FREE(p_ptr->history);
 }
 
-static errr run_stats(void)
+static void stats_wipe_counters_aux(void *counters, size_t n, bool wide,
+	void *data)
 {
-	u32b run;
-	artifact_type *a_info_save;
-	unsigned int i;
-	int err;
-	bool status;
+	memset(counters, 0, n * (wide ? sizeof(long long) : sizeof(u32b)));
+}
 
-	time_t start;
+/**
+ * Zero every counter in level_data and the wearables histograms.
+ */
+static void stats_wipe_counters(void)
+{
+	stats_walk_counters(stats_wipe_counters_aux, NULL);
 
-	prep_output_dir();
-	create_indices();
-	alloc_memory();
-	if (randarts)
-	{
-		a_info_save = mem_zalloc(z_info->a_max * sizeof(artifact_type));
-		for (i = 0; i < z_info->a_max; i++)
-		{
-			if (!a_info[i].name) continue;
+	counters_free(wearables_hist);
+	wearables_hist = counters_new();
+}
 
-			memcpy(&a_info_save[i], &a_info[i], sizeof(artifact_type));
-		}
-	}
+/**
+ * Make one run in a child process and add its counters to level_data.
+ *
+ * Running the game leaves state behind in many places (the monster and
+ * object lists, lore, the allocation tables, the level cache and so on),
+ * so rather than trying to reset all of it, every run is forked from a
+ * process which has only been initialised. A run then makes the same
+ * dungeon whether it comes first in a serial run or last in a worker.
+ */
+static void stats_make_run(int worker, u32b run)
+{
+	char path[1024];
+	pid_t pid;
+	int status;
 
-	if (!quiet) printf("Creating the database and dumping info...\n");
-	status = stats_prep_db();
-	if (!status) quit("Couldn't prepare database!");
+	stats_run_path(path, sizeof(path), worker);
 
-	if (!quiet) {
-		printf("Beginning %d runs...\n", num_runs);
-		fflush(stdout);
-	}
+	/* Don't let the child inherit unflushed output */
+	fflush(stdout);
 
-	start = time(NULL);
-	for (run = 1; run <= num_runs; run++)
-	{
-		if (!quiet) progress_bar(run - 1, start);
+	pid = fork();
+	if (pid < 0) quit("Couldn't fork a stats run!");
 
-		if (randarts)
-		{
-			for (i = 0; i < z_info->a_max; i++)
-			{
-				memcpy(&a_info[i], &a_info_save[i], sizeof(artifact_type));
-			}
-		}
+	if (pid == 0)
+	{
+		stats_wipe_counters();
 
-		initialize_character();
+		initialize_character(run);
 		unkill_uniques();
 		reset_artifacts();
 		descend_dungeon();
 		stats_cleanup_angband_run();
 
+		fflush(stdout);
+		_exit(stats_write_shard(path, NULL, 0) ? 0 : 1);
+	}
+
+	if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+			WEXITSTATUS(status) || !stats_read_shard(path, NULL, 0, TRUE))
+		quit_fmt("Stats run %d failed!", run);
+
+	file_delete(path);
+}
+
+/**
+ * Find the runs which make up worker's share.
+ */
+static void stats_worker_share(int worker, u32b *first, u32b *last)
+{
+	u32b share = num_runs / num_workers;
+	u32b extra = num_runs % num_workers;
+	u32b w = worker;
+
+	*first = 1 + w * share + MIN(w, extra);
+	*last = *first + share - 1 + (w < extra ? 1 : 0);
+}
+
+/**
+ * Make worker's share of the runs, adding the results to level_data and
+ * checkpointing as we go. When resuming, start after the worker's last
+ * checkpoint. Only a serial run writes the database, and only one process
+ * at a time should pass report.
+ */
+static void stats_do_runs(int worker, bool report)
+{
+	u32b first, last, run;
+	int err;
+	time_t start;
+
+	stats_worker_share(worker, &first, &last);
+
+	if (resume)
+		first = stats_read_checkpoint(worker, first) + 1;
+	else if (!stats_write_checkpoint(worker, first - 1))
+		quit("Couldn't write a checkpoint!");
+
+	start = time(NULL);
+	for (run = first; run <= last; run++)
+	{
+		if (report && !quiet)
+			progress_bar(run - first, last - first + 1, start);
+
+		stats_make_run(worker, run);
+
 		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0)
+		if (run % checkpoint_runs == 0)
 		{
-			err = stats_write_db(run);
-			if (err)
+			if (num_workers == 1)
 			{
-				stats_db_close();
-				quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+				err = stats_write_db(run + 1);
+				if (err)
+				{
+					stats_db_close();
+					quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+				}
 			}
+
+			if (!stats_write_checkpoint(worker, run))
+				quit("Couldn't write a checkpoint!");
 		}
 
-		if (quiet && run % 1000 == 0) {
+		if (report && quiet && run % 1000 == 0) {
 			printf("Finished %d runs.\n", run);
 			fflush(stdout);
 		}
 	}
 
+	if (report && !quiet && first <= last)
+		progress_bar(last - first + 1, last - first + 1, start);
+
+	/* The last checkpoint is also what the parent merges */
+	if (!stats_write_checkpoint(worker, last))
+		quit("Couldn't write a checkpoint!");
+}
+
+/**
+ * Body of a forked worker: make its share of the runs and exit without
+ * touching the parent's database connection.
+ */
+static void stats_run_worker(int worker)
+{
+	/* Only the first worker reports progress */
+	if (worker) quiet = TRUE;
+
+	stats_do_runs(worker, worker == 0);
+
+	fflush(stdout);
+	_exit(0);
+}
+
+/**
+ * Split the runs between num_workers child processes, wait for them all,
+ * and then sum their final checkpoints into level_data.
+ */
+static void stats_run_workers(void)
+{
+	pid_t pids[MAX_WORKERS];
+	int w;
+
+	/* Don't let the children inherit unflushed output */
+	fflush(stdout);
+
+	for (w = 0; w < num_workers; w++)
+	{
+		pids[w] = fork();
+		if (pids[w] < 0)
+		{
+			stats_db_close();
+			quit("Couldn't fork a stats worker!");
+		}
+		if (pids[w] == 0)
+			stats_run_worker(w);
+	}
+
+	for (w = 0; w < num_workers; w++)
+	{
+		int status;
+
+		if (waitpid(pids[w], &status, 0) < 0 || !WIFEXITED(status) ||
+				WEXITSTATUS(status))
+		{
+			stats_db_close();
+			quit_fmt("Stats worker %d failed!", w);
+		}
+	}
+
+	if (!quiet) printf("\nMerging %d checkpoints...", num_workers);
+
+	for (w = 0; w < num_workers; w++)
+	{
+		u32b first, last;
+
+		stats_worker_share(w, &first, &last);
+		if (stats_read_checkpoint(w, first) != last)
+		{
+			stats_db_close();
+			quit_fmt("Worker %d's checkpoint is incomplete!", w);
+		}
+	}
+}
+
+/**
+ * Reopen the database named by resume_name, or failing that the newest
+ * one in the stats directory which has a checkpoint, and take the run
+ * settings from its first checkpoint.
+ */
+static bool stats_resume_db(void)
+{
+	char path[1024];
+	u32b info[CKPT_MAX];
+
+	if (!resume_name[0])
+	{
+		char name[256];
+		ang_dir *dir = my_dopen(ANGBAND_DIR_STATS);
+
+		if (!dir) return false;
+
+		while (my_dread(dir, name, sizeof(name)))
+		{
+			size_t len = strlen(name);
+
+			/* Checkpoint 0 always exists, so look for that */
+			if (len < 8 || !streq(name + len - 7, ".0.ckpt")) continue;
+			name[len - 7] = '\0';
+
+			if (strcmp(name, resume_name) > 0)
+				my_strcpy(resume_name, name, sizeof(resume_name));
+		}
+		my_dclose(dir);
+
+		if (!resume_name[0]) return false;
+	}
+
+	if (!stats_db_reopen(resume_name)) return false;
+
+	stats_checkpoint_path(path, sizeof(path), 0);
+	if (!stats_read_shard(path, info, CKPT_MAX, FALSE)) return false;
+
+	seed_base = info[CKPT_SEED];
+	num_runs = info[CKPT_RUNS];
+	num_workers = info[CKPT_WORKERS];
+	randarts = info[CKPT_RANDARTS];
+	no_selling = info[CKPT_NO_SELLING];
+
+	return num_workers >= 1 && num_workers <= MAX_WORKERS;
+}
+
+static errr run_stats(void)
+{
+	int err;
+	bool status;
+
+	prep_output_dir();
+	create_indices();
+	alloc_memory();
+
+	gen_restart_hook = stats_gen_restart;
+	gen_vault_hook = stats_gen_vault;
+	gen_pit_hook = stats_gen_pit;
+
+	if (resume)
+	{
+		if (!stats_resume_db()) quit("Couldn't find a run to resume!");
+		if (!quiet) printf("Resuming %s...\n", stats_db_filename());
+	}
+	else
+	{
+		if (!quiet) printf("Creating the database and dumping info...\n");
+		status = stats_prep_db();
+		if (!status) quit("Couldn't prepare database!");
+	}
+
+	if (!quiet) {
+		if (num_workers > 1)
+			printf("Beginning %d runs in %d workers...\n", num_runs,
+				num_workers);
+		else
+			printf("Beginning %d runs...\n", num_runs);
+		fflush(stdout);
+	}
+
+	if (num_workers > 1)
+		stats_run_workers();
+	else
+		stats_do_runs(0, TRUE);
+
 	if (!quiet) {
-		progress_bar(num_runs, start);
 		printf("\nSaving the data...\n");
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
+	err = stats_write_db(num_runs + 1);
+	if (!err) stats_delete_checkpoints();
 	stats_db_close();
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 	free_stats_memory();
@@ -1870,22 +2375,32 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -j(# of workers) -S(eed) -k(# of runs per checkpoint) -c(ontinue)";
 
 /*
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-jNN] [-SNNNN] [-kNNNN]
+ *                      [-c[NAME]]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -jNN    Split the runs between NN worker processes (default: 1)
+ *   -SNNNN  Seed run N with NNNN + N, so results can be reproduced whatever
+ *           the number of workers (default: the current time)
+ *   -kNNNN  Checkpoint every NNNN runs (default: 20000)
+ *   -c      Continue the newest interrupted run from its last checkpoint,
+ *           with the settings it was started with
+ *   -cNAME  Continue the interrupted run whose database is NAME
  */
 
 errr init_stats(int argc, char *argv[]) {
 	int i;
 
+	seed_base = time(NULL);
+
 	/* Skip over argv[0] */
 	for (i = 1; i < argc; i++) {
 		if (streq(argv[i], "-r")) {
@@ -1904,9 +2419,30 @@ errr init_stats(int argc, char *argv[]) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = atoi(&argv[i][2]);
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = strtoul(&argv[i][2], NULL, 10);
+			continue;
+		}
+		if (prefix(argv[i], "-k")) {
+			checkpoint_runs = MAX(1, atoi(&argv[i][2]));
+			continue;
+		}
+		if (prefix(argv[i], "-c")) {
+			resume = TRUE;
+			my_strcpy(resume_name, &argv[i][2], sizeof(resume_name));
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
+	/* There's no point in idle workers */
+	num_workers = MAX(1, MIN(num_workers, MAX_WORKERS));
+	if ((u32b)num_workers > num_runs) num_workers = MAX(1, num_runs);
+
 	term_data_link(0);
 	return 0;
 }
@@ -25,6 +25,19 @@
  */
 #define MONSTER_FLOW_DEPTH 32
 
+/*
+ * How far (and for how many turns) the noise of the player fighting,
+ * digging and bashing doors carries
+ */
+#define NOISE_FIGHT 10
+#define NOISE_DIG 15
+#define NOISE_BASH 20
+
+/*
+ * How many player turns the player's trail stays fresh enough to follow
+ */
+#define SCENT_FRESH 20
+
 
 /*** Monster blow constants ***/
 #define MONSTER_BLOW_MAX 4
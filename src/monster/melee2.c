@@ -129,6 +129,9 @@ static void remove_bad_spells(int m_idx, bitflag f[RSF_SIZE])
 static bool summon_possible(int y1, int x1)
 {
 	int y, x;
+	struct los_source from;
+
+	los_source_init(&from, y1, x1);
 
 	/* Start at the location, and check 2 grids in each dir */
 	for (y = y1 - 2; y <= y1 + 2; y++)
@@ -142,10 +145,10 @@ static bool summon_possible(int y1, int x1)
 			if (distance(y1, x1, y, x) > 2) continue;
 
 			/* Hack: no summon on glyph of warding */
-			if (cave->feat[y][x] == FEAT_GLYPH) continue;
+			if (cave_feat(cave, y, x) == FEAT_GLYPH) continue;
 
 			/* Require empty floor grid in line of sight */
-			if (cave_empty_bold(y, x) && los(y1, x1, y, x))
+			if (cave_empty_bold(y, x) && los_from(&from, y, x))
 			{
 				return (TRUE);
 			}
@@ -628,18 +631,18 @@ static bool get_moves_aux(struct cave *c, int m_idx, int *yp, int *xp)
 	x1 = m_ptr->fx;
 
 	/* The player is not currently near the monster grid */
-	if (c->when[y1][x1] < c->when[py][px])
+	if (cave_when(c, y1, x1) < cave_when(c, py, px))
 	{
 		/* The player has never been near the monster grid */
-		if (c->when[y1][x1] == 0) return (FALSE);
+		if (cave_when(c, y1, x1) == 0) return (FALSE);
 
 		/* The monster is not allowed to track the player */
 		if (!OPT(birth_ai_smell)) return (FALSE);
 	}
 
 	/* Monster is too far away to notice the player */
-	if (c->cost[y1][x1] > MONSTER_FLOW_DEPTH) return (FALSE);
-	if (c->cost[y1][x1] > r_ptr->aaf) return (FALSE);
+	if (cave_cost(c, y1, x1) > MONSTER_FLOW_DEPTH) return (FALSE);
+	if (cave_cost(c, y1, x1) > r_ptr->aaf) return (FALSE);
 
 	/* Hack -- Player can see us, run towards him */
 	if (player_has_los_bold(y1, x1)) return (FALSE);
@@ -652,17 +655,17 @@ static bool get_moves_aux(struct cave *c, int m_idx, int *yp, int *xp)
 		x = x1 + ddx_ddd[i];
 
 		/* Ignore illegal locations */
-		if (c->when[y][x] == 0) continue;
+		if (cave_when(c, y, x) == 0) continue;
 
 		/* Ignore ancient locations */
-		if (c->when[y][x] < when) continue;
+		if (cave_when(c, y, x) < when) continue;
 
 		/* Ignore distant locations */
-		if (c->cost[y][x] > cost) continue;
+		if (cave_cost(c, y, x) > cost) continue;
 
 		/* Save the cost and time */
-		when = c->when[y][x];
-		cost = c->cost[y][x];
+		when = cave_when(c, y, x);
+		cost = cave_cost(c, y, x);
 
 		/* Hack -- Save the "twiddled" location */
 		(*yp) = py + 16 * ddy_ddd[i];
@@ -705,15 +708,15 @@ static bool get_fear_moves_aux(struct cave *c, int m_idx, int *yp, int *xp)
 	x1 = fx - (*xp);
 
 	/* The player is not currently near the monster grid */
-	if (c->when[fy][fx] < c->when[py][px])
+	if (cave_when(c, fy, fx) < cave_when(c, py, px))
 	{
 		/* No reason to attempt flowing */
 		return (FALSE);
 	}
 
 	/* Monster is too far away to use flow information */
-	if (c->cost[fy][fx] > MONSTER_FLOW_DEPTH) return (FALSE);
-	if (c->cost[fy][fx] > r_ptr->aaf) return (FALSE);
+	if (cave_cost(c, fy, fx) > MONSTER_FLOW_DEPTH) return (FALSE);
+	if (cave_cost(c, fy, fx) > r_ptr->aaf) return (FALSE);
 
 	/* Check nearby grids, diagonals first */
 	for (i = 7; i >= 0; i--)
@@ -725,16 +728,16 @@ static bool get_fear_moves_aux(struct cave *c, int m_idx, int *yp, int *xp)
 		x = fx + ddx_ddd[i];
 
 		/* Ignore illegal locations */
-		if (c->when[y][x] == 0) continue;
+		if (cave_when(c, y, x) == 0) continue;
 
 		/* Ignore ancient locations */
-		if (c->when[y][x] < when) continue;
+		if (cave_when(c, y, x) < when) continue;
 
 		/* Calculate distance of this grid from our destination */
 		dis = distance(y, x, y1, x1);
 
 		/* Score this grid */
-		s = 5000 / (dis + 3) - 500 / (c->cost[y][x] + 1);
+		s = 5000 / (dis + 3) - 500 / (cave_cost(c, y, x) + 1);
 
 		/* No negative scores */
 		if (s < 0) s = 0;
@@ -743,7 +746,7 @@ static bool get_fear_moves_aux(struct cave *c, int m_idx, int *yp, int *xp)
 		if (s < score) continue;
 
 		/* Save the score and time */
-		when = c->when[y][x];
+		when = cave_when(c, y, x);
 		score = s;
 
 		/* Save the location */
@@ -950,10 +953,10 @@ static bool find_safety(struct cave *c, int m_idx, int *yp, int *xp)
 			if (!cave_floor_bold(y, x)) continue;
 
 			/* Ignore grids very far from the player */
-			if (c->when[y][x] < c->when[py][px]) continue;
+			if (cave_when(c, y, x) < cave_when(c, py, px)) continue;
 
 			/* Ignore too-distant grids */
-			if (c->cost[y][x] > c->cost[fy][fx] + 2 * d) continue;
+			if (cave_cost(c, y, x) > cave_cost(c, fy, fx) + 2 * d) continue;
 
 			/* Check for absence of shot (more or less) */
 			if (!player_has_los_bold(y,x))
@@ -1070,6 +1073,29 @@ static bool find_hiding(int m_idx, int *yp, int *xp)
 }
 
 
+/*
+ * Whether a monster has any sign of the player: the player is within range
+ * or in view, or has been heard nearby, or has left a fresh trail where the
+ * monster stands.  A monster with none has nowhere to hide from yet, so it
+ * is spared the searches in find_hiding() and find_safety().
+ */
+static bool monster_senses_player(struct cave *c, int m_idx)
+{
+	monster_type *m_ptr = cave_monster(c, m_idx);
+	monster_race *r_ptr = &r_info[m_ptr->r_idx];
+	int fy = m_ptr->fy;
+	int fx = m_ptr->fx;
+	int age;
+
+	if (m_ptr->cdis <= r_ptr->aaf) return (TRUE);
+	if (player_has_los_bold(fy, fx)) return (TRUE);
+	if (cave_noise(c, fy, fx)) return (TRUE);
+
+	age = cave_scent_age(c, fy, fx);
+	return (age >= 0 && age < SCENT_FRESH);
+}
+
+
 /*
  * Choose "logical" directions for monster movement
  *
@@ -1113,8 +1139,8 @@ static bool get_moves(struct cave *c, int m_idx, int mm[5])
 		{
 			/* Check grid around the player for room interior (room walls count)
 			   or other empty space */
-			if ((cave->feat[py + ddy_ddd[i]][px + ddx_ddd[i]] <= FEAT_MORE) ||
-				(cave->info[py + ddy_ddd[i]][px + ddx_ddd[i]] & (CAVE_ROOM)))
+			if ((cave_feat(cave, py + ddy_ddd[i], px + ddx_ddd[i]) <= FEAT_MORE) ||
+				(cave_info(cave, py + ddy_ddd[i], px + ddx_ddd[i]) & (CAVE_ROOM)))
 			{
 				/* One more open grid */
 				open++;
@@ -1122,7 +1148,8 @@ static bool get_moves(struct cave *c, int m_idx, int mm[5])
 		}
 
 		/* Not in an empty space and strong player */
-		if ((open < 7) && (p_ptr->chp > p_ptr->mhp / 2))
+		if ((open < 7) && (p_ptr->chp > p_ptr->mhp / 2) &&
+				monster_senses_player(c, m_idx))
 		{
 			/* Find hiding place */
 			if (find_hiding(m_idx, &y, &x)) done = TRUE;
@@ -1134,7 +1161,8 @@ static bool get_moves(struct cave *c, int m_idx, int mm[5])
 	if (!done && mon_will_run(m_idx))
 	{
 		/* Try to find safe place */
-		if (!(OPT(birth_ai_smart) && find_safety(c, m_idx, &y, &x)))
+		if (!(OPT(birth_ai_smart) && monster_senses_player(c, m_idx) &&
+				find_safety(c, m_idx, &y, &x)))
 		{
 			/* This is not a very "smart" method XXX XXX */
 			y = (-y);
@@ -2923,7 +2951,7 @@ static void process_monster(struct cave *c, int m_idx)
 		for (k = 0, y = oy - 1; y <= oy + 1; y++)
 			for (x = ox - 1; x <= ox + 1; x++)
 				/* Count monsters */
-				if (cave->m_idx[y][x] > 0) k++;
+				if (cave_m_idx(cave, y, x) > 0) k++;
 
 		/* Multiply slower in crowded areas */
 		if ((k < 4) && (k == 0 || one_in_(k * MON_MULT_ADJ))) {
@@ -3018,7 +3046,7 @@ static void process_monster(struct cave *c, int m_idx)
 			do_move = TRUE;
 
 		/* Permanent wall in the way */
-		else if (cave->feat[ny][nx] >= FEAT_PERM_EXTRA)
+		else if (cave_feat(cave, ny, nx) >= FEAT_PERM_EXTRA)
 		{
 			/* Nothing */
 		}
@@ -3043,7 +3071,7 @@ static void process_monster(struct cave *c, int m_idx)
 				do_move = TRUE;
 
 				/* Forget the wall */
-				cave->info[ny][nx] &= ~(CAVE_MARK);
+				cave_info_off(cave, ny, nx, CAVE_MARK);
 
 				/* Notice */
 				cave_set_feat(c, ny, nx, FEAT_FLOOR);
@@ -3052,9 +3080,9 @@ static void process_monster(struct cave *c, int m_idx)
 				if (player_has_los_bold(ny, nx)) do_view = TRUE;
 
 			/* Handle doors and secret doors */
-			} else if (((cave->feat[ny][nx] >= FEAT_DOOR_HEAD) &&
-						 (cave->feat[ny][nx] <= FEAT_DOOR_TAIL)) ||
-						(cave->feat[ny][nx] == FEAT_SECRET)) {
+			} else if (((cave_feat(cave, ny, nx) >= FEAT_DOOR_HEAD) &&
+						 (cave_feat(cave, ny, nx) <= FEAT_DOOR_TAIL)) ||
+						(cave_feat(cave, ny, nx) == FEAT_SECRET)) {
 				bool may_bash = TRUE;
 
 				/* Take a turn */
@@ -3069,8 +3097,8 @@ static void process_monster(struct cave *c, int m_idx)
 				/* Creature can open doors. */
 				if (rf_has(r_ptr->flags, RF_OPEN_DOOR))	{
 					/* Closed doors and secret doors */
-					if ((cave->feat[ny][nx] == FEAT_DOOR_HEAD) ||
-							 (cave->feat[ny][nx] == FEAT_SECRET)) {
+					if ((cave_feat(cave, ny, nx) == FEAT_DOOR_HEAD) ||
+							 (cave_feat(cave, ny, nx) == FEAT_SECRET)) {
 						/* The door is open */
 						did_open_door = TRUE;
 
@@ -3078,11 +3106,11 @@ static void process_monster(struct cave *c, int m_idx)
 						may_bash = FALSE;
 
 					/* Locked doors (not jammed) */
-					} else if (cave->feat[ny][nx] < FEAT_DOOR_HEAD + 0x08) {
+					} else if (cave_feat(cave, ny, nx) < FEAT_DOOR_HEAD + 0x08) {
 						int k;
 
 						/* Door power */
-						k = ((cave->feat[ny][nx] - FEAT_DOOR_HEAD) & 0x07);
+						k = ((cave_feat(cave, ny, nx) - FEAT_DOOR_HEAD) & 0x07);
 
 						/* Try to unlock it */
 						if (randint0(m_ptr->hp / 10) > k) {
@@ -3093,7 +3121,7 @@ static void process_monster(struct cave *c, int m_idx)
 								msg("Something fiddles with a lock.");
 
 							/* Reduce the power of the door by one */
-							cave_set_feat(c, ny, nx, cave->feat[ny][nx] - 1);
+							cave_set_feat(c, ny, nx, cave_feat(cave, ny, nx) - 1);
 
 							/* Do not bash the door */
 							may_bash = FALSE;
@@ -3106,7 +3134,7 @@ static void process_monster(struct cave *c, int m_idx)
 					int k;
 
 					/* Door power */
-					k = ((cave->feat[ny][nx] - FEAT_DOOR_HEAD) & 0x07);
+					k = ((cave_feat(cave, ny, nx) - FEAT_DOOR_HEAD) & 0x07);
 
 					/* Attempt to bash */
 					if (randint0(m_ptr->hp / 10) > k) {
@@ -3117,10 +3145,10 @@ static void process_monster(struct cave *c, int m_idx)
 							msg("Something slams against a door.");
 
 						/* Reduce the power of the door by one */
-						cave_set_feat(c, ny, nx, cave->feat[ny][nx] - 1);
+						cave_set_feat(c, ny, nx, cave_feat(cave, ny, nx) - 1);
 
 						/* If the door is no longer jammed */
-						if (cave->feat[ny][nx] < FEAT_DOOR_HEAD + 0x09)	{
+						if (cave_feat(cave, ny, nx) < FEAT_DOOR_HEAD + 0x09)	{
 							msg("You hear a door burst open!");
 
 							/* Disturb (sometimes) */
@@ -3154,18 +3182,18 @@ static void process_monster(struct cave *c, int m_idx)
 
 
 		/* Hack -- check for Glyph of Warding */
-		if (do_move && (cave->feat[ny][nx] == FEAT_GLYPH)) {
+		if (do_move && (cave_feat(cave, ny, nx) == FEAT_GLYPH)) {
 			/* Assume no move allowed */
 			do_move = FALSE;
 
 			/* Break the ward */
 			if (randint1(BREAK_GLYPH) < r_ptr->level) {
 				/* Describe observable breakage */
-				if (cave->info[ny][nx] & (CAVE_MARK))
+				if (cave_info(cave, ny, nx) & (CAVE_MARK))
 					msg("The rune of protection is broken!");
 
 				/* Forget the rune */
-				cave->info[ny][nx] &= ~CAVE_MARK;
+				cave_info_off(cave, ny, nx, CAVE_MARK);
 
 				/* Break the rune */
 				cave_set_feat(c, ny, nx, FEAT_FLOOR);
@@ -3177,7 +3205,7 @@ static void process_monster(struct cave *c, int m_idx)
 
 
 		/* The player is in the way. */
-		if (do_move && (cave->m_idx[ny][nx] < 0)) {
+		if (do_move && (cave_m_idx(cave, ny, nx) < 0)) {
 			/* Learn about if the monster attacks */
 			if (m_ptr->ml)
 				rf_on(l_ptr->flags, RF_NEVER_BLOW);
@@ -3213,7 +3241,7 @@ static void process_monster(struct cave *c, int m_idx)
 
 
 		/* A monster is in the way */
-		if (do_move && (cave->m_idx[ny][nx] > 0)) {
+		if (do_move && (cave_m_idx(cave, ny, nx) > 0)) {
 			monster_type *n_ptr = cave_monster_at(cave, ny, nx);
 
 			/* Kill weaker monsters */
@@ -3280,7 +3308,7 @@ static void process_monster(struct cave *c, int m_idx)
 				disturb(p_ptr, 0, 0);
 
 			/* Scan all objects in the grid */
-			for (this_o_idx = cave->o_idx[ny][nx]; this_o_idx;
+			for (this_o_idx = cave_o_idx(cave, ny, nx); this_o_idx;
 					this_o_idx = next_o_idx) {
 				object_type *o_ptr;
 
@@ -3389,10 +3417,7 @@ static void process_monster(struct cave *c, int m_idx)
 	/* Notice changes in view */
 	if (do_view) {
 		/* Update the visuals */
-		p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
-
-		/* Fully update the flow XXX XXX XXX */
-		p_ptr->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
+		p_ptr->update |= (PU_UPDATE_VIEW);
 	}
 
 
@@ -3420,9 +3445,9 @@ static bool monster_can_flow(struct cave *c, int m_idx)
 	fx = m_ptr->fx;
 
 	/* Check the flow (normal aaf is about 20) */
-	if ((c->when[fy][fx] == c->when[p_ptr->py][p_ptr->px]) &&
-	    (c->cost[fy][fx] < MONSTER_FLOW_DEPTH) &&
-	    (c->cost[fy][fx] < r_ptr->aaf))
+	if ((cave_when(c, fy, fx) == cave_when(c, p_ptr->py, p_ptr->px)) &&
+	    (cave_cost(c, fy, fx) < MONSTER_FLOW_DEPTH) &&
+	    (cave_cost(c, fy, fx) < r_ptr->aaf))
 		return TRUE;
 	return FALSE;
 }
@@ -3449,6 +3474,11 @@ static bool monster_can_flow(struct cave *c, int m_idx)
  *
  * Note the special "MFLAG_NICE" flag, which prevents "nasty" monsters from
  * using any of their spell attacks until the player gets a turn.
+ *
+ * Only the monsters marked by cave_monster_set_ready() can have the energy
+ * to move, so the rest are passed over without being looked at.  A monster
+ * of normal speed has the energy to move on one game turn in ten, so on a
+ * crowded level most of them are passed over on any given turn.
  */
 void process_monsters(struct cave *c, byte minimum_energy)
 {
@@ -3463,6 +3493,13 @@ void process_monsters(struct cave *c, byte minimum_energy)
 		/* Handle "leaving" */
 		if (p_ptr->leaving) break;
 
+		/* Skip the monsters without the energy to move */
+		if (minimum_energy >= 100)
+		{
+			i = cave_monster_prev_ready(c, i);
+			if (!i) break;
+		}
+
 
 		/* Get the monster */
 		m_ptr = cave_monster(cave, i);
@@ -3473,11 +3510,18 @@ void process_monsters(struct cave *c, byte minimum_energy)
 
 
 		/* Not enough energy to move */
-		if (m_ptr->energy < minimum_energy) continue;
+		if (m_ptr->energy < minimum_energy)
+		{
+			if (m_ptr->energy < 100) cave_monster_set_ready(c, i, FALSE);
+			continue;
+		}
 
 		/* Use up "some" energy */
 		m_ptr->energy -= 100;
 
+		/* Wait for more */
+		if (m_ptr->energy < 100) cave_monster_set_ready(c, i, FALSE);
+
 
 		/* Heal monster? XXX XXX XXX */
 
@@ -61,7 +61,7 @@ void delete_monster_idx(int m_idx)
 	if (p_ptr->health_who == m_ptr) health_track(p_ptr, NULL);
 
 	/* Monster is gone */
-	cave->m_idx[y][x] = 0;
+	cave_set_m_idx(cave, y, x, 0);
 
 	/* Delete objects */
 	for (this_o_idx = m_ptr->hold_o_idx; this_o_idx; this_o_idx = next_o_idx)
@@ -110,8 +110,8 @@ void delete_monster(int y, int x)
 	assert(in_bounds(y, x));
 
 	/* Delete the monster (if any) */
-	if (cave->m_idx[y][x] > 0)
-		delete_monster_idx(cave->m_idx[y][x]);
+	if (cave_m_idx(cave, y, x) > 0)
+		delete_monster_idx(cave_m_idx(cave, y, x));
 }
 
 
@@ -135,7 +135,7 @@ static void compact_monsters_aux(int i1, int i2)
 	x = m_ptr->fx;
 
 	/* Update the cave */
-	cave->m_idx[y][x] = i2;
+	cave_set_m_idx(cave, y, x, i2);
 	
 	/* Update midx */
 	m_ptr->midx = i2;
@@ -177,6 +177,9 @@ static void compact_monsters_aux(int i1, int i2)
 	/* Hack -- move monster */
 	COPY(cave_monster(cave, i2), cave_monster(cave, i1), struct monster);
 
+	/* Its readiness to act goes with it */
+	cave_monster_set_ready(cave, i2, m_ptr->energy >= 100);
+
 	/* Hack -- wipe hole */
 	(void)WIPE(cave_monster(cave, i1), monster_type);
 }
@@ -294,7 +297,7 @@ void wipe_mon_list(struct cave *c, struct player *p)
 		r_ptr->cur_num--;
 
 		/* Monster is gone */
-		c->m_idx[m_ptr->fy][m_ptr->fx] = 0;
+		cave_set_m_idx(c, m_ptr->fy, m_ptr->fx, 0);
 
 		/* Wipe the Monster */
 		(void)WIPE(m_ptr, monster_type);
@@ -368,6 +371,137 @@ static s16b mon_pop(void)
 }
 
 
+/*
+ * The entries of alloc_race_table that get_mon_num() may pick from, as
+ * running totals of their "prob2": entry i is picked by a random value
+ * below mon_alloc_total[i] and at least mon_alloc_total[i - 1].
+ *
+ * The totals depend on the restriction hook, on whether the level is the
+ * town, on the player's depth (for FORCE_DEPTH monsters) and on which
+ * uniques may still appear, so they are kept until one of those changes.
+ * The uniques are checked on each call, as they come and go in many
+ * places.
+ */
+static const alloc_entry *mon_alloc_table;
+static s16b mon_alloc_size;
+static u32b *mon_alloc_total;
+static s16b *mon_alloc_unique;	/* Table positions of the unique entries */
+static bool *mon_alloc_gone;	/* Whether each was left out */
+static int mon_alloc_unique_n;
+static bool mon_alloc_valid = FALSE;
+static bool mon_alloc_town;
+static int mon_alloc_depth;
+
+
+/*
+ * Whether a unique monster may not appear again
+ */
+static bool mon_alloc_unique_gone(const monster_race *r_ptr)
+{
+	return (r_ptr->cur_num >= r_ptr->max_num);
+}
+
+
+/*
+ * Work out the running totals afresh
+ */
+static void mon_alloc_build(bool town, int depth)
+{
+	int i;
+
+	u32b total = 0;
+
+	/* Make room for the table */
+	if (mon_alloc_size != alloc_race_size)
+	{
+		mon_alloc_size = alloc_race_size;
+		mon_alloc_total = mem_realloc(mon_alloc_total,
+			mon_alloc_size * sizeof *mon_alloc_total);
+		mon_alloc_unique = mem_realloc(mon_alloc_unique,
+			mon_alloc_size * sizeof *mon_alloc_unique);
+		mon_alloc_gone = mem_realloc(mon_alloc_gone,
+			mon_alloc_size * sizeof *mon_alloc_gone);
+	}
+
+	mon_alloc_unique_n = 0;
+
+	for (i = 0; i < alloc_race_size; i++)
+	{
+		const alloc_entry *entry = &alloc_race_table[i];
+		monster_race *r_ptr = &r_info[entry->index];
+		int p = entry->prob2;
+
+		/* Hack -- No town monsters in dungeon */
+		if (!town && (entry->level <= 0)) p = 0;
+
+		/* Depth Monsters never appear out of depth */
+		if (rf_has(r_ptr->flags, RF_FORCE_DEPTH) && (r_ptr->level > depth))
+			p = 0;
+
+		/* Hack -- "unique" monsters must be "unique" */
+		if (rf_has(r_ptr->flags, RF_UNIQUE))
+		{
+			bool gone = mon_alloc_unique_gone(r_ptr);
+
+			mon_alloc_unique[mon_alloc_unique_n] = i;
+			mon_alloc_gone[mon_alloc_unique_n] = gone;
+			mon_alloc_unique_n++;
+
+			if (gone) p = 0;
+		}
+
+		total += p;
+		mon_alloc_total[i] = total;
+	}
+
+	mon_alloc_table = alloc_race_table;
+	mon_alloc_town = town;
+	mon_alloc_depth = depth;
+	mon_alloc_valid = TRUE;
+}
+
+
+/*
+ * Whether the running totals of the first n entries still hold
+ */
+static bool mon_alloc_fresh(bool town, int depth, int n)
+{
+	int i;
+
+	if (!mon_alloc_valid || (mon_alloc_table != alloc_race_table) ||
+			(mon_alloc_size != alloc_race_size))
+		return (FALSE);
+
+	if ((town != mon_alloc_town) || (depth != mon_alloc_depth))
+		return (FALSE);
+
+	/* Check the uniques which could be picked */
+	for (i = 0; (i < mon_alloc_unique_n) && (mon_alloc_unique[i] < n); i++)
+	{
+		monster_race *r_ptr =
+			&r_info[alloc_race_table[mon_alloc_unique[i]].index];
+
+		if (mon_alloc_unique_gone(r_ptr) != mon_alloc_gone[i])
+			return (FALSE);
+	}
+
+	return (TRUE);
+}
+
+
+/**
+ * Free the running totals used by get_mon_num().
+ */
+void free_mon_alloc(void)
+{
+	FREE(mon_alloc_total);
+	FREE(mon_alloc_unique);
+	FREE(mon_alloc_gone);
+	mon_alloc_size = 0;
+	mon_alloc_valid = FALSE;
+}
+
+
 /**
  * Apply a "monster restriction function" to the "monster allocation table".
  * This way, we can use get_mon_num() to get a level-appropriate monster that
@@ -391,43 +525,47 @@ void get_mon_num_prep(void)
 			entry->prob2 = 0;
 	}
 
+	/* The running totals are out of date */
+	mon_alloc_valid = FALSE;
+
 	return;
 }
 
 /**
- * Helper function for get_mon_num(). Scans the prepared monster allocation
- * table and picks a random monster. Returns the index of a monster in
- * `table`.
+ * Helper function for get_mon_num(). Picks a random monster from the first
+ * n entries of the allocation table, which have the given total probability,
+ * and returns its position in the table.
  */
-int get_mon_num_aux(long total, const alloc_entry *table)
+static int get_mon_num_aux(long total, int n)
 {
-	int i;
-	
+	int lo = 0, hi = n - 1;
+
 	long value;
-	
+
 	/* Pick a monster */
 	value = randint0(total);
 
-	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++)
+	/* Find the first entry whose running total is past the value */
+	while (lo < hi)
 	{
-		/* Found the entry */
-		if (value < table[i].prob3) break;
+		int mid = (lo + hi) / 2;
 
-		/* Decrement */
-		value = value - table[i].prob3;
+		if (value < (long)mon_alloc_total[mid])
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
-	
-	return i;
+
+	return lo;
 }
 
 /**
  * Chooses a monster race that seems "appropriate" to the given level
  *
  * This function uses the "prob2" field of the "monster allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" monster, in
- * a relatively efficient manner.
+ * and various local information, to keep running totals of the chances of
+ * the monsters that may appear (see mon_alloc_build()), which are then used
+ * to choose an "appropriate" monster by binary search.
  *
  * Note that "town" monsters will *only* be created in the town, and
  * "normal" monsters will *never* be created in the town, unless the
@@ -445,59 +583,43 @@ int get_mon_num_aux(long total, const alloc_entry *table)
  */
 s16b get_mon_num(int level)
 {
-	int i, j, p;
+	int i, j, p, n;
 
-	int r_idx;
+	int lo, hi;
 
 	long total;
 
-	monster_race *r_ptr;
-
-	alloc_entry *table = alloc_race_table;
+	const alloc_entry *table = alloc_race_table;
 
 	/* Occasionally produce a nastier monster in the dungeon */
 	if (level > 0 && one_in_(NASTY_MON))
 		level += MIN(level / 4 + 2, MON_OOD_MAX);
 
-	total = 0L;
-
-	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++) {
-		/* Monsters are sorted by depth */
-		if (table[i].level > level) break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* Hack -- No town monsters in dungeon */
-		if ((level > 0) && (table[i].level <= 0)) continue;
-
-		/* Get the chosen monster */
-		r_idx = table[i].index;
-		r_ptr = &r_info[r_idx];
-
-		/* Hack -- "unique" monsters must be "unique" */
-		if (rf_has(r_ptr->flags, RF_UNIQUE) && 
-				r_ptr->cur_num >= r_ptr->max_num)
-			continue;
+	/* Monsters are sorted by depth; find those no deeper than the level */
+	lo = 0;
+	hi = alloc_race_size;
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
 
-		/* Depth Monsters never appear out of depth */
-		if (rf_has(r_ptr->flags, RF_FORCE_DEPTH) && 
-				r_ptr->level > p_ptr->depth)
-			continue;
+		if (table[mid].level > level)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	n = lo;
 
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
+	/* Bring the running totals up to date */
+	if (!mon_alloc_fresh(level <= 0, p_ptr->depth, n))
+		mon_alloc_build(level <= 0, p_ptr->depth);
 
-		/* Total */
-		total += table[i].prob3;
-	}
+	total = n ? (long)mon_alloc_total[n - 1] : 0L;
 
 	/* No legal monsters */
 	if (total <= 0) return (0);
 
 	/* Pick a monster */
-	i = get_mon_num_aux(total, table);
+	i = get_mon_num_aux(total, n);
 
 	/* Try for a "harder" monster once (50%) or twice (10%) */
 	p = randint0(100);
@@ -507,7 +629,7 @@ s16b get_mon_num(int level)
 		j = i;
 
 		/* Pick a monster */
-		i = get_mon_num_aux(total, table);
+		i = get_mon_num_aux(total, n);
 
 		/* Keep the deepest one */
 		if (table[i].level < table[j].level) i = j;
@@ -519,7 +641,7 @@ s16b get_mon_num(int level)
 		j = i;
 
 		/* Pick a monster */
-		i = get_mon_num_aux(total, table);
+		i = get_mon_num_aux(total, n);
 
 		/* Keep the deepest one */
 		if (table[i].level < table[j].level) i = j;
@@ -535,14 +657,14 @@ s16b get_mon_num(int level)
  */
 void player_place(struct cave *c, struct player *p, int y, int x)
 {
-	assert(!c->m_idx[y][x]);
+	assert(!cave_m_idx(c, y, x));
 
 	/* Save player location */
 	p->py = y;
 	p->px = x;
 
 	/* Mark cave grid */
-	c->m_idx[y][x] = -1;
+	cave_set_m_idx(c, y, x, -1);
 }
 
 
@@ -664,7 +786,7 @@ s16b place_monster(int y, int x, monster_type *n_ptr, byte origin)
 	monster_race *r_ptr;
 
 	assert(in_bounds(y, x));
-	assert(cave->m_idx[y][x] == 0);
+	assert(cave_m_idx(cave, y, x) == 0);
 
 	/* Get a new record */
 	m_idx = mon_pop();
@@ -673,7 +795,7 @@ s16b place_monster(int y, int x, monster_type *n_ptr, byte origin)
 	n_ptr->midx = m_idx;
 
 	/* Notify cave of the new monster */
-	cave->m_idx[y][x] = m_idx;
+	cave_set_m_idx(cave, y, x, m_idx);
 
 	/* Copy the monster */
 	m_ptr = cave_monster(cave, m_idx);
@@ -685,6 +807,9 @@ s16b place_monster(int y, int x, monster_type *n_ptr, byte origin)
 
 	update_mon(m_idx, TRUE);
 
+	/* Monsters from savefiles may be ready to act */
+	cave_monster_set_ready(cave, m_idx, m_ptr->energy >= 100);
+
 	/* Get the new race */
 	r_ptr = &r_info[m_ptr->r_idx];
 
@@ -797,7 +922,7 @@ static bool place_new_monster_one(int y, int x, monster_race *r_ptr,
 	if (!cave_empty_bold(y, x)) return (FALSE);
 
 	/* No creation on glyph of warding */
-	if (cave->feat[y][x] == FEAT_GLYPH) return (FALSE);
+	if (cave_feat(cave, y, x) == FEAT_GLYPH) return (FALSE);
 
 	assert(r_ptr && r_ptr->name);
 	name = r_ptr->name;
@@ -1266,9 +1391,6 @@ static void build_quest_stairs(int y, int x)
 
 	/* Update the visuals */
 	p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
-
-	/* Fully update the flow */
-	p_ptr->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
 }
 
 
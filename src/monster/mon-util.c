@@ -1099,6 +1099,30 @@ void update_monsters(bool full)
 }
 
 
+/**
+ * Updates the monsters standing in the grids which came into or left view
+ * or sight at the last update_view(), which are the only ones whose
+ * visibility a change in the view can affect.
+ */
+void update_monsters_in_view(void)
+{
+	const u16b *gp;
+	int i, n;
+
+	n = view_added(&gp);
+	for (i = 0; i < n; i++) {
+		int m_idx = cave_m_idx(cave, GRID_Y(gp[i]), GRID_X(gp[i]));
+		if (m_idx > 0) update_mon(m_idx, FALSE);
+	}
+
+	n = view_removed(&gp);
+	for (i = 0; i < n; i++) {
+		int m_idx = cave_m_idx(cave, GRID_Y(gp[i]), GRID_X(gp[i]));
+		if (m_idx > 0) update_mon(m_idx, FALSE);
+	}
+}
+
+
 /**
  * Add the given object to the given monster's inventory.
  *
@@ -1177,12 +1201,12 @@ void monster_swap(int y1, int x1, int y2, int x2)
 	monster_race *r_ptr;
 
 	/* Monsters */
-	m1 = cave->m_idx[y1][x1];
-	m2 = cave->m_idx[y2][x2];
+	m1 = cave_m_idx(cave, y1, x1);
+	m2 = cave_m_idx(cave, y2, x2);
 
 	/* Update grids */
-	cave->m_idx[y1][x1] = m2;
-	cave->m_idx[y2][x2] = m1;
+	cave_set_m_idx(cave, y1, x1, m2);
+	cave_set_m_idx(cave, y2, x2, m1);
 
 	/* Monster 1 */
 	if (m1 > 0) {
@@ -1209,6 +1233,9 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		p_ptr->py = y2;
 		p_ptr->px = x2;
 
+		/* Leave a trail */
+		cave_leave_scent(cave, y2, x2);
+
 		/* Update the trap detection status */
 		p_ptr->redraw |= (PR_DTRAP);
 
@@ -1250,6 +1277,9 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		p_ptr->py = y1;
 		p_ptr->px = x1;
 
+		/* Leave a trail */
+		cave_leave_scent(cave, y1, x1);
+
 		/* Update the trap detection status */
 		p_ptr->redraw |= (PR_DTRAP);
 
@@ -1372,7 +1402,7 @@ int summon_specific(int y1, int x1, int lev, int type, int delay)
 		if (!cave_empty_bold(y, x)) continue;
 
 		/* Hack -- no summon on glyph of warding */
-		if (cave->feat[y][x] == FEAT_GLYPH) continue;
+		if (cave_feat(cave, y, x) == FEAT_GLYPH) continue;
 
 		/* Okay */
 		break;
@@ -685,7 +685,7 @@ int scan_floor(int *items, int max_size, int y, int x, int mode)
 	if (!in_bounds(y, x)) return 0;
 
 	/* Scan all objects in the grid */
-	for (this_o_idx = cave->o_idx[y][x]; this_o_idx; this_o_idx = next_o_idx)
+	for (this_o_idx = cave_o_idx(cave, y, x); this_o_idx; this_o_idx = next_o_idx)
 	{
 		object_type *o_ptr;
 
@@ -794,7 +794,7 @@ void excise_object_idx(int o_idx)
 		int x = j_ptr->ix;
 
 		/* Scan all objects in the grid */
-		for (this_o_idx = cave->o_idx[y][x]; this_o_idx; this_o_idx = next_o_idx)
+		for (this_o_idx = cave_o_idx(cave, y, x); this_o_idx; this_o_idx = next_o_idx)
 		{
 			object_type *o_ptr;
 
@@ -811,7 +811,7 @@ void excise_object_idx(int o_idx)
 				if (prev_o_idx == 0)
 				{
 					/* Remove from list */
-					cave->o_idx[y][x] = next_o_idx;
+					cave_set_o_idx(cave, y, x, next_o_idx);
 				}
 
 				/* Real previous */
@@ -904,7 +904,7 @@ void delete_object(int y, int x)
 	if (!in_bounds(y, x)) return;
 
 	/* Scan all objects in the grid */
-	for (this_o_idx = cave->o_idx[y][x]; this_o_idx; this_o_idx = next_o_idx) {
+	for (this_o_idx = cave_o_idx(cave, y, x); this_o_idx; this_o_idx = next_o_idx) {
 		object_type *o_ptr;
 
 		/* Get the object */
@@ -937,7 +937,7 @@ void delete_object(int y, int x)
 	}
 
 	/* Objects are gone */
-	cave->o_idx[y][x] = 0;
+	cave_set_o_idx(cave, y, x, 0);
 
 	/* Visual update */
 	cave_light_spot(cave, y, x);
@@ -1007,10 +1007,10 @@ static void compact_objects_aux(int i1, int i2)
 		x = o_ptr->ix;
 
 		/* Repair grid */
-		if (cave->o_idx[y][x] == i1)
+		if (cave_o_idx(cave, y, x) == i1)
 		{
 			/* Repair */
-			cave->o_idx[y][x] = i2;
+			cave_set_o_idx(cave, y, x, i2);
 		}
 
 		/* Mimic */
@@ -1190,7 +1190,7 @@ void compact_objects(int size)
  *
  * Note -- we do NOT visually reflect these (irrelevant) changes
  *
- * Hack -- we clear the "cave->o_idx[y][x]" field for every grid,
+ * Hack -- we clear the "cave_o_idx(cave, y, x)" field for every grid,
  * and the "m_ptr->next_o_idx" field for every monster, since
  * we know we are clearing every object.  Technically, we only
  * clear those fields for grids/monsters containing objects,
@@ -1237,7 +1237,7 @@ void wipe_o_list(struct cave *c)
 			int x = o_ptr->ix;
 
 			/* Hack -- see above */
-			c->o_idx[y][x] = 0;
+			cave_set_o_idx(c, y, x, 0);
 		}
 
 		/* Wipe the object */
@@ -1308,7 +1308,7 @@ s16b o_pop(void)
  */
 object_type *get_first_object(int y, int x)
 {
-	s16b o_idx = cave->o_idx[y][x];
+	s16b o_idx = cave_o_idx(cave, y, x);
 
 	if (o_idx)
 		return object_byid(o_idx);
@@ -1851,7 +1851,7 @@ static s16b floor_get_idx_oldest_squelched(int y, int x)
 
 	object_type *o_ptr = NULL;
 
-	for (this_o_idx = cave->o_idx[y][x]; this_o_idx; this_o_idx = o_ptr->next_o_idx)
+	for (this_o_idx = cave_o_idx(cave, y, x); this_o_idx; this_o_idx = o_ptr->next_o_idx)
 	{
 		o_ptr = object_byid(this_o_idx);
 
@@ -1877,7 +1877,7 @@ s16b floor_carry(struct cave *c, int y, int x, object_type *j_ptr)
 
 
 	/* Scan objects in that grid for combination */
-	for (this_o_idx = c->o_idx[y][x]; this_o_idx; this_o_idx = next_o_idx)
+	for (this_o_idx = cave_o_idx(c, y, x); this_o_idx; this_o_idx = next_o_idx)
 	{
 		object_type *o_ptr = object_byid(this_o_idx);
 
@@ -1936,10 +1936,10 @@ s16b floor_carry(struct cave *c, int y, int x, object_type *j_ptr)
 		o_ptr->held_m_idx = 0;
 
 		/* Link the object to the pile */
-		o_ptr->next_o_idx = c->o_idx[y][x];
+		o_ptr->next_o_idx = cave_o_idx(c, y, x);
 
 		/* Link the floor to the object */
-		c->o_idx[y][x] = o_idx;
+		cave_set_o_idx(c, y, x, o_idx);
 
 		cave_note_spot(c, y, x);
 		cave_light_spot(c, y, x);
@@ -1983,6 +1983,8 @@ void drop_near(struct cave *c, object_type *j_ptr, int chance, int y, int x, boo
 
 	bool plural = FALSE;
 
+	struct los_source from;
+
 
 	/* Extract plural */
 	if (j_ptr->number != 1) plural = TRUE;
@@ -2012,6 +2014,8 @@ void drop_near(struct cave *c, object_type *j_ptr, int chance, int y, int x, boo
 	by = y;
 	bx = x;
 
+	los_source_init(&from, y, x);
+
 	/* Scan local grids */
 	for (dy = -3; dy <= 3; dy++)
 	{
@@ -2034,10 +2038,10 @@ void drop_near(struct cave *c, object_type *j_ptr, int chance, int y, int x, boo
 			if (!in_bounds_fully(ty, tx)) continue;
 
 			/* Require line of sight */
-			if (!los(y, x, ty, tx)) continue;
+			if (!los_from(&from, ty, tx)) continue;
 
 			/* Require floor space */
-			if (cave->feat[ty][tx] != FEAT_FLOOR) continue;
+			if (cave_feat(cave, ty, tx) != FEAT_FLOOR) continue;
 
 			/* No objects */
 			k = 0;
@@ -2125,7 +2129,7 @@ void drop_near(struct cave *c, object_type *j_ptr, int chance, int y, int x, boo
 		}
 
 		/* Require floor space */
-		if (cave->feat[ty][tx] != FEAT_FLOOR) continue;
+		if (cave_feat(cave, ty, tx) != FEAT_FLOOR) continue;
 
 		/* Bounce to that location */
 		by = ty;
@@ -2159,7 +2163,7 @@ void drop_near(struct cave *c, object_type *j_ptr, int chance, int y, int x, boo
 	sound(MSG_DROP);
 
 	/* Message when an object falls under the player */
-	if (verbose && (cave->m_idx[by][bx] < 0) && !squelch_item_ok(j_ptr))
+	if (verbose && (cave_m_idx(cave, by, bx) < 0) && !squelch_item_ok(j_ptr))
 	{
 		msg("You feel something roll beneath your feet.");
 	}
@@ -2175,7 +2179,7 @@ void drop_near(struct cave *c, object_type *j_ptr, int chance, int y, int x, boo
 void push_object(int y, int x)
 {
 	/* Save the original terrain feature */
-	int feat_old = cave->feat[y][x];
+	int feat_old = cave_feat(cave, y, x);
 
 	object_type *o_ptr;
    
@@ -3861,8 +3865,8 @@ void display_itemlist(void)
 	bool seen[MAX_ITEMLIST];
 	unsigned counter = 0;
 
-	int dungeon_hgt = p_ptr->depth == 0 ? TOWN_HGT : DUNGEON_HGT;
-	int dungeon_wid = p_ptr->depth == 0 ? TOWN_WID : DUNGEON_WID;
+	int dungeon_hgt = cave->height;
+	int dungeon_wid = cave->width;
 
 	byte attr;
 	char buf[80];
@@ -39,7 +39,7 @@ const int option_page[OPT_PAGE_MAX][OPT_PAGE_PER] =
 		OPT_mouse_movement,
 		OPT_mouse_buttons,
 		OPT_use_sound,
-		OPT_NONE,
+		OPT_pregen_levels,
 		OPT_NONE,
 	},
 
@@ -138,7 +138,7 @@ static const struct option options[OPT_MAX] =
 { "mouse_movement",      "Allow mouse clicks to move the player",       TRUE },  /* 21 */
 { "mouse_buttons",       "Show mouse status line buttons",              FALSE }, /* 22 */
 { "notify_recharge",     "Notify on object recharge",                   FALSE }, /* 23 */
-{ NULL,                  NULL,                                          FALSE }, /* 24 */
+{ "pregen_levels",       "Generate the next levels while waiting",      FALSE }, /* 24 */
 { NULL,                  NULL,                                          FALSE }, /* 25 */
 { NULL,                  NULL,                                          FALSE }, /* 26 */
 { NULL,                  NULL,                                          FALSE }, /* 27 */
@@ -19,6 +19,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "pathfind.h"
 #include "squelch.h"
 
 /****** Pathfinding code ******/
@@ -37,11 +38,28 @@ static int pf_result_index;
 static int ox, oy, ex, ey;
 static int dir_search[8] = {2,4,6,8,1,3,7,9};
 
+/*
+ * The distance map of a journey, which covers the whole level: the number
+ * of steps from each grid to the target plus one, or zero where the target
+ * cannot be reached from.  It lasts as long as the journey does, and is
+ * only worked out again when the way it shows turns out to be blocked.
+ *
+ * The map and the queue used to fill it are indexed by cave_grid(), and
+ * grow to fit the largest level seen; pf_map_h and pf_map_w are the size
+ * of the level the map was worked out for.
+ */
+static u16b *pf_map;
+static int *pf_queue;
+static int pf_map_grids;
+static int pf_map_h, pf_map_w;
+static int pf_map_y, pf_map_x;
+static bool pf_travel;
+
 
 static bool is_valid_pf(int y, int x)
 {
 	/* Unvisited means allowed */
-	if (!(cave->info[y][x] & (CAVE_MARK))) return (TRUE);
+	if (!(cave_info(cave, y, x) & (CAVE_MARK))) return (TRUE);
 
 	/* Require open space */
 	return (cave_floor_bold(y, x));
@@ -54,8 +72,8 @@ static void fill_terrain_info(void)
 	ox = MAX(p_ptr->px - MAX_PF_RADIUS / 2, 0);
 	oy = MAX(p_ptr->py - MAX_PF_RADIUS / 2, 0);
 
-	ex = MIN(p_ptr->px + MAX_PF_RADIUS / 2 - 1, DUNGEON_WID);
-	ey = MIN(p_ptr->py + MAX_PF_RADIUS / 2 - 1, DUNGEON_HGT);
+	ex = MIN(p_ptr->px + MAX_PF_RADIUS / 2 - 1, cave->width);
+	ey = MIN(p_ptr->py + MAX_PF_RADIUS / 2 - 1, cave->height);
 
 	for (i = 0; i < MAX_PF_RADIUS * MAX_PF_RADIUS; i++)
 		terrain[0][i] = -1;
@@ -68,12 +86,60 @@ static void fill_terrain_info(void)
 	terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
 }
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) { c = d; try_again = (TRUE); }
+/*
+ * The open grids of the search, as a binary heap of window offsets keyed
+ * by distance so far plus the least distance left to go.  A grid is pushed
+ * again whenever its distance drops, so the heap can hold it more than
+ * once.
+ */
+#define PF_HEAP_MAX (MAX_PF_RADIUS * MAX_PF_RADIUS * 8)
+#define PF_KEY(d, g) ((d) * MAX_PF_RADIUS * MAX_PF_RADIUS + (g))
+
+static int pf_heap[PF_HEAP_MAX];
+static int pf_heap_n;
+
+static void pf_heap_push(int key)
+{
+	int i = pf_heap_n++;
+
+	while (i > 0 && pf_heap[(i - 1) / 2] > key)
+	{
+		pf_heap[i] = pf_heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+
+	pf_heap[i] = key;
+}
+
+static int pf_heap_pop(void)
+{
+	int top = pf_heap[0];
+	int last = pf_heap[--pf_heap_n];
+	int i = 0;
+
+	while (2 * i + 1 < pf_heap_n)
+	{
+		int child = 2 * i + 1;
+
+		if (child + 1 < pf_heap_n && pf_heap[child + 1] < pf_heap[child])
+			child++;
+		if (last <= pf_heap[child]) break;
+
+		pf_heap[i] = pf_heap[child];
+		i = child;
+	}
+
+	pf_heap[i] = last;
+
+	return top;
+}
+
+/* The least number of steps between two grids */
+#define PF_DISTANCE(y1, x1, y2, x2) MAX(ABS((y1) - (y2)), ABS((x1) - (x2)))
 
 bool findpath(int y, int x)
 {
 	int i, j, k, dir;
-	bool try_again;
 	int cur_distance;
 
 	fill_terrain_info();
@@ -82,7 +148,7 @@ bool findpath(int y, int x)
 
 	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey))
 	{
-		if ((cave->m_idx[y][x] > 0) && (cave_monster_at(cave, y, x)->ml))
+		if ((cave_m_idx(cave, y, x) > 0) && (cave_monster_at(cave, y, x)->ml))
 		{
 			terrain[y - oy][x - ox] = MAX_PF_LENGTH;
 		}
@@ -103,38 +169,55 @@ bool findpath(int y, int x)
 		return (FALSE);
 	}
 
-	/* 
-	 * And now starts the very naive and very 
-	 * inefficient pathfinding algorithm
+	/* This path is not a journey */
+	pf_travel = FALSE;
+
+	/*
+	 * Search outwards from the player, best guess at the whole path
+	 * length first, until the target is reached.  Every step costs one
+	 * and the guess never overestimates, so each grid taken from the
+	 * heap already has its least distance.
 	 */
-	do
+	pf_heap_n = 0;
+	pf_heap_push(PF_KEY(1 + PF_DISTANCE(p_ptr->py, p_ptr->px, y, x),
+		(p_ptr->py - oy) * MAX_PF_RADIUS + p_ptr->px - ox));
+
+	while (pf_heap_n)
 	{
-		try_again = FALSE;
+		int key = pf_heap_pop();
+		int g = key % (MAX_PF_RADIUS * MAX_PF_RADIUS);
 
-		for (j = oy + 1; j < ey - 1; j++)
-		{
-			for (i = ox + 1; i < ex - 1; i++)
-			{
-				cur_distance = terrain[j - oy][i - ox] + 1;
+		j = g / MAX_PF_RADIUS;
+		i = g % MAX_PF_RADIUS;
 
-				if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH))
-				{
-					for (dir = 1; dir < 10; dir++)
-					{
-						if (dir == 5)
-							dir++;
+		/* Ignore grids found by a shorter way since being pushed */
+		if (key / (MAX_PF_RADIUS * MAX_PF_RADIUS) !=
+				terrain[j][i] + PF_DISTANCE(j + oy, i + ox, y, x))
+			continue;
 
-						MARK_DISTANCE(terrain[j - oy + ddy[dir]][i - ox + ddx[dir]], cur_distance);
-					}
-				}
-			}
-		}
+		/* Done */
+		if ((j == y - oy) && (i == x - ox)) break;
+
+		/* Grids on the edge of the window lead nowhere */
+		if ((j == 0) || (j >= ey - oy - 1) || (i == 0) || (i >= ex - ox - 1))
+			continue;
+
+		cur_distance = terrain[j][i] + 1;
+		if (cur_distance >= MAX_PF_LENGTH) continue;
+
+		for (k = 0; k < 8; k++)
+		{
+			int nj = j + ddy_ddd[k];
+			int ni = i + ddx_ddd[k];
 
-		if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-			try_again = (FALSE);
+			/* Walls stay at -1 */
+			if (terrain[nj][ni] <= cur_distance) continue;
 
+			terrain[nj][ni] = cur_distance;
+			pf_heap_push(PF_KEY(cur_distance +
+				PF_DISTANCE(nj + oy, ni + ox, y, x), nj * MAX_PF_RADIUS + ni));
+		}
 	}
-	while (try_again);
 
 	/* Failure */
 	if (terrain[y - oy][x - ox] == MAX_PF_LENGTH)
@@ -182,6 +265,153 @@ bool findpath(int y, int x)
 	return (TRUE);
 }
 
+static void fill_travel_map(void)
+{
+	int grids = cave->height * cave->width;
+	int head = 0, tail = 0;
+	int d;
+
+	/* Make room for the level */
+	if (grids > pf_map_grids)
+	{
+		pf_map = mem_realloc(pf_map, grids * sizeof *pf_map);
+		pf_queue = mem_realloc(pf_queue, grids * sizeof *pf_queue);
+		pf_map_grids = grids;
+	}
+
+	C_WIPE(pf_map, grids, u16b);
+	pf_map_h = cave->height;
+	pf_map_w = cave->width;
+
+	/* The target is always allowed */
+	pf_map[cave_grid(cave, pf_map_y, pf_map_x)] = 1;
+	pf_queue[tail++] = cave_grid(cave, pf_map_y, pf_map_x);
+
+	/* Every step costs one, so a plain queue finds the least distances */
+	while (head < tail)
+	{
+		int g = pf_queue[head++];
+		int ty = g / cave->width;
+		int tx = g % cave->width;
+
+		for (d = 0; d < 8; d++)
+		{
+			int y = ty + ddy_ddd[d];
+			int x = tx + ddx_ddd[d];
+			int n = cave_grid(cave, y, x);
+
+			if (!cave_in_bounds(cave, y, x)) continue;
+			if (pf_map[n] || !is_valid_pf(y, x)) continue;
+
+			pf_map[n] = pf_map[g] + 1;
+			pf_queue[tail++] = n;
+		}
+	}
+}
+
+/*
+ * Set out for grid (y, x), which may be anywhere on the level, by working
+ * out the distance map of the journey.  Unlike findpath(), each step is
+ * then read off the map as it is taken.
+ */
+bool findpath_travel(int y, int x)
+{
+	if (!cave_in_bounds_fully(cave, y, x))
+	{
+		bell("Target out of range.");
+		return (FALSE);
+	}
+
+	pf_map_y = y;
+	pf_map_x = x;
+	fill_travel_map();
+
+	if (!pf_map[cave_grid(cave, p_ptr->py, p_ptr->px)])
+	{
+		bell("Target space unreachable.");
+		return (FALSE);
+	}
+
+	pf_travel = TRUE;
+
+	return (TRUE);
+}
+
+/*
+ * Free the distance map of journeys.
+ */
+void free_travel_map(void)
+{
+	FREE(pf_map);
+	FREE(pf_queue);
+	pf_map_grids = 0;
+	pf_map_h = pf_map_w = 0;
+	pf_travel = FALSE;
+}
+
+/*
+ * The direction of the next step of a journey, or zero once it is over.
+ * If the grid the map leads to has turned out to be blocked, the map is
+ * worked out again from what is known now.
+ */
+static int travel_dir(void)
+{
+	int tries, k;
+
+	/* The map was worked out for another level */
+	if ((pf_map_h != cave->height) || (pf_map_w != cave->width)) return (0);
+
+	for (tries = 0; tries < 2; tries++)
+	{
+		int d = pf_map[cave_grid(cave, p_ptr->py, p_ptr->px)];
+
+		/* Arrived */
+		if (d == 1) return (0);
+
+		for (k = 0; d && k < 8; k++)
+		{
+			int dir = dir_search[k];
+			int y = p_ptr->py + ddy[dir];
+			int x = p_ptr->px + ddx[dir];
+
+			if ((pf_map[cave_grid(cave, y, x)] == d - 1) && is_valid_pf(y, x))
+				return (dir);
+		}
+
+		fill_travel_map();
+	}
+
+	return (0);
+}
+
+/*
+ * The number of steps left on the current path or journey.
+ */
+int pathfind_steps_left(void)
+{
+	if (pf_travel)
+	{
+		if ((pf_map_h != cave->height) || (pf_map_w != cave->width))
+			return (0);
+
+		return (MAX(pf_map[cave_grid(cave, p_ptr->py, p_ptr->px)] - 1, 0));
+	}
+
+	return (pf_result_index + 1);
+}
+
+/*
+ * The direction of the next step of the current path or journey, or zero
+ * if there is none.
+ */
+int pathfind_next_dir(void)
+{
+	if (pf_travel) return (travel_dir());
+	if (pf_result_index < 0) return (0);
+
+	return (pf_result[pf_result_index] - '0');
+}
+
 /* Compute the direction (in the angband 123456789 sense) from a point to a
  * point. We decide to use diagonals if dx and dy are within a factor of two of
  * each other; otherwise we choose a cardinal direction. */
@@ -410,10 +640,10 @@ static int see_wall(int dir, int y, int x)
 	if (!in_bounds(y, x)) return (FALSE);
 
 	/* Non-wall grids are not known walls */
-	if (cave->feat[y][x] < FEAT_SECRET) return (FALSE);
+	if (cave_feat(cave, y, x) < FEAT_SECRET) return (FALSE);
 
 	/* Unknown walls are not known walls */
-	if (!(cave->info[y][x] & (CAVE_MARK))) return (FALSE);
+	if (!(cave_info(cave, y, x) & (CAVE_MARK))) return (FALSE);
 
 	/* Default */
 	return (TRUE);
@@ -579,7 +809,7 @@ static bool run_test(void)
 
 
 		/* Visible monsters abort running */
-		if (cave->m_idx[row][col] > 0)
+		if (cave_m_idx(cave, row, col) > 0)
 		{
 			monster_type *m_ptr = cave_monster_at(cave, row, col);
 
@@ -599,12 +829,12 @@ static bool run_test(void)
 		inv = TRUE;
 
 		/* Check memorized grids */
-		if (cave->info[row][col] & (CAVE_MARK))
+		if (cave_info(cave, row, col) & (CAVE_MARK))
 		{
 			bool notice = TRUE;
 
 			/* Examine the terrain */
-			switch (cave->feat[row][col])
+			switch (cave_feat(cave, row, col))
 			{
 				/* Floors */
 				case FEAT_FLOOR:
@@ -722,11 +952,11 @@ static bool run_test(void)
 		
 		/* HACK: Ugh. Sometimes we come up with illegal bounds. This will
 		 * treat the symptom but not the disease. */
-		if (row >= DUNGEON_HGT || col >= DUNGEON_WID) continue;
+		if (row >= cave->height || col >= cave->width) continue;
 		if (row < 0 || col < 0) continue;
 
 		/* Visible monsters abort running */
-		if (cave->m_idx[row][col] > 0)
+		if (cave_m_idx(cave, row, col) > 0)
 		{
 			monster_type *m_ptr = cave_monster_at(cave, row, col);
 			
@@ -748,8 +978,8 @@ static bool run_test(void)
 
 			/* Unknown grid or non-wall */
 			/* Was: cave_floor_bold(row, col) */
-			if (!(cave->info[row][col] & (CAVE_MARK)) ||
-			    (cave->feat[row][col] < FEAT_SECRET))
+			if (!(cave_info(cave, row, col) & (CAVE_MARK)) ||
+			    (cave_feat(cave, row, col) < FEAT_SECRET))
 			{
 				/* Looking to break right */
 				if (p_ptr->run_break_right)
@@ -779,8 +1009,8 @@ static bool run_test(void)
 
 			/* Unknown grid or non-wall */
 			/* Was: cave_floor_bold(row, col) */
-			if (!(cave->info[row][col] & (CAVE_MARK)) ||
-			    (cave->feat[row][col] < FEAT_SECRET))
+			if (!(cave_info(cave, row, col) & (CAVE_MARK)) ||
+			    (cave_feat(cave, row, col) < FEAT_SECRET))
 			{
 				/* Looking to break left */
 				if (p_ptr->run_break_left)
@@ -884,6 +1114,20 @@ void run_step(int dir)
 				return;
 			}
 		}
+		else if (pf_travel)
+		{
+			int step = travel_dir();
+
+			/* Abort if we have arrived, or there is no way left */
+			if (!step)
+			{
+				disturb(p_ptr, 0, 0);
+				p_ptr->running_withpathfind = FALSE;
+				return;
+			}
+
+			p_ptr->run_cur_dir = step;
+		}
 		else
 		{
 			/* Abort if we have finished */
@@ -902,7 +1146,7 @@ void run_step(int dir)
 				x = p_ptr->px + ddx[pf_result[pf_result_index] - '0'];
 
 				/* Known wall */
-				if ((cave->info[y][x] & (CAVE_MARK)) && !cave_floor_bold(y, x))
+				if ((cave_info(cave, y, x) & (CAVE_MARK)) && !cave_floor_bold(y, x))
 				{
 					disturb(p_ptr, 0,0);
 					p_ptr->running_withpathfind = FALSE;
@@ -927,7 +1171,7 @@ void run_step(int dir)
 				x = p_ptr->px + ddx[pf_result[pf_result_index] - '0'];
 
 				/* Known wall */
-				if ((cave->info[y][x] & (CAVE_MARK)) && !cave_floor_bold(y, x))
+				if ((cave_info(cave, y, x) & (CAVE_MARK)) && !cave_floor_bold(y, x))
 				{
 					disturb(p_ptr, 0,0);
 					p_ptr->running_withpathfind = FALSE;
@@ -939,7 +1183,7 @@ void run_step(int dir)
 				x = x + ddx[pf_result[pf_result_index-1] - '0'];
 
 				/* Known wall */
-				if ((cave->info[y][x] & (CAVE_MARK)) && !cave_floor_bold(y, x))
+				if ((cave_info(cave, y, x) & (CAVE_MARK)) && !cave_floor_bold(y, x))
 				{
 					p_ptr->running_withpathfind = FALSE;
 
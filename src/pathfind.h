@@ -6,5 +6,8 @@
 #include "z-type.h"
 
 extern int pathfind_direction_to(struct loc from, struct loc to);
+extern void free_travel_map(void);
+extern int pathfind_steps_left(void);
+extern int pathfind_next_dir(void);
 
 #endif /* !PATHFIND_H */
@@ -1321,7 +1321,7 @@ static void calc_torch(void)
 		if (old_light != new_light) {
 			/* Update the visuals */
 			p_ptr->cur_light = new_light;
-			p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+			p_ptr->update |= (PU_UPDATE_VIEW);
 		}
 		return;
 	}
@@ -1365,7 +1365,7 @@ static void calc_torch(void)
 	if (old_light != new_light) {
 		/* Update the visuals */
 		p_ptr->cur_light = new_light;
-		p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+		p_ptr->update |= (PU_UPDATE_VIEW);
 	}
 }
 
@@ -2252,6 +2252,10 @@ void update_stuff(struct player *p)
 	{
 		p->update &= ~(PU_UPDATE_VIEW);
 		update_view();
+
+		/* Monsters the change of view revealed or hid, unless all are due */
+		if (!(p->update & (PU_DISTANCE | PU_MONSTERS)))
+			update_monsters_in_view();
 	}
 
 
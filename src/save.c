@@ -538,6 +538,8 @@ void wr_misc(void)
 	wr_byte(cave->feeling);
 	wr_u16b(cave->feeling_squares);
 	wr_s32b(cave->created_at);
+	wr_u32b((u32b)(cave->seed >> 32));
+	wr_u32b((u32b)cave->seed);
 
 	/* Current turn */
 	wr_s32b(turn);
@@ -675,12 +677,12 @@ void wr_dungeon(void)
 	prev_char = 0;
 
 	/* Dump the cave */
-	for (y = 0; y < DUNGEON_HGT; y++)
+	for (y = 0; y < cave->height; y++)
 	{
-		for (x = 0; x < DUNGEON_WID; x++)
+		for (x = 0; x < cave->width; x++)
 		{
 			/* Extract the important cave->info flags */
-			tmp8u = (cave->info[y][x] & (IMPORTANT_FLAGS));
+			tmp8u = (cave_info(cave, y, x) & (IMPORTANT_FLAGS));
 
 			/* If the run is broken, or too full, flush it */
 			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
@@ -713,12 +715,12 @@ void wr_dungeon(void)
 	prev_char = 0;
 
 	/* Dump the cave */
-	for (y = 0; y < DUNGEON_HGT; y++)
+	for (y = 0; y < cave->height; y++)
 	{
-		for (x = 0; x < DUNGEON_WID; x++)
+		for (x = 0; x < cave->width; x++)
 		{
 			/* Keep all the information from info2 */
-			tmp8u = cave->info2[y][x];
+			tmp8u = cave_info2(cave, y, x);
 
 			/* If the run is broken, or too full, flush it */
 			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
@@ -752,12 +754,12 @@ void wr_dungeon(void)
 	prev_char = 0;
 
 	/* Dump the cave */
-	for (y = 0; y < DUNGEON_HGT; y++)
+	for (y = 0; y < cave->height; y++)
 	{
-		for (x = 0; x < DUNGEON_WID; x++)
+		for (x = 0; x < cave->width; x++)
 		{
 			/* Extract a byte */
-			tmp8u = cave->feat[y][x];
+			tmp8u = cave_feat(cave, y, x);
 
 			/* If the run is broken, or too full, flush it */
 			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
@@ -85,13 +85,13 @@ static const struct {
 	{ "artifacts", wr_artifacts, 2 },
 	{ "player", wr_player, 3 },
 	{ "squelch", wr_squelch, 2 },
-	{ "misc", wr_misc, 2 },
+	{ "misc", wr_misc, 3 },
 	{ "player hp", wr_player_hp, 1 },
 	{ "player spells", wr_player_spells, 1 },
 	{ "randarts", wr_randarts, 3 },
 	{ "inventory", wr_inventory, 6 },
 	{ "stores", wr_stores, 6 },
-	{ "dungeon", wr_dungeon, 1 },
+	{ "dungeon", wr_dungeon, 2 },
 	{ "objects", wr_objects, 6 },
 	{ "monsters", wr_monsters, 6 },
 	{ "ghost", wr_ghost, 1 },
@@ -119,6 +119,7 @@ static const struct {
 	{ "squelch", rd_squelch_2, 2 },
 	{ "misc", rd_misc, 1 },
 	{ "misc", rd_misc_2, 2},
+	{ "misc", rd_misc_3, 3},
 	{ "player hp", rd_player_hp, 1 },
 	{ "player spells", rd_player_spells, 1 },
 	{ "randarts", rd_randarts_1, 1 },
@@ -136,7 +137,8 @@ static const struct {
 	{ "stores", rd_stores_4, 4 },
 	{ "stores", rd_stores_5, 5 },
 	{ "stores", rd_stores_6, 6 },
-	{ "dungeon", rd_dungeon, 1 },
+	{ "dungeon", rd_dungeon_1, 1 },
+	{ "dungeon", rd_dungeon_2, 2 },
 	{ "objects", rd_objects_1, 1 },
 	{ "objects", rd_objects_2, 2 },
 	{ "objects", rd_objects_3, 3 },
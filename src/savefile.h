@@ -58,6 +58,7 @@ int rd_squelch(void);
 int rd_squelch_2(void);
 int rd_misc(void);
 int rd_misc_2(void);
+int rd_misc_3(void);
 int rd_player_hp(void);
 int rd_player_spells(void);
 int rd_randarts_1(void);
@@ -75,7 +76,8 @@ int rd_stores_3(void);
 int rd_stores_4(void);
 int rd_stores_5(void);
 int rd_stores_6(void);
-int rd_dungeon(void);
+int rd_dungeon_1(void);
+int rd_dungeon_2(void);
 int rd_objects_1(void);
 int rd_objects_2(void);
 int rd_objects_3(void);
@@ -269,10 +269,10 @@ void teleport_away(struct monster *m_ptr, int dis)
 			if (!cave_empty_bold(ny, nx)) continue;
 
 			/* Hack -- no teleport onto glyph of warding */
-			if (cave->feat[ny][nx] == FEAT_GLYPH) continue;
+			if (cave_feat(cave, ny, nx) == FEAT_GLYPH) continue;
 
 			/* No teleporting into vaults and such */
-			/* if (cave->info[ny][nx] & (CAVE_ICKY)) continue; */
+			/* if (cave_info(cave, ny, nx) & (CAVE_ICKY)) continue; */
 
 			/* This grid looks good */
 			look = FALSE;
@@ -344,7 +344,7 @@ void teleport_player(int dis)
 			if (!cave_naked_bold(y, x)) continue;
 
 			/* No teleporting into vaults and such */
-			if (cave->info[y][x] & (CAVE_ICKY)) continue;
+			if (cave_info(cave, y, x) & (CAVE_ICKY)) continue;
 
 			/* This grid looks good */
 			look = FALSE;
@@ -1145,15 +1145,15 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the trap */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(cave, y, x, CAVE_MARK);
 
 				/* Destroy the trap */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
 			}
 
 			/* Locked doors are unlocked */
-			else if ((cave->feat[y][x] >= FEAT_DOOR_HEAD + 0x01) &&
-			          (cave->feat[y][x] <= FEAT_DOOR_HEAD + 0x07))
+			else if ((cave_feat(cave, y, x) >= FEAT_DOOR_HEAD + 0x01) &&
+			          (cave_feat(cave, y, x) <= FEAT_DOOR_HEAD + 0x07))
 			{
 				/* Unlock the door */
 				cave_set_feat(cave, y, x, FEAT_DOOR_HEAD + 0x00);
@@ -1175,7 +1175,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 			/* Destroy all doors and traps */
 			if (cave_istrap(cave, y, x) ||
 					cave_isopendoor(cave, y, x) ||
-					cave->feat[y][x] == FEAT_BROKEN ||
+					cave_feat(cave, y, x) == FEAT_BROKEN ||
 					cave_isdoor(cave, y, x))
 			{
 				/* Check line of sight */
@@ -1186,8 +1186,8 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 					obvious = TRUE;
 
 					/* Visibility change */
-					if ((cave->feat[y][x] >= FEAT_DOOR_HEAD) &&
-					    (cave->feat[y][x] <= FEAT_DOOR_TAIL))
+					if ((cave_feat(cave, y, x) >= FEAT_DOOR_HEAD) &&
+					    (cave_feat(cave, y, x) <= FEAT_DOOR_TAIL))
 					{
 						/* Update the visuals */
 						p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
@@ -1195,7 +1195,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the door */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(cave, y, x, CAVE_MARK);
 
 				/* Destroy the feature */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1211,30 +1211,30 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 			if (cave_floor_bold(y, x)) break;
 
 			/* Permanent walls */
-			if (cave->feat[y][x] >= FEAT_PERM_EXTRA) break;
+			if (cave_feat(cave, y, x) >= FEAT_PERM_EXTRA) break;
 
 			/* Granite */
-			if (cave->feat[y][x] >= FEAT_WALL_EXTRA)
+			if (cave_feat(cave, y, x) >= FEAT_WALL_EXTRA)
 			{
 				/* Message */
-				if (cave->info[y][x] & (CAVE_MARK))
+				if (cave_info(cave, y, x) & (CAVE_MARK))
 				{
 					msg("The wall turns into mud!");
 					obvious = TRUE;
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(cave, y, x, CAVE_MARK);
 
 				/* Destroy the wall */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
 			}
 
 			/* Quartz / Magma with treasure */
-			else if (cave->feat[y][x] >= FEAT_MAGMA_H)
+			else if (cave_feat(cave, y, x) >= FEAT_MAGMA_H)
 			{
 				/* Message */
-				if (cave->info[y][x] & (CAVE_MARK))
+				if (cave_info(cave, y, x) & (CAVE_MARK))
 				{
 					msg("The vein turns into mud!");
 					msg("You have found something!");
@@ -1242,7 +1242,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(cave, y, x, CAVE_MARK);
 
 				/* Destroy the wall */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1252,34 +1252,34 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 			}
 
 			/* Quartz / Magma */
-			else if (cave->feat[y][x] >= FEAT_MAGMA)
+			else if (cave_feat(cave, y, x) >= FEAT_MAGMA)
 			{
 				/* Message */
-				if (cave->info[y][x] & (CAVE_MARK))
+				if (cave_info(cave, y, x) & (CAVE_MARK))
 				{
 					msg("The vein turns into mud!");
 					obvious = TRUE;
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(cave, y, x, CAVE_MARK);
 
 				/* Destroy the wall */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
 			}
 
 			/* Rubble */
-			else if (cave->feat[y][x] == FEAT_RUBBLE)
+			else if (cave_feat(cave, y, x) == FEAT_RUBBLE)
 			{
 				/* Message */
-				if (cave->info[y][x] & (CAVE_MARK))
+				if (cave_info(cave, y, x) & (CAVE_MARK))
 				{
 					msg("The rubble turns into mud!");
 					obvious = TRUE;
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(cave, y, x, CAVE_MARK);
 
 				/* Destroy the rubble */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1296,17 +1296,17 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 			}
 
 			/* Destroy doors (and secret doors) */
-			else /* if (cave->feat[y][x] >= FEAT_DOOR_HEAD) */
+			else /* if (cave_feat(cave, y, x) >= FEAT_DOOR_HEAD) */
 			{
 				/* Hack -- special message */
-				if (cave->info[y][x] & (CAVE_MARK))
+				if (cave_info(cave, y, x) & (CAVE_MARK))
 				{
 					msg("The door turns into mud!");
 					obvious = TRUE;
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_info_off(cave, y, x, CAVE_MARK);
 
 				/* Destroy the feature */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1315,9 +1315,6 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 			/* Update the visuals */
 			p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
 
-			/* Fully update the flow */
-			p_ptr->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
-
 			break;
 		}
 
@@ -1325,19 +1322,19 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 		case GF_MAKE_DOOR:
 		{
 			/* Require a grid without monsters */
-			if (cave->m_idx[y][x]) break;
+			if (cave_m_idx(cave, y, x)) break;
 			
 			/* Require a floor grid */
-			if (!(cave->feat[y][x] == FEAT_FLOOR)) break;
+			if (!(cave_feat(cave, y, x) == FEAT_FLOOR)) break;
 			
 			/* Push objects off the grid */
-			if (cave->o_idx[y][x]) push_object(y,x);
+			if (cave_o_idx(cave, y, x)) push_object(y,x);
 
 			/* Create closed door */
 			cave_set_feat(cave, y, x, FEAT_DOOR_HEAD + 0x00);
 
 			/* Observe */
-			if (cave->info[y][x] & (CAVE_MARK)) obvious = TRUE;
+			if (cave_info(cave, y, x) & (CAVE_MARK)) obvious = TRUE;
 
 			/* Update the visuals */
 			p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
@@ -1362,7 +1359,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 		case GF_LIGHT:
 		{
 			/* Turn on the light */
-			cave->info[y][x] |= (CAVE_GLOW);
+			cave_info_on(cave, y, x, CAVE_GLOW);
 
 			/* Grid is in line of sight */
 			if (player_has_los_bold(y, x))
@@ -1387,11 +1384,11 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 			if (p_ptr->depth != 0 || !is_daytime())
 			{
 				/* Turn off the light */
-				cave->info[y][x] &= ~(CAVE_GLOW);
+				cave_info_off(cave, y, x, CAVE_GLOW);
 
 				/* Hack -- Forget "boring" grids */
-				if (cave->feat[y][x] <= FEAT_INVIS)
-					cave->info[y][x] &= ~(CAVE_MARK);
+				if (cave_feat(cave, y, x) <= FEAT_INVIS)
+					cave_info_off(cave, y, x, CAVE_MARK);
 			}
 
 			/* Grid is in line of sight */
@@ -1453,7 +1450,7 @@ static bool project_o(int who, int r, int y, int x, int dam, int typ,
 
 
 	/* Scan all objects in the grid */
-	for (this_o_idx = cave->o_idx[y][x]; this_o_idx; this_o_idx = next_o_idx)
+	for (this_o_idx = cave_o_idx(cave, y, x); this_o_idx; this_o_idx = next_o_idx)
 	{
 		object_type *o_ptr;
 
@@ -1778,7 +1775,7 @@ static bool project_m(int who, int r, int y, int x, int dam, int typ,
 	char m_name[80];
 	char m_poss[80];
 
-	int m_idx = cave->m_idx[y][x];
+	int m_idx = cave_m_idx(cave, y, x);
 
 	/* Assume no note */
 	int m_note = MON_MSG_NONE;
@@ -2895,10 +2892,10 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ,
 	char killer[80];
 
 	/* No player here */
-	if (!(cave->m_idx[y][x] < 0)) return (FALSE);
+	if (!(cave_m_idx(cave, y, x) < 0)) return (FALSE);
 
 	/* Never affect projector */
-	if (cave->m_idx[y][x] == who) return (FALSE);
+	if (cave_m_idx(cave, y, x) == who) return (FALSE);
 
 	/* Source monster */
 	m_ptr = cave_monster(cave, who);
@@ -3120,6 +3117,9 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 	/* Encoded "radius" info (see above) */
 	byte gm[16];
 
+	/* Line of sight from the centre of the explosion */
+	struct los_source from_centre;
+
 
 	/* Hack -- Jump to target */
 	if (flg & (PROJECT_JUMP))
@@ -3284,6 +3284,7 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 	}
 
 	/* Determine the blast area, work from the inside out */
+	los_source_init(&from_centre, y2, x2);
 	for (dist = 0; dist <= rad; dist++)
 	{
 		/* Scan the maximal blast area of radius "dist" */
@@ -3298,7 +3299,7 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 				if (distance(y2, x2, y, x) != dist) continue;
 
 				/* Ball explosions are stopped by walls */
-				if (!los(y2, x2, y, x)) continue;
+				if (!los_from(&from_centre, y, x)) continue;
 
 				/* Save this grid */
 				gy[grids] = y;
@@ -3472,7 +3473,7 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 			y = project_m_y;
 
 			/* Track if possible */
-			if (cave->m_idx[y][x] > 0)
+			if (cave_m_idx(cave, y, x) > 0)
 			{
 				monster_type *m_ptr = cave_monster_at(cave, y, x);
 
@@ -111,7 +111,7 @@ bool warding_glyph(void)
 	int py = p_ptr->py;
 	int px = p_ptr->px;
 
-	if (cave->feat[py][px] != FEAT_FLOOR)
+	if (cave_feat(cave, py, px) != FEAT_FLOOR)
 	{
 		msg("There is no clear floor on which to cast the spell.");
 		return FALSE;
@@ -137,7 +137,7 @@ void warding_glyph_spell(void)
 	if (!warding_glyph()) return;
 
 	/* Push objects off the grid */
-	if (cave->o_idx[py][px]) push_object(py, px);
+	if (cave_o_idx(cave, py, px)) push_object(py, px);
 }
 	
 
@@ -488,8 +488,8 @@ void map_area(void)
 	/* Drag the co-ordinates into the dungeon */
 	if (y1 < 0) y1 = 0;
 	if (x1 < 0) x1 = 0;
-	if (y2 > DUNGEON_HGT - 1) y2 = DUNGEON_HGT - 1;
-	if (x2 > DUNGEON_WID - 1) x2 = DUNGEON_WID - 1;
+	if (y2 > cave->height - 1) y2 = cave->height - 1;
+	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
 	/* Scan the dungeon */
 	for (y = y1; y < y2; y++)
@@ -497,15 +497,15 @@ void map_area(void)
 		for (x = x1; x < x2; x++)
 		{
 			/* All non-walls are "checked" */
-			if (cave->feat[y][x] < FEAT_SECRET)
+			if (cave_feat(cave, y, x) < FEAT_SECRET)
 			{
 				if (!in_bounds_fully(y, x)) continue;
 
 				/* Memorize normal features */
-				if (cave->feat[y][x] > FEAT_INVIS)
+				if (cave_feat(cave, y, x) > FEAT_INVIS)
 				{
 					/* Memorize the object */
-					cave->info[y][x] |= (CAVE_MARK);
+					cave_info_on(cave, y, x, CAVE_MARK);
 					cave_light_spot(cave, y, x);
 				}
 
@@ -516,10 +516,10 @@ void map_area(void)
 					int xx = x + ddx_ddd[i];
 
 					/* Memorize walls (etc) */
-					if (cave->feat[yy][xx] >= FEAT_SECRET)
+					if (cave_feat(cave, yy, xx) >= FEAT_SECRET)
 					{
 						/* Memorize the walls */
-						cave->info[yy][xx] |= (CAVE_MARK);
+						cave_info_on(cave, yy, xx, CAVE_MARK);
 						cave_light_spot(cave, yy, xx);
 					}
 				}
@@ -562,7 +562,7 @@ bool detect_traps(bool aware)
 			if (!in_bounds_fully(y, x)) continue;
 
 			/* Detect invisible traps */
-			if (cave->feat[y][x] == FEAT_INVIS)
+			if (cave_feat(cave, y, x) == FEAT_INVIS)
 			{
 				/* Pick a trap */
 				pick_trap(y, x);
@@ -572,7 +572,7 @@ bool detect_traps(bool aware)
 			if (cave_isknowntrap(cave, y, x))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 
 				/* We found something to detect */
 				detect = TRUE;
@@ -605,7 +605,7 @@ bool detect_traps(bool aware)
 			}
 
 			/* Mark as trap-detected */
-			cave->info2[y][x] |= CAVE2_DTRAP;
+			cave_info2(cave, y, x) |= CAVE2_DTRAP;
 		}
 	}
 
@@ -668,17 +668,17 @@ bool detect_doorstairs(bool aware)
 			if (!in_bounds_fully(y, x)) continue;
 
 			/* Detect secret doors */
-			if (cave->feat[y][x] == FEAT_SECRET)
+			if (cave_feat(cave, y, x) == FEAT_SECRET)
 				place_closed_door(cave, y, x);
 
 			/* Detect doors */
-			if (((cave->feat[y][x] >= FEAT_DOOR_HEAD) &&
-			     (cave->feat[y][x] <= FEAT_DOOR_TAIL)) ||
-			    ((cave->feat[y][x] == FEAT_OPEN) ||
-			     (cave->feat[y][x] == FEAT_BROKEN)))
+			if (((cave_feat(cave, y, x) >= FEAT_DOOR_HEAD) &&
+			     (cave_feat(cave, y, x) <= FEAT_DOOR_TAIL)) ||
+			    ((cave_feat(cave, y, x) == FEAT_OPEN) ||
+			     (cave_feat(cave, y, x) == FEAT_BROKEN)))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -688,11 +688,11 @@ bool detect_doorstairs(bool aware)
 			}
 
 			/* Detect stairs */
-			if ((cave->feat[y][x] == FEAT_LESS) ||
-			    (cave->feat[y][x] == FEAT_MORE))
+			if ((cave_feat(cave, y, x) == FEAT_LESS) ||
+			    (cave_feat(cave, y, x) == FEAT_MORE))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -720,6 +720,8 @@ bool detect_doorstairs(bool aware)
  */
 bool detect_treasure(bool aware, bool full)
 {
+	struct cave_iter it;
+	object_type *o_ptr;
 	int i;
 	int y, x;
 	int x1, x2, y1, y2;
@@ -744,16 +746,16 @@ bool detect_treasure(bool aware, bool full)
 			if (!in_bounds_fully(y, x)) continue;
 
 			/* Notice embedded gold */
-			if ((cave->feat[y][x] == FEAT_MAGMA_H) ||
-				    (cave->feat[y][x] == FEAT_QUARTZ_H))
+			if ((cave_feat(cave, y, x) == FEAT_MAGMA_H) ||
+				    (cave_feat(cave, y, x) == FEAT_QUARTZ_H))
 				/* Expose the gold */
-				cave->feat[y][x] += 0x02;
+				cave_feat(cave, y, x) += 0x02;
 
 			/* Magma/Quartz + Known Gold */
-			if ((cave->feat[y][x] == FEAT_MAGMA_K) ||
-			    (cave->feat[y][x] == FEAT_QUARTZ_K)) {
+			if ((cave_feat(cave, y, x) == FEAT_MAGMA_K) ||
+			    (cave_feat(cave, y, x) == FEAT_QUARTZ_K)) {
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -764,33 +766,23 @@ bool detect_treasure(bool aware, bool full)
 		}
 	}
 
-	/* Scan objects */
-	for (i = 1; i < o_max; i++)	{
-		object_type *o_ptr = object_byid(i);
-
-		/* Skip dead objects */
-		if (!o_ptr->kind) continue;
-
-		/* Skip held objects */
-		if (o_ptr->held_m_idx) continue;
+	/* Scan the objects in the area */
+	cave_iter_objects(&it, cave, y1, x1, y2, x2);
+	while (cave_iter_next(&it, &y, &x)) {
+		for (i = cave_o_idx(cave, y, x); i; i = o_ptr->next_o_idx) {
+			o_ptr = object_byid(i);
 
-		/* Location */
-		y = o_ptr->iy;
-		x = o_ptr->ix;
-
-		/* Only detect nearby objects */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
+			/* Memorize it */
+			if (o_ptr->marked < MARK_SEEN)
+				o_ptr->marked = full ? MARK_SEEN : MARK_AWARE;
 
-		/* Memorize it */
-		if (o_ptr->marked < MARK_SEEN)
-			o_ptr->marked = full ? MARK_SEEN : MARK_AWARE;
+			/* Detect */
+			if (!squelch_item_ok(o_ptr) || !full)
+				objects = TRUE;
+		}
 
 		/* Redraw */
 		cave_light_spot(cave, y, x);
-
-		/* Detect */
-		if (!squelch_item_ok(o_ptr) || !full)
-			objects = TRUE;
 	}
 
 	if (gold_buried)
@@ -835,19 +827,19 @@ bool detect_close_buried_treasure(void)
 			if (!in_bounds_fully(y, x)) continue;
 
 			/* Notice embedded gold */
-			if ((cave->feat[y][x] == FEAT_MAGMA_H) ||
-			    (cave->feat[y][x] == FEAT_QUARTZ_H))
+			if ((cave_feat(cave, y, x) == FEAT_MAGMA_H) ||
+			    (cave_feat(cave, y, x) == FEAT_QUARTZ_H))
 			{
 				/* Expose the gold */
-				cave->feat[y][x] += 0x02;
+				cave_feat(cave, y, x) += 0x02;
 			}
 
 			/* Magma/Quartz + Known Gold */
-			if ((cave->feat[y][x] == FEAT_MAGMA_K) ||
-			    (cave->feat[y][x] == FEAT_QUARTZ_K))
+			if ((cave_feat(cave, y, x) == FEAT_MAGMA_K) ||
+			    (cave_feat(cave, y, x) == FEAT_QUARTZ_K))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_info_on(cave, y, x, CAVE_MARK);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -872,6 +864,8 @@ bool detect_close_buried_treasure(void)
  */
 bool detect_objects_magic(bool aware)
 {
+	struct cave_iter it;
+	object_type *o_ptr;
 	int i, y, x, tv;
 	int x1, x2, y1, y2;
 
@@ -888,45 +882,35 @@ bool detect_objects_magic(bool aware)
 	if (x1 < 0) x1 = 0;
 
 
-	/* Scan all objects */
-	for (i = 1; i < o_max; i++)
+	/* Scan the objects in the area */
+	cave_iter_objects(&it, cave, y1, x1, y2, x2);
+	while (cave_iter_next(&it, &y, &x))
 	{
-		object_type *o_ptr = object_byid(i);
-
-		/* Skip dead objects */
-		if (!o_ptr->kind) continue;
-
-		/* Skip held objects */
-		if (o_ptr->held_m_idx) continue;
-
-		/* Location */
-		y = o_ptr->iy;
-		x = o_ptr->ix;
-
-
-		/* Only detect nearby objects */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
-
-		/* Examine the tval */
-		tv = o_ptr->tval;
-
-		/* Artifacts, misc magic items, or enchanted wearables */
-		if (o_ptr->artifact || o_ptr->ego ||
-		    (tv == TV_AMULET) || (tv == TV_RING) ||
-		    (tv == TV_STAFF) || (tv == TV_WAND) || (tv == TV_ROD) ||
-		    (tv == TV_SCROLL) || (tv == TV_POTION) ||
-		    (tv == TV_MAGIC_BOOK) || (tv == TV_PRAYER_BOOK) ||
-		    ((o_ptr->to_a > 0) || (o_ptr->to_finesse + o_ptr->to_prowess > 0)))
+		for (i = cave_o_idx(cave, y, x); i; i = o_ptr->next_o_idx)
 		{
-			/* Memorize the item */
-			o_ptr->marked = MARK_SEEN;
+			o_ptr = object_byid(i);
+
+			/* Examine the tval */
+			tv = o_ptr->tval;
+
+			/* Artifacts, misc magic items, or enchanted wearables */
+			if (o_ptr->artifact || o_ptr->ego ||
+			    (tv == TV_AMULET) || (tv == TV_RING) ||
+			    (tv == TV_STAFF) || (tv == TV_WAND) || (tv == TV_ROD) ||
+			    (tv == TV_SCROLL) || (tv == TV_POTION) ||
+			    (tv == TV_MAGIC_BOOK) || (tv == TV_PRAYER_BOOK) ||
+			    ((o_ptr->to_a > 0) || (o_ptr->to_finesse + o_ptr->to_prowess > 0)))
+			{
+				/* Memorize the item */
+				o_ptr->marked = MARK_SEEN;
 
-			/* Redraw */
-			cave_light_spot(cave, y, x);
+				/* Redraw */
+				cave_light_spot(cave, y, x);
 
-			/* Detect */
-			if (!squelch_item_ok(o_ptr))
-				detect = TRUE;
+				/* Detect */
+				if (!squelch_item_ok(o_ptr))
+					detect = TRUE;
+			}
 		}
 	}
 
@@ -944,6 +928,7 @@ bool detect_objects_magic(bool aware)
  */
 bool detect_monsters_normal(bool aware)
 {
+	struct cave_iter it;
 	int i, y, x;
 	int x1, x2, y1, y2;
 
@@ -961,21 +946,16 @@ bool detect_monsters_normal(bool aware)
 
 
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++)
+	/* Scan the monsters in the area */
+	cave_iter_monsters(&it, cave, y1, x1, y2, x2);
+	while (cave_iter_next(&it, &y, &x))
 	{
-		monster_type *m_ptr = cave_monster(cave, i);
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
-
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx) continue;
+		monster_type *m_ptr;
+		monster_race *r_ptr;
 
-		/* Location */
-		y = m_ptr->fy;
-		x = m_ptr->fx;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
+		i = cave_m_idx(cave, y, x);
+		m_ptr = cave_monster(cave, i);
+		r_ptr = &r_info[m_ptr->r_idx];
 
 		/* Detect all non-invisible, obvious monsters */
 		if (!rf_has(r_ptr->flags, RF_INVISIBLE) && !m_ptr->unaware)
@@ -1006,6 +986,7 @@ bool detect_monsters_normal(bool aware)
  */
 bool detect_monsters_invis(bool aware)
 {
+	struct cave_iter it;
 	int i, y, x;
 	int x1, x2, y1, y2;
 
@@ -1021,22 +1002,18 @@ bool detect_monsters_invis(bool aware)
 	if (x1 < 0) x1 = 0;
 
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++)
+	/* Scan the monsters in the area */
+	cave_iter_monsters(&it, cave, y1, x1, y2, x2);
+	while (cave_iter_next(&it, &y, &x))
 	{
-		monster_type *m_ptr = cave_monster(cave, i);
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
-		monster_lore *l_ptr = &l_list[m_ptr->r_idx];
+		monster_type *m_ptr;
+		monster_race *r_ptr;
+		monster_lore *l_ptr;
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx) continue;
-
-		/* Location */
-		y = m_ptr->fy;
-		x = m_ptr->fx;
-
-		/* Only detect nearby objects */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
+		i = cave_m_idx(cave, y, x);
+		m_ptr = cave_monster(cave, i);
+		r_ptr = &r_info[m_ptr->r_idx];
+		l_ptr = &l_list[m_ptr->r_idx];
 
 		/* Detect invisible monsters */
 		if (rf_has(r_ptr->flags, RF_INVISIBLE))
@@ -1077,6 +1054,7 @@ bool detect_monsters_invis(bool aware)
  */
 bool detect_monsters_evil(bool aware)
 {
+	struct cave_iter it;
 	int i, y, x;
 	int x1, x2, y1, y2;
 
@@ -1092,22 +1070,18 @@ bool detect_monsters_evil(bool aware)
 	if (x1 < 0) x1 = 0;
 
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++)
+	/* Scan the monsters in the area */
+	cave_iter_monsters(&it, cave, y1, x1, y2, x2);
+	while (cave_iter_next(&it, &y, &x))
 	{
-		monster_type *m_ptr = cave_monster(cave, i);
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
-		monster_lore *l_ptr = &l_list[m_ptr->r_idx];
-
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx) continue;
+		monster_type *m_ptr;
+		monster_race *r_ptr;
+		monster_lore *l_ptr;
 
-		/* Location */
-		y = m_ptr->fy;
-		x = m_ptr->fx;
-
-		/* Only detect nearby objects */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
+		i = cave_m_idx(cave, y, x);
+		m_ptr = cave_monster(cave, i);
+		r_ptr = &r_info[m_ptr->r_idx];
+		l_ptr = &l_list[m_ptr->r_idx];
 
 		/* Detect evil monsters */
 		if (rf_has(r_ptr->flags, RF_EVIL))
@@ -1172,14 +1146,14 @@ void stair_creation(void)
 	int px = p_ptr->px;
 
 	/* Only allow stairs to be created on empty floor */
-	if (cave->feat[py][px] != FEAT_FLOOR)
+	if (cave_feat(cave, py, px) != FEAT_FLOOR)
 	{
 		msg("There is no empty floor here.");
 		return;
 	}
 
 	/* Push objects off the grid */
-	if (cave->o_idx[py][px]) push_object(py, px);
+	if (cave_o_idx(cave, py, px)) push_object(py, px);
 	
 	/* Create a staircase */
 	if (!p_ptr->depth)
@@ -1998,15 +1972,15 @@ void destroy_area(int y1, int x1, int r, bool full)
 			if (k > r) continue;
 
 			/* Lose room and vault */
-			cave->info[y][x] &= ~(CAVE_ROOM | CAVE_ICKY);
+			cave_info_off(cave, y, x, CAVE_ROOM | CAVE_ICKY);
 
 			/* Lose light and knowledge */
-			cave->info[y][x] &= ~(CAVE_GLOW | CAVE_MARK);
+			cave_info_off(cave, y, x, CAVE_GLOW | CAVE_MARK);
 			
 			cave_light_spot(cave, y, x);
 
 			/* Hack -- Notice player affect */
-			if (cave->m_idx[y][x] < 0)
+			if (cave_m_idx(cave, y, x) < 0)
 			{
 				/* Hurt the player later */
 				flag = TRUE;
@@ -2079,9 +2053,6 @@ void destroy_area(int y1, int x1, int r, bool full)
 	/* Fully update the visuals */
 	p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_MONSTERS);
 
-	/* Fully update the flow */
-	p_ptr->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
-
 	/* Redraw monster list */
 	p_ptr->redraw |= (PR_MONLIST | PR_ITEMLIST);
 }
@@ -2152,10 +2123,10 @@ void earthquake(int cy, int cx, int r)
 			if (distance(cy, cx, yy, xx) > r) continue;
 
 			/* Lose room and vault */
-			cave->info[yy][xx] &= ~(CAVE_ROOM | CAVE_ICKY);
+			cave_info_off(cave, yy, xx, CAVE_ROOM | CAVE_ICKY);
 
 			/* Lose light and knowledge */
-			cave->info[yy][xx] &= ~(CAVE_GLOW | CAVE_MARK);
+			cave_info_off(cave, yy, xx, CAVE_GLOW | CAVE_MARK);
 			
 			/* Skip the epicenter */
 			if (!dx && !dy) continue;
@@ -2273,7 +2244,7 @@ void earthquake(int cy, int cx, int r)
 			if (!map[16+yy-cy][16+xx-cx]) continue;
 
 			/* Process monsters */
-			if (cave->m_idx[yy][xx] > 0)
+			if (cave_m_idx(cave, yy, xx) > 0)
 			{
 				monster_type *m_ptr = cave_monster_at(cave, yy, xx);
 				monster_race *r_ptr = &r_info[m_ptr->r_idx];
@@ -2300,7 +2271,7 @@ void earthquake(int cy, int cx, int r)
 							if (!cave_empty_bold(y, x)) continue;
 
 							/* Hack -- no safety on glyph of warding */
-							if (cave->feat[y][x] == FEAT_GLYPH) continue;
+							if (cave_feat(cave, y, x) == FEAT_GLYPH) continue;
 
 							/* Important -- Skip "quake" grids */
 							if (map[16+y-cy][16+x-cx]) continue;
@@ -2428,9 +2399,6 @@ void earthquake(int cy, int cx, int r)
 	/* Fully update the visuals */
 	p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_MONSTERS);
 
-	/* Fully update the flow */
-	p_ptr->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
-
 	/* Update the health bar */
 	p_ptr->redraw |= (PR_HEALTH);
 
@@ -2462,10 +2430,10 @@ static void cave_light(struct point_set *ps)
 		int x = ps->pts[i].x;
 
 		/* No longer in the array */
-		cave->info[y][x] &= ~(CAVE_TEMP);
+		cave_info_off(cave, y, x, CAVE_TEMP);
 
 		/* Perma-Light */
-		cave->info[y][x] |= (CAVE_GLOW);
+		cave_info_on(cave, y, x, CAVE_GLOW);
 	}
 
 	/* Fully update the visuals */
@@ -2484,7 +2452,7 @@ static void cave_light(struct point_set *ps)
 		cave_light_spot(cave, y, x);
 
 		/* Process affected monsters */
-		if (cave->m_idx[y][x] > 0)
+		if (cave_m_idx(cave, y, x) > 0)
 		{
 			int chance = 25;
 
@@ -2529,16 +2497,16 @@ static void cave_unlight(struct point_set *ps)
 		int x = ps->pts[i].x;
 
 		/* No longer in the array */
-		cave->info[y][x] &= ~(CAVE_TEMP);
+		cave_info_off(cave, y, x, CAVE_TEMP);
 
 		/* Darken the grid */
-		cave->info[y][x] &= ~(CAVE_GLOW);
+		cave_info_off(cave, y, x, CAVE_GLOW);
 
 		/* Hack -- Forget "boring" grids */
-		if (cave->feat[y][x] <= FEAT_INVIS)
+		if (cave_feat(cave, y, x) <= FEAT_INVIS)
 		{
 			/* Forget the grid */
-			cave->info[y][x] &= ~(CAVE_MARK);
+			cave_info_off(cave, y, x, CAVE_MARK);
 		}
 	}
 
@@ -2565,13 +2533,13 @@ static void cave_unlight(struct point_set *ps)
 static void cave_room_aux(struct point_set *seen, int y, int x)
 {
 	/* Avoid infinite recursion */
-	if (cave->info[y][x] & (CAVE_TEMP)) return;
+	if (cave_info(cave, y, x) & (CAVE_TEMP)) return;
 
 	/* Do not "leave" the current room */
-	if (!(cave->info[y][x] & (CAVE_ROOM))) return;
+	if (!(cave_info(cave, y, x) & (CAVE_ROOM))) return;
 
 	/* Mark the grid as "seen" */
-	cave->info[y][x] |= (CAVE_TEMP);
+	cave_info_on(cave, y, x, CAVE_TEMP);
 
 	/* Add it to the "seen" set */
 	add_to_point_set(seen, y, x);
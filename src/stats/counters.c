@@ -0,0 +1,129 @@
+/*
+ * File: stats/counters.c
+ * Purpose: sparse, hashed counter storage for stats runs
+ *
+ * Copyright (c) 2011 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational,
+ *    research,
+ *    and not for profit purposes provided that this copyright and
+ *    statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "stats/counters.h"
+
+/*
+ * Stats histograms are mostly empty, so rather than a dense array per
+ * object kind we keep one open-addressed hash table of the counters that
+ * are actually used. Zero is never stored as a count, so it marks an empty
+ * slot.
+ */
+
+#define COUNTERS_MIN_SIZE	1024
+
+static size_t counters_hash(unsigned long long key)
+{
+	/* Finalizer from MurmurHash3, which spreads packed indices well */
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return (size_t)key;
+}
+
+static struct counter_entry *counters_find(struct counter_entry *entries,
+	size_t size, unsigned long long key)
+{
+	size_t i = counters_hash(key) & (size - 1);
+
+	/* Linear probing; the table is never allowed to fill up */
+	while (entries[i].count && entries[i].key != key)
+		i = (i + 1) & (size - 1);
+
+	return &entries[i];
+}
+
+static void counters_grow(struct counter_store *cs)
+{
+	struct counter_entry *old = cs->entries;
+	size_t old_size = cs->size;
+	size_t i;
+
+	cs->size *= 2;
+	cs->entries = C_ZNEW(cs->size, struct counter_entry);
+
+	for (i = 0; i < old_size; i++) {
+		if (old[i].count)
+			*counters_find(cs->entries, cs->size, old[i].key) = old[i];
+	}
+
+	mem_free(old);
+}
+
+struct counter_store *counters_new(void)
+{
+	struct counter_store *cs = ZNEW(struct counter_store);
+
+	cs->size = COUNTERS_MIN_SIZE;
+	cs->entries = C_ZNEW(cs->size, struct counter_entry);
+	return cs;
+}
+
+void counters_free(struct counter_store *cs)
+{
+	if (!cs) return;
+	mem_free(cs->entries);
+	mem_free(cs);
+}
+
+/**
+ * Add n to the counter for key.
+ */
+void counters_add(struct counter_store *cs, unsigned long long key, u32b n)
+{
+	struct counter_entry *e;
+
+	if (!n) return;
+
+	/* Keep the load factor under 3/4 */
+	if ((cs->used + 1) * 4 > cs->size * 3)
+		counters_grow(cs);
+
+	e = counters_find(cs->entries, cs->size, key);
+	if (!e->count) {
+		e->key = key;
+		cs->used++;
+	}
+	e->count += n;
+}
+
+u32b counters_get(const struct counter_store *cs, unsigned long long key)
+{
+	return counters_find(cs->entries, cs->size, key)->count;
+}
+
+bool counters_next(const struct counter_store *cs, size_t *iter,
+	unsigned long long *key, u32b *count)
+{
+	while (*iter < cs->size) {
+		const struct counter_entry *e = &cs->entries[(*iter)++];
+
+		if (!e->count) continue;
+
+		*key = e->key;
+		*count = e->count;
+		return TRUE;
+	}
+
+	return FALSE;
+}
@@ -0,0 +1,54 @@
+/*
+ * File: stats/counters.h
+ * Purpose: interface to sparse, hashed counter storage
+ *
+ * Copyright (c) 2011 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational,
+ *    research,
+ *    and not for profit purposes provided that this copyright and
+ *    statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef STATS_COUNTERS_H
+#define STATS_COUNTERS_H
+
+/*
+ * A counter store maps 64-bit keys to u32b counts, holding only the keys
+ * which have been counted. Callers pack whatever indices they need into
+ * the key.
+ */
+struct counter_entry {
+	unsigned long long key;
+	u32b count;
+};
+
+struct counter_store {
+	struct counter_entry *entries;
+	size_t size;		/* always a power of two */
+	size_t used;
+};
+
+extern struct counter_store *counters_new(void);
+extern void counters_free(struct counter_store *cs);
+extern void counters_add(struct counter_store *cs, unsigned long long key,
+	u32b n);
+extern u32b counters_get(const struct counter_store *cs,
+	unsigned long long key);
+
+/*
+ * Step through every nonzero counter, in no particular order. Start with
+ * *iter set to zero; returns FALSE when there are no more.
+ */
+extern bool counters_next(const struct counter_store *cs, size_t *iter,
+	unsigned long long *key, u32b *count);
+
+#endif /* STATS_COUNTERS_H */
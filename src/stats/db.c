@@ -29,6 +29,24 @@ static sqlite3 *db;
 static char *ANGBAND_DIR_STATS;
 static char *db_filename;
 
+/* Bulk writer state: one cached INSERT statement per table, plus the
+ * cost of writing it in the current transaction */
+struct stats_db_table {
+	char *name;
+	int num_cols;
+	sqlite3_stmt *stmt;
+	u32b rows;
+	u32b zeros;
+	clock_t time;
+};
+
+static struct stats_db_table *bulk_tables;
+static int bulk_count;
+static int bulk_alloc;
+static struct stats_db_table *bulk_current;
+static clock_t bulk_mark;
+static clock_t bulk_commit_time;
+
 /* Utility functions */
 static bool stats_make_output_dir(void) {
 	size_t size = strlen(ANGBAND_DIR_USER) + strlen(PATH_SEP) + 6;
@@ -42,6 +60,23 @@ static bool stats_make_output_dir(void) {
 	}
 }
 
+/**
+ * Set up a newly opened connection for large batched writes. A crash can
+ * lose the last transaction, but not corrupt the file, and long runs keep
+ * their own checkpoints anyway.
+ */
+static int stats_db_tune(void) {
+	int err;
+
+	err = sqlite3_exec(db, "PRAGMA journal_mode = WAL;", NULL, NULL, NULL);
+	if (err) return err;
+
+	err = sqlite3_exec(db, "PRAGMA synchronous = NORMAL;", NULL, NULL, NULL);
+	if (err) return err;
+
+	return sqlite3_exec(db, "PRAGMA cache_size = -65536;", NULL, NULL, NULL);
+}
+
 /* Interface functions */
 
 /**
@@ -71,7 +106,7 @@ bool stats_db_open(void) {
 	}
 
 	result = sqlite3_open(db_filename, &db);
-	if (result) {
+	if (result || stats_db_tune()) {
 		sqlite3_close(db);
 		return false;
 	}
@@ -79,11 +114,59 @@ bool stats_db_open(void) {
 	return true;	
 }
 
+/**
+ * Call stats_db_reopen instead of stats_db_open to add to the existing
+ * database called name in the stats directory, e.g. to resume an
+ * interrupted run. Returns true on success, false on failure.
+ */
+bool stats_db_reopen(const char *name) {
+	size_t size;
+	int result;
+
+	if (!stats_make_output_dir()) {
+		return false;
+	}
+
+	size = strlen(ANGBAND_DIR_STATS) + strlen(PATH_SEP) + strlen(name) + 1;
+	db_filename = mem_alloc(size * sizeof(char));
+	path_build(db_filename, size, ANGBAND_DIR_STATS, name);
+
+	if (!file_exists(db_filename)) {
+		return false;
+	}
+
+	result = sqlite3_open(db_filename, &db);
+	if (result || stats_db_tune()) {
+		sqlite3_close(db);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Return the full path of the open database file, so that other output
+ * can be kept beside it.
+ */
+const char *stats_db_filename(void) {
+	return db_filename;
+}
+
 /**
  * Call stats_close_db to close the database connection and free 
  * module variables.
  */
 bool stats_db_close(void) {
+	int i;
+
+	for (i = 0; i < bulk_count; i++) {
+		sqlite3_finalize(bulk_tables[i].stmt);
+		string_free(bulk_tables[i].name);
+	}
+	mem_free(bulk_tables);
+	bulk_tables = NULL;
+	bulk_count = bulk_alloc = 0;
+
 	sqlite3_close(db);
 	mem_free(ANGBAND_DIR_STATS);
 	mem_free(db_filename);
@@ -160,6 +243,155 @@ int stats_db_bind_rv(sqlite3_stmt *sql_stmt, int col, random_value rv) {
 		SQLITE_STATIC);
 }
 
+/**
+ * The bulk writer is for the count tables, whose rows are all of the form
+ * (level, count, key...). Call stats_db_bulk_begin() to open a
+ * transaction, then for each table call stats_db_bulk_table() followed by
+ * stats_db_bulk_row() for each cell, and finally stats_db_bulk_end() to
+ * commit. Statements are prepared once per table and reused by every
+ * later write, and only nonzero cells become rows.
+ */
+
+/* Charge the time since the last mark to the current table */
+static void stats_db_bulk_charge(void) {
+	clock_t now = clock();
+
+	if (bulk_current) bulk_current->time += now - bulk_mark;
+	bulk_mark = now;
+}
+
+int stats_db_bulk_begin(void) {
+	int i;
+
+	for (i = 0; i < bulk_count; i++) {
+		bulk_tables[i].rows = 0;
+		bulk_tables[i].zeros = 0;
+		bulk_tables[i].time = 0;
+	}
+	bulk_current = NULL;
+	bulk_mark = clock();
+
+	return stats_db_exec("BEGIN TRANSACTION;");
+}
+
+/**
+ * Direct following rows to table, which has num_cols columns.
+ */
+int stats_db_bulk_table(const char *table, int num_cols) {
+	char sql_buf[256];
+	size_t len;
+	int i, err;
+
+	stats_db_bulk_charge();
+
+	for (i = 0; i < bulk_count; i++) {
+		if (streq(bulk_tables[i].name, table)) {
+			bulk_current = &bulk_tables[i];
+			assert(bulk_current->num_cols == num_cols);
+			return SQLITE_OK;
+		}
+	}
+
+	strnfmt(sql_buf, sizeof(sql_buf), "INSERT INTO %s VALUES(?", table);
+	len = strlen(sql_buf);
+	for (i = 1; i < num_cols; i++)
+		len += strnfmt(sql_buf + len, sizeof(sql_buf) - len, ",?");
+	my_strcat(sql_buf, ");", sizeof(sql_buf));
+
+	if (bulk_count == bulk_alloc) {
+		bulk_alloc = bulk_alloc ? bulk_alloc * 2 : 16;
+		bulk_tables = mem_realloc(bulk_tables,
+			bulk_alloc * sizeof(*bulk_tables));
+	}
+
+	bulk_current = &bulk_tables[bulk_count];
+	WIPE(bulk_current, struct stats_db_table);
+
+	err = stats_db_stmt_prep(&bulk_current->stmt, sql_buf);
+	if (err) {
+		bulk_current = NULL;
+		return err;
+	}
+
+	bulk_current->name = string_make(table);
+	bulk_current->num_cols = num_cols;
+	bulk_count++;
+
+	return SQLITE_OK;
+}
+
+/**
+ * Write one cell of the current table. The num_keys ints after num_keys
+ * fill the columns after level and count. Cells with a zero count are
+ * skipped.
+ */
+int stats_db_bulk_row(u32b level, u32b count, int num_keys, ...) {
+	sqlite3_stmt *stmt = bulk_current->stmt;
+	va_list vp;
+	int err, col;
+
+	assert(num_keys + 2 == bulk_current->num_cols);
+
+	if (!count) {
+		bulk_current->zeros++;
+		return SQLITE_OK;
+	}
+
+	err = sqlite3_bind_int(stmt, 1, level);
+	if (err) return err;
+	err = sqlite3_bind_int(stmt, 2, count);
+	if (err) return err;
+
+	va_start(vp, num_keys);
+	for (col = 3; col <= num_keys + 2; col++) {
+		err = sqlite3_bind_int(stmt, col, va_arg(vp, int));
+		if (err) break;
+	}
+	va_end(vp);
+	if (err) return err;
+
+	err = sqlite3_step(stmt);
+	if (err && err != SQLITE_DONE) return err;
+
+	bulk_current->rows++;
+	return sqlite3_reset(stmt);
+}
+
+int stats_db_bulk_end(void) {
+	int err;
+
+	stats_db_bulk_charge();
+	bulk_current = NULL;
+
+	/* The commit is charged separately */
+	err = stats_db_exec("COMMIT;");
+	bulk_commit_time = clock() - bulk_mark;
+
+	return err;
+}
+
+/**
+ * Print the rows written, zero cells skipped and CPU time spent per table
+ * in the last bulk write, followed by the time taken by the commit.
+ */
+void stats_db_bulk_report(void) {
+	clock_t total = 0;
+	int i;
+
+	printf("%-24s %10s %12s %8s\n", "table", "rows", "zeros", "secs");
+	for (i = 0; i < bulk_count; i++) {
+		struct stats_db_table *t = &bulk_tables[i];
+
+		printf("%-24s %10u %12u %8.2f\n", t->name, t->rows, t->zeros,
+			(double)t->time / CLOCKS_PER_SEC);
+		total += t->time;
+	}
+	printf("%-24s %10s %12s %8.2f\n", "(commit)", "", "",
+		(double)bulk_commit_time / CLOCKS_PER_SEC);
+	printf("%-24s %10s %12s %8.2f\n", "total", "", "",
+		(double)(total + bulk_commit_time) / CLOCKS_PER_SEC);
+}
+
 /**
  * I have chosen not to wrap the other sqlite3 core interfaces, since
  * they do not require access to the database connection object db.
@@ -40,6 +40,8 @@
 	if (err) return err;
 
 extern bool stats_db_open(void);
+extern bool stats_db_reopen(const char *name);
+extern const char *stats_db_filename(void);
 extern bool stats_db_close(void);
 extern int stats_db_exec(char *sql_str);
 extern int stats_db_stmt_prep(sqlite3_stmt **sql_stmt, char *sql_str);
@@ -47,5 +49,10 @@ extern int stats_db_bind_ints(sqlite3_stmt *sql_stmt, int num_cols,
 	int offset, ...);
 extern int stats_db_bind_rv(sqlite3_stmt *sql_stmt, int col,
 	random_value rv);
+extern int stats_db_bulk_begin(void);
+extern int stats_db_bulk_table(const char *table, int num_cols);
+extern int stats_db_bulk_row(u32b level, u32b count, int num_keys, ...);
+extern int stats_db_bulk_end(void);
+extern void stats_db_bulk_report(void);
 
 #endif /* STATS_DB_H */
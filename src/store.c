@@ -554,9 +554,9 @@ static struct store *current_store(void)
 	if (store_knowledge != STORE_NONE)
 		n = store_knowledge;
 
-	else if ((cave->feat[p_ptr->py][p_ptr->px] >= FEAT_SHOP_HEAD) &&
-			(cave->feat[p_ptr->py][p_ptr->px] <= FEAT_SHOP_TAIL))
-		n = cave->feat[p_ptr->py][p_ptr->px] - FEAT_SHOP_HEAD;
+	else if ((cave_feat(cave, p_ptr->py, p_ptr->px) >= FEAT_SHOP_HEAD) &&
+			(cave_feat(cave, p_ptr->py, p_ptr->px) <= FEAT_SHOP_TAIL))
+		n = cave_feat(cave, p_ptr->py, p_ptr->px) - FEAT_SHOP_HEAD;
 
 	if (n != STORE_NONE)
 		return &stores[n];
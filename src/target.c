@@ -333,7 +333,7 @@ static bool target_set_interactive_accept(int y, int x)
 
 
 	/* Player grids are always interesting */
-	if (cave->m_idx[y][x] < 0) return (TRUE);
+	if (cave_m_idx(cave, y, x) < 0) return (TRUE);
 
 
 	/* Handle hallucination */
@@ -341,7 +341,7 @@ static bool target_set_interactive_accept(int y, int x)
 
 
 	/* Visible monsters */
-	if (cave->m_idx[y][x] > 0)
+	if (cave_m_idx(cave, y, x) > 0)
 	{
 		monster_type *m_ptr = cave_monster_at(cave, y, x);
 
@@ -357,22 +357,22 @@ static bool target_set_interactive_accept(int y, int x)
 	}
 
 	/* Interesting memorized features */
-	if (cave->info[y][x] & (CAVE_MARK))
+	if (cave_info(cave, y, x) & (CAVE_MARK))
 	{
 		/* Notice glyphs */
-		if (cave->feat[y][x] == FEAT_GLYPH) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_GLYPH) return (TRUE);
 
 		/* Notice doors */
-		if (cave->feat[y][x] == FEAT_OPEN) return (TRUE);
-		if (cave->feat[y][x] == FEAT_BROKEN) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_OPEN) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_BROKEN) return (TRUE);
 
 		/* Notice stairs */
-		if (cave->feat[y][x] == FEAT_LESS) return (TRUE);
-		if (cave->feat[y][x] == FEAT_MORE) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_LESS) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_MORE) return (TRUE);
 
 		/* Notice shops */
-		if ((cave->feat[y][x] >= FEAT_SHOP_HEAD) &&
-		    (cave->feat[y][x] <= FEAT_SHOP_TAIL)) return (TRUE);
+		if ((cave_feat(cave, y, x) >= FEAT_SHOP_HEAD) &&
+		    (cave_feat(cave, y, x) <= FEAT_SHOP_TAIL)) return (TRUE);
 
 		/* Notice traps */
 		if (cave_isknowntrap(cave, y, x)) return TRUE;
@@ -381,11 +381,11 @@ static bool target_set_interactive_accept(int y, int x)
 		if (cave_iscloseddoor(cave, y, x)) return TRUE;
 
 		/* Notice rubble */
-		if (cave->feat[y][x] == FEAT_RUBBLE) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_RUBBLE) return (TRUE);
 
 		/* Notice veins with treasure */
-		if (cave->feat[y][x] == FEAT_MAGMA_K) return (TRUE);
-		if (cave->feat[y][x] == FEAT_QUARTZ_K) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_MAGMA_K) return (TRUE);
+		if (cave_feat(cave, y, x) == FEAT_QUARTZ_K) return (TRUE);
 	}
 
 	/* Nope */
@@ -415,10 +415,10 @@ static struct point_set *target_set_interactive_prepare(int mode)
 			if (mode & (TARGET_KILL))
 			{
 				/* Must contain a monster */
-				if (!(cave->m_idx[y][x] > 0)) continue;
+				if (!(cave_m_idx(cave, y, x) > 0)) continue;
 
 				/* Must be a targettable monster */
-			 	if (!target_able(cave->m_idx[y][x])) continue;
+			 	if (!target_able(cave_m_idx(cave, y, x))) continue;
 			}
 
 			/* Save the location */
@@ -634,7 +634,7 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 		s3 = "";
 
 		/* The player */
-		if (cave->m_idx[y][x] < 0) {
+		if (cave_m_idx(cave, y, x) < 0) {
 			/* Description */
 			s1 = "You are ";
 
@@ -666,7 +666,7 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 		}
 
 		/* Actual monsters */
-		if (cave->m_idx[y][x] > 0) {
+		if (cave_m_idx(cave, y, x) > 0) {
 			monster_type *m_ptr = cave_monster_at(cave, y, x);
 			r_ptr = &r_info[m_ptr->r_idx];
 			l_ptr = &l_list[m_ptr->r_idx];
@@ -711,7 +711,7 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 						char buf[80];
 
 						/* Describe the monster */
-						look_mon_desc(buf, sizeof(buf), cave->m_idx[y][x]);
+						look_mon_desc(buf, sizeof(buf), cave_m_idx(cave, y, x));
 
 						/* Describe, and prompt for recall */
 						if (p_ptr->wizard)
@@ -961,10 +961,10 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 
 
 		/* Feature (apply "mimic") */
-		feat = f_info[cave->feat[y][x]].mimic;
+		feat = f_info[cave_feat(cave, y, x)].mimic;
 
 		/* Require knowledge about grid, or ability to see grid */
-		if (!(cave->info[y][x] & (CAVE_MARK)) && !player_can_see_bold(y,x))
+		if (!(cave_info(cave, y, x) & (CAVE_MARK)) && !player_can_see_bold(y,x))
 		{
 			/* Forget feature */
 			feat = FEAT_NONE;
@@ -1054,7 +1054,7 @@ bool target_set_closest(int mode)
 	/* Find the first monster in the queue */
 	y = targets->pts[0].y;
 	x = targets->pts[0].x;
-	m_idx = cave->m_idx[y][x];
+	m_idx = cave_m_idx(cave, y, x);
 	
 	/* Target the monster, if possible */
 	if ((m_idx <= 0) || !target_able(m_idx))
@@ -1147,7 +1147,7 @@ static int draw_path(u16b path_n, u16b *path_g, wchar_t *c, byte *a, int y1, int
 		Term_what(Term->scr->cx, Term->scr->cy, a+i, c+i);
 
 		/* Choose a colour. */
-		if (cave->m_idx[y][x] && cave_monster_at(cave, y, x)->ml) {
+		if (cave_m_idx(cave, y, x) && cave_monster_at(cave, y, x)->ml) {
 			/* Visible monsters are red. */
 			monster_type *m_ptr = cave_monster_at(cave, y, x);
 			monster_race *r_ptr = &r_info[m_ptr->r_idx];
@@ -1159,16 +1159,16 @@ static int draw_path(u16b path_n, u16b *path_g, wchar_t *c, byte *a, int y1, int
 				colour = TERM_L_RED;
 		}
 
-		else if (cave->o_idx[y][x] && object_byid(cave->o_idx[y][x])->marked)
+		else if (cave_o_idx(cave, y, x) && object_byid(cave_o_idx(cave, y, x))->marked)
 			/* Known objects are yellow. */
 			colour = TERM_YELLOW;
 
 		else if (!cave_floor_bold(y,x) &&
-				 ((cave->info[y][x] & (CAVE_MARK)) || player_can_see_bold(y,x)))
+				 ((cave_info(cave, y, x) & (CAVE_MARK)) || player_can_see_bold(y,x)))
 			/* Known walls are blue. */
 			colour = TERM_BLUE;
 
-		else if (!(cave->info[y][x] & (CAVE_MARK)) && !player_can_see_bold(y,x))
+		else if (!(cave_info(cave, y, x) & (CAVE_MARK)) && !player_can_see_bold(y,x))
 			/* Unknown squares are grey. */
 			colour = TERM_L_DARK;
 
@@ -1320,8 +1320,8 @@ bool target_set_interactive(int mode, int x, int y)
 		
 			/* Update help */
 			if (help) {
-				bool good_target = (cave->m_idx[y][x] > 0) &&
-					target_able(cave->m_idx[y][x]);
+				bool good_target = (cave_m_idx(cave, y, x) > 0) &&
+					target_able(cave_m_idx(cave, y, x));
 				target_display_help(good_target, !(flag && point_set_size(targets)));
 			}
 
@@ -1356,7 +1356,7 @@ bool target_set_interactive(int mode, int x, int y)
 					x = KEY_GRID_X(press);//.mouse.x;
 					if (press.mouse.mods & KC_MOD_CONTROL) {
 						/* same as keyboard target selection command below */
-						int m_idx = cave->m_idx[y][x];
+						int m_idx = cave_m_idx(cave, y, x);
 
 						if ((m_idx > 0) && target_able(m_idx)) {
 							monster_type *m_ptr = cave_monster(cave, m_idx);
@@ -1383,7 +1383,7 @@ bool target_set_interactive(int mode, int x, int y)
 				{
 					y = KEY_GRID_Y(press);//.mouse.y;
 					x = KEY_GRID_X(press);//.mouse.x;
-					if (cave->m_idx[y][x] || cave->o_idx[y][x]){// || cave->feat[y][x]&) {
+					if (cave_m_idx(cave, y, x) || cave_o_idx(cave, y, x)){// || cave_feat(cave, y, x)&) {
 						/* reset the flag, to make sure we stay in this mode if
 						 * something is actually there */
 						flag = FALSE;
@@ -1455,7 +1455,7 @@ bool target_set_interactive(int mode, int x, int y)
 				case '0':
 				case '.':
 				{
-					int m_idx = cave->m_idx[y][x];
+					int m_idx = cave_m_idx(cave, y, x);
 
 					if ((m_idx > 0) && target_able(m_idx))
 					{
@@ -1477,6 +1477,14 @@ bool target_set_interactive(int mode, int x, int y)
 					done = TRUE;
 					break;
 				}
+
+				case 'G':
+				{
+					cmd_insert(CMD_TRAVEL);
+					cmd_set_arg_point(cmd_get_top(), 0, x, y);
+					done = TRUE;
+					break;
+				}
 				
 				case '?':
 				{
@@ -1553,7 +1561,7 @@ bool target_set_interactive(int mode, int x, int y)
 			/* Update help */
 			if (help) 
 			{
-				bool good_target = ((cave->m_idx[y][x] > 0) && target_able(cave->m_idx[y][x]));
+				bool good_target = ((cave_m_idx(cave, y, x) > 0) && target_able(cave_m_idx(cave, y, x)));
 				target_display_help(good_target, !(flag && point_set_size(targets)));
 			}
 
@@ -1615,8 +1623,8 @@ bool target_set_interactive(int mode, int x, int y)
 				/*if (press.mouse.button == 3) {
 				} else*/
 				{
-					int dungeon_hgt = (p_ptr->depth == 0) ? TOWN_HGT : DUNGEON_HGT;
-					int dungeon_wid = (p_ptr->depth == 0) ? TOWN_WID : DUNGEON_WID;
+					int dungeon_hgt = cave->height;
+					int dungeon_wid = cave->width;
 
 					y = KEY_GRID_Y(press);//.mouse.y;
 					x = KEY_GRID_X(press);//.mouse.x;
@@ -1654,7 +1662,7 @@ bool target_set_interactive(int mode, int x, int y)
 						targets = target_set_interactive_prepare(mode);
 					}
 
-					if (cave->m_idx[y][x] || cave->o_idx[y][x]) {
+					if (cave_m_idx(cave, y, x) || cave_o_idx(cave, y, x)) {
 						/* scan the interesting list and see if there in anything here */
 						for (i = 0; i < point_set_size(targets); i++) {
 							if ((y == targets->pts[i].y) && (x == targets->pts[i].x)) {
@@ -1746,6 +1754,14 @@ bool target_set_interactive(int mode, int x, int y)
 					break;
 				}
 
+				case 'G':
+				{
+					cmd_insert(CMD_TRAVEL);
+					cmd_set_arg_point(cmd_get_top(), 0, x, y);
+					done = TRUE;
+					break;
+				}
+
 				case '?':
 				{
 					help = !help;
@@ -1775,8 +1791,8 @@ bool target_set_interactive(int mode, int x, int y)
 			/* Handle "direction" */
 			if (d)
 			{
-				int dungeon_hgt = (p_ptr->depth == 0) ? TOWN_HGT : DUNGEON_HGT;
-				int dungeon_wid = (p_ptr->depth == 0) ? TOWN_WID : DUNGEON_WID;
+				int dungeon_hgt = cave->height;
+				int dungeon_wid = cave->width;
 
 				/* Move */
 				x += ddx[d];
@@ -1857,3 +1873,27 @@ s16b target_get_monster(void)
 {
 	return target_who;
 }
+
+
+/**
+ * Save the whole target, including an unchecked one.
+ */
+void target_save(struct target_state *t)
+{
+	t->set = target_set;
+	t->who = target_who;
+	t->x = target_x;
+	t->y = target_y;
+}
+
+
+/**
+ * Put back a target saved by target_save().
+ */
+void target_restore(const struct target_state *t)
+{
+	target_set = t->set;
+	target_who = t->who;
+	target_x = t->x;
+	target_y = t->y;
+}
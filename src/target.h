@@ -13,4 +13,14 @@ bool get_aim_dir(int *dp);
 void target_get(s16b *col, s16b *row);
 s16b target_get_monster(void);
 
+/* A copy of the target, for code which may clear it temporarily */
+struct target_state {
+	bool set;
+	u16b who;
+	s16b x, y;
+};
+
+void target_save(struct target_state *t);
+void target_restore(const struct target_state *t);
+
 #endif /* !TARGET_H */
@@ -0,0 +1,225 @@
+/* cave/flow
+ *
+ * Tests for the monster flow in cave.c
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "cave.h"
+#include "monster/constants.h"
+#include "z-rand.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	Rand_quick = TRUE;
+	Rand_value = 1;
+	cave = cave_new();
+	cave_resize(cave, 22, 44);
+	character_dungeon = TRUE;
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	character_dungeon = FALSE;
+	cave_free(cave);
+	cave = NULL;
+	return 0;
+}
+
+/* A random feature for the inside of the map */
+static int random_feat(void) {
+	switch (randint0(8)) {
+		case 0: return FEAT_WALL_EXTRA;
+		case 1: return FEAT_RUBBLE;
+		case 2: return FEAT_DOOR_HEAD + randint0(FEAT_DOOR_TAIL - FEAT_DOOR_HEAD + 1);
+		case 3: return FEAT_SECRET;
+		default: return FEAT_FLOOR;
+	}
+}
+
+/* Fill the map, with the player on a floor grid in the middle */
+static void fill_map(void) {
+	int y, x;
+
+	cave_forget_flow(cave);
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			if (cave_in_bounds_fully(cave, y, x))
+				cave_set_feat(cave, y, x, random_feat());
+			else
+				cave_set_feat(cave, y, x, FEAT_PERM_SOLID);
+		}
+
+	p_ptr->py = cave->height / 2;
+	p_ptr->px = cave->width / 2;
+	cave_set_feat(cave, p_ptr->py, p_ptr->px, FEAT_FLOOR);
+}
+
+/* Copy the costs of the flow, with -1 for grids outside it */
+static void save_flow(int *costs) {
+	int y, x;
+	byte now = cave_when(cave, p_ptr->py, p_ptr->px);
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++)
+			*costs++ = (cave_when(cave, y, x) == now) ?
+				cave_cost(cave, y, x) : -1;
+}
+
+/* Work the flow out afresh and compare it with "costs" */
+static int check_flow(const int *costs) {
+	static int fresh[22 * 44];
+	int i;
+
+	cave_forget_flow(cave);
+	cave_update_flow(cave);
+	save_flow(fresh);
+
+	for (i = 0; i < cave->height * cave->width; i++)
+		if (fresh[i] != costs[i]) return 0;
+
+	return 1;
+}
+
+int test_doors(void *state) {
+	int x;
+
+	/* A corridor along the middle row */
+	fill_map();
+	for (x = 1; x < cave->width - 1; x++)
+		cave_set_feat(cave, p_ptr->py - 1, x, FEAT_WALL_EXTRA);
+	for (x = 1; x < cave->width - 1; x++)
+		cave_set_feat(cave, p_ptr->py, x, FEAT_FLOOR);
+	for (x = 1; x < cave->width - 1; x++)
+		cave_set_feat(cave, p_ptr->py + 1, x, FEAT_WALL_EXTRA);
+
+	cave_set_feat(cave, p_ptr->py, p_ptr->px + 2, FEAT_DOOR_HEAD);
+	cave_set_feat(cave, p_ptr->py, p_ptr->px + 4, FEAT_DOOR_HEAD + 1);
+	cave_set_feat(cave, p_ptr->py, p_ptr->px - 2, FEAT_SECRET);
+	cave_update_flow(cave);
+
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px + 1), 1);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px + 2), 3);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px + 3), 4);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px + 4), 7);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px + 5), 8);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px - 2), 3);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px - 3), 4);
+
+	/* Opening a door mends the flow behind it */
+	cave_set_feat(cave, p_ptr->py, p_ptr->px + 2, FEAT_OPEN);
+	cave_update_flow(cave);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px + 2), 2);
+	eq(cave_cost(cave, p_ptr->py, p_ptr->px + 5), 7);
+	ok;
+}
+
+int test_repair(void *state) {
+	static int costs[22 * 44];
+	int i, j;
+
+	for (i = 0; i < 50; i++) {
+		fill_map();
+		cave_update_flow(cave);
+
+		/* Change a few grids, and mend the flow */
+		for (j = 0; j < 1 + i % 6; j++) {
+			int y = randint1(cave->height - 2);
+			int x = randint1(cave->width - 2);
+
+			if (y == p_ptr->py && x == p_ptr->px) continue;
+			cave_set_feat(cave, y, x, random_feat());
+		}
+		cave_update_flow(cave);
+		save_flow(costs);
+
+		require(check_flow(costs));
+	}
+
+	ok;
+}
+
+int test_sources(void *state) {
+	static int from_player[22 * 44], from_source[22 * 44], both[22 * 44];
+	int sy, sx, i;
+
+	fill_map();
+	sy = 3;
+	sx = 4;
+	cave_set_feat(cave, sy, sx, FEAT_FLOOR);
+
+	/* The flow from the player and from the source on their own */
+	cave_update_flow(cave);
+	save_flow(from_player);
+	cave_forget_flow(cave);
+	p_ptr->py = sy;
+	p_ptr->px = sx;
+	cave_update_flow(cave);
+	save_flow(from_source);
+
+	/* Both together, with the source five steps further off */
+	cave_forget_flow(cave);
+	p_ptr->py = cave->height / 2;
+	p_ptr->px = cave->width / 2;
+	require(cave_flow_add_source(cave, sy, sx, 5));
+	cave_update_flow(cave);
+	save_flow(both);
+
+	for (i = 0; i < cave->height * cave->width; i++) {
+		int best = from_player[i];
+
+		if (from_source[i] >= 0 && from_source[i] + 5 < MONSTER_FLOW_DEPTH &&
+				(best < 0 || from_source[i] + 5 < best))
+			best = from_source[i] + 5;
+		eq(both[i], best);
+	}
+
+	cave_flow_clear_sources(cave);
+	ok;
+}
+
+int test_noise(void *state) {
+	int y, x, i;
+
+	cave_forget_flow(cave);
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++)
+			cave_set_feat(cave, y, x, cave_in_bounds_fully(cave, y, x) ?
+				FEAT_FLOOR : FEAT_PERM_SOLID);
+	p_ptr->py = cave->height / 2;
+	p_ptr->px = cave->width / 2;
+	cave_update_flow(cave);
+	eq(cave_cost(cave, 3, 4), 18);
+
+	/* A noise draws monsters while it lasts, even as the clock rebases */
+	cave->sense_turn = 0xFFFF - MAX_UCHAR - 3;
+	cave_make_noise(cave, 3, 4, NOISE_FIGHT);
+	cave_update_flow(cave);
+	eq(cave_cost(cave, 3, 4), NOISE_FIGHT);
+	eq(cave_cost(cave, 3, 6), NOISE_FIGHT + 2);
+
+	for (i = 1; i < NOISE_FIGHT; i++) {
+		cave_senses_tick(cave);
+		cave_update_flow(cave);
+		eq(cave_cost(cave, 3, 4), NOISE_FIGHT);
+	}
+	require(cave->sense_turn < 0xFFFF - MAX_UCHAR - 3);
+
+	/* And no longer */
+	cave_senses_tick(cave);
+	eq(cave_noise(cave, 3, 4), 0);
+	cave_update_flow(cave);
+	eq(cave_cost(cave, 3, 4), 18);
+	ok;
+}
+
+const char *suite_name = "cave/flow";
+struct test tests[] = {
+	{ "doors", test_doors },
+	{ "repair", test_repair },
+	{ "sources", test_sources },
+	{ "noise", test_noise },
+	{ NULL, NULL },
+};
@@ -0,0 +1,199 @@
+/* cave/index
+ *
+ * Tests for the walks over monster and object grids in cave.c, and for
+ * the grid bitboards they use
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "z-bitboard.h"
+#include "z-rand.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	los_init();
+	Rand_quick = TRUE;
+	Rand_value = 1;
+	cave = cave_new();
+	cave_resize(cave, 30, 140);
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(cave);
+	cave = NULL;
+	return 0;
+}
+
+/* Scatter monsters, objects and walls, with the player somewhere too */
+static void fill(void) {
+	int y, x;
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			cave_set_m_idx(cave, y, x, one_in_(6) ? randint1(100) : 0);
+			cave_set_o_idx(cave, y, x, one_in_(9) ? randint1(100) : 0);
+			if (one_in_(5))
+				cave_info_on(cave, y, x, CAVE_WALL);
+			else
+				cave_info_off(cave, y, x, CAVE_WALL);
+		}
+
+	cave_set_m_idx(cave, 10, 70, -1);
+}
+
+/* Check a walk against every grid of the rectangle it was started on */
+static int check_walk(struct cave_iter *it, bool objects, int y1, int x1,
+		int y2, int x2, int cy, int cx, int r, bool los_too) {
+	int y, x, wy, wx;
+	bool more = cave_iter_next(it, &wy, &wx);
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			bool want = objects ? cave_o_idx(cave, y, x) != 0 :
+				cave_m_idx(cave, y, x) > 0;
+
+			if (y < y1 || y > y2 || x < x1 || x > x2) want = FALSE;
+			if (r >= 0 && distance(cy, cx, y, x) > r) want = FALSE;
+			if (los_too && !los(cy, cx, y, x)) want = FALSE;
+			if (!want) continue;
+
+			if (!more || wy != y || wx != x) return 0;
+			more = cave_iter_next(it, &wy, &wx);
+		}
+
+	return !more;
+}
+
+int test_rect(void *state) {
+	struct cave_iter it;
+	int n;
+
+	for (n = 0; n < 200; n++) {
+		int y1 = randint0(cave->height + 4) - 2;
+		int x1 = randint0(cave->width + 4) - 2;
+		int y2 = y1 + randint0(cave->height);
+		int x2 = x1 + randint0(cave->width);
+
+		fill();
+		cave_iter_monsters(&it, cave, y1, x1, y2, x2);
+		require(check_walk(&it, FALSE, y1, x1, y2, x2, 0, 0, -1, FALSE));
+		cave_iter_objects(&it, cave, y1, x1, y2, x2);
+		require(check_walk(&it, TRUE, y1, x1, y2, x2, 0, 0, -1, FALSE));
+	}
+
+	/* An empty rectangle */
+	cave_iter_monsters(&it, cave, 5, 9, 5, 8);
+	require(check_walk(&it, FALSE, 5, 9, 5, 8, 0, 0, -1, FALSE));
+
+	ok;
+}
+
+int test_near(void *state) {
+	struct cave_iter it;
+	int n;
+
+	for (n = 0; n < 200; n++) {
+		int y = randint0(cave->height);
+		int x = randint0(cave->width);
+		int r = randint0(25);
+		bool los_too = one_in_(2);
+
+		fill();
+		cave_iter_monsters(&it, cave, y - r, x - r, y + r, x + r);
+		cave_iter_near(&it, y, x, r, los_too);
+		require(check_walk(&it, FALSE, y - r, x - r, y + r, x + r, y, x, r,
+			los_too));
+		cave_iter_objects(&it, cave, y - r, x - r, y + r, x + r);
+		cave_iter_near(&it, y, x, r, los_too);
+		require(check_walk(&it, TRUE, y - r, x - r, y + r, x + r, y, x, r,
+			los_too));
+	}
+
+	ok;
+}
+
+int test_moves(void *state) {
+	struct cave_iter it;
+
+	fill();
+
+	/* A monster that dies, and one that moves in on ahead of the walk */
+	cave_set_m_idx(cave, 3, 3, 7);
+	cave_set_m_idx(cave, 3, 4, 0);
+	cave_set_m_idx(cave, 20, 100, 0);
+	cave_iter_monsters(&it, cave, 0, 0, cave->height - 1, cave->width - 1);
+	cave_set_m_idx(cave, 3, 3, 0);
+	cave_set_m_idx(cave, 20, 100, 9);
+	require(check_walk(&it, FALSE, 0, 0, cave->height - 1, cave->width - 1,
+		0, 0, -1, FALSE));
+
+	ok;
+}
+
+/* Whether c->empty_grids holds exactly the grids cave_isempty() finds */
+static int check_empty(void) {
+	int y, x;
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++)
+			if (bitboard_get(cave->empty_grids, y, x) !=
+					cave_isempty(cave, y, x))
+				return 0;
+
+	return 1;
+}
+
+int test_empty(void *state) {
+	int n;
+
+	fill();
+	require(check_empty());
+
+	/* Change one thing about a grid at a time */
+	for (n = 0; n < 3000; n++) {
+		int y = randint0(cave->height);
+		int x = randint0(cave->width);
+
+		switch (randint0(3)) {
+			case 0:
+				cave_set_feat(cave, y, x,
+					one_in_(3) ? FEAT_WALL_EXTRA : FEAT_FLOOR);
+				break;
+			case 1:
+				cave_set_m_idx(cave, y, x, one_in_(2) ? randint1(100) : 0);
+				break;
+			default:
+				cave_set_o_idx(cave, y, x, one_in_(2) ? randint1(100) : 0);
+				break;
+		}
+
+		if (n % 100 == 0) require(check_empty());
+	}
+	require(check_empty());
+
+	/* The player's grid is not empty */
+	cave_set_feat(cave, 10, 70, FEAT_FLOOR);
+	cave_set_o_idx(cave, 10, 70, 0);
+	cave_set_m_idx(cave, 10, 70, -1);
+	require(!bitboard_get(cave->empty_grids, 10, 70));
+	cave_set_m_idx(cave, 10, 70, 0);
+	require(bitboard_get(cave->empty_grids, 10, 70));
+
+	/* Resizing to the same size starts afresh */
+	cave_resize(cave, cave->height, cave->width);
+	require(bitboard_count(cave->empty_grids) == 0);
+
+	ok;
+}
+
+const char *suite_name = "cave/index";
+struct test tests[] = {
+	{ "rect", test_rect },
+	{ "near", test_near },
+	{ "moves", test_moves },
+	{ "empty", test_empty },
+	{ NULL, NULL },
+};
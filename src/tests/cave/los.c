@@ -0,0 +1,86 @@
+/* cave/los
+ *
+ * Tests for the line of sight table in cave.c
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "z-rand.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	los_init();
+	Rand_quick = TRUE;
+	Rand_value = 1;
+	cave = cave_new();
+	cave_resize(cave, 22, 44);
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(cave);
+	cave = NULL;
+	return 0;
+}
+
+/* Wall off one grid in "one_in" at random */
+static void fill_walls(int one_in) {
+	int y, x;
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			if (one_in && !randint0(one_in))
+				cave_info_on(cave, y, x, CAVE_WALL);
+			else
+				cave_info_off(cave, y, x, CAVE_WALL);
+		}
+}
+
+/* Compare los() and los_from() with los_walk() for every pair of grids */
+static int check_all_pairs(void) {
+	int y1, x1, y2, x2;
+
+	for (y1 = 0; y1 < cave->height; y1++)
+		for (x1 = 0; x1 < cave->width; x1++) {
+			struct los_source s;
+
+			los_source_init(&s, y1, x1);
+			for (y2 = 0; y2 < cave->height; y2++)
+				for (x2 = 0; x2 < cave->width; x2++) {
+					bool walk = los_walk(cave, y1, x1, y2, x2);
+
+					if (los(y1, x1, y2, x2) != walk) return 0;
+					if (los_from(&s, y2, x2) != walk) return 0;
+				}
+		}
+
+	return 1;
+}
+
+int test_open(void *state) {
+	fill_walls(0);
+	require(check_all_pairs());
+	ok;
+}
+
+int test_sparse(void *state) {
+	fill_walls(8);
+	require(check_all_pairs());
+	ok;
+}
+
+int test_dense(void *state) {
+	fill_walls(3);
+	require(check_all_pairs());
+	ok;
+}
+
+const char *suite_name = "cave/los";
+struct test tests[] = {
+	{ "open", test_open },
+	{ "sparse", test_sparse },
+	{ "dense", test_dense },
+	{ NULL, NULL },
+};
@@ -0,0 +1,138 @@
+/* cave/senses
+ *
+ * Tests for the noise and scent layers in cave.c
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "cave.h"
+#include "z-rand.h"
+
+int setup_tests(void **state) {
+	int y, x;
+
+	read_edit_files();
+	cave = cave_new();
+	cave_resize(cave, 22, 44);
+
+	/* An open floor with a wall down the middle, open at the bottom */
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			if (!cave_in_bounds_fully(cave, y, x))
+				cave_set_feat(cave, y, x, FEAT_PERM_SOLID);
+			else if (x == 20 && y < 18)
+				cave_set_feat(cave, y, x, FEAT_WALL_EXTRA);
+			else
+				cave_set_feat(cave, y, x, FEAT_FLOOR);
+		}
+
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(cave);
+	cave = NULL;
+	return 0;
+}
+
+/* Steps from (y, x) to every grid through the floor, or -1 */
+static void steps_from(int y, int x, int *steps) {
+	static int queue[22 * 44];
+	int head = 0, tail = 0, i, d;
+
+	for (i = 0; i < cave->height * cave->width; i++)
+		steps[i] = -1;
+
+	steps[cave_grid(cave, y, x)] = 0;
+	queue[tail++] = cave_grid(cave, y, x);
+
+	while (head < tail) {
+		int g = queue[head++];
+
+		for (d = 0; d < 8; d++) {
+			int y2 = g / cave->width + ddy_ddd[d];
+			int x2 = g % cave->width + ddx_ddd[d];
+			int g2;
+
+			if (!cave_in_bounds(cave, y2, x2)) continue;
+			if (cave_feat(cave, y2, x2) != FEAT_FLOOR) continue;
+
+			g2 = cave_grid(cave, y2, x2);
+			if (steps[g2] >= 0) continue;
+
+			steps[g2] = steps[g] + 1;
+			queue[tail++] = g2;
+		}
+	}
+}
+
+int test_noise(void *state) {
+	static int steps[22 * 44];
+	int y, x, i;
+
+	/* A noise by the wall carries round the end of it */
+	cave_make_noise(cave, 5, 18, 30);
+	steps_from(5, 18, steps);
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			int s = steps[cave_grid(cave, y, x)];
+
+			eq(cave_noise(cave, y, x), (s >= 0 && s < 30) ? 30 - s : 0);
+		}
+
+	/* A quieter noise elsewhere leaves the louder one be */
+	cave_make_noise(cave, 5, 16, 4);
+	eq(cave_noise(cave, 5, 16), 28);
+
+	/* Noises die away */
+	for (i = 0; i < 29; i++)
+		cave_senses_tick(cave);
+	eq(cave_noise(cave, 5, 18), 1);
+	eq(cave_noise(cave, 5, 17), 0);
+	cave_senses_tick(cave);
+	eq(cave_noise(cave, 5, 18), 0);
+
+	ok;
+}
+
+int test_scent(void *state) {
+	int i;
+
+	eq(cave_scent_age(cave, 10, 10), -1);
+
+	cave_leave_scent(cave, 10, 10);
+	eq(cave_scent_age(cave, 10, 10), 0);
+	cave_senses_tick(cave);
+	cave_leave_scent(cave, 10, 11);
+	eq(cave_scent_age(cave, 10, 10), 1);
+	eq(cave_scent_age(cave, 10, 11), 0);
+
+	/* Ages and noises survive the clock wrapping */
+	cave_make_noise(cave, 3, 30, 10);
+	for (i = 0; i < 0x10000; i++)
+		cave_senses_tick(cave);
+	cave_leave_scent(cave, 10, 12);
+	cave_make_noise(cave, 10, 12, 10);
+	for (i = 0; i < 5; i++)
+		cave_senses_tick(cave);
+	eq(cave_scent_age(cave, 10, 12), 5);
+	eq(cave_noise(cave, 10, 12), 5);
+	eq(cave_noise(cave, 3, 30), 0);
+
+	/* A new level starts with no trail */
+	cave_resize(cave, 22, 44);
+	eq(cave_scent_age(cave, 10, 12), -1);
+	eq(cave_noise(cave, 10, 12), 0);
+
+	ok;
+}
+
+const char *suite_name = "cave/senses";
+struct test tests[] = {
+	{ "noise", test_noise },
+	{ "scent", test_scent },
+	{ NULL, NULL },
+};
@@ -0,0 +1,5 @@
+TESTPROGS += cave/los
+TESTPROGS += cave/flow
+TESTPROGS += cave/index
+TESTPROGS += cave/senses
+TESTPROGS += cave/view
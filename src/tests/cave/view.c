@@ -0,0 +1,295 @@
+/* cave/view
+ *
+ * Tests for the incremental view updates in cave.c: after every
+ * update_view() the view must be the one a full rescan finds, and
+ * view_added() and view_removed() must hold exactly the grids that changed
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "cave.h"
+#include "z-rand.h"
+
+#define VIEW_HGT	44
+#define VIEW_WID	88
+
+/* cave_light_spot() draws on the terminal */
+static term test_term;
+
+/* The CAVE_VIEW and CAVE_SEEN flags of every grid before and after */
+static byte before[VIEW_HGT][VIEW_WID];
+static byte after[VIEW_HGT][VIEW_WID];
+
+/* 1 for grids in view_added(), 2 for those in view_removed() */
+static byte delta[VIEW_HGT][VIEW_WID];
+
+int setup_tests(void **state) {
+	int y, x;
+
+	read_edit_files();
+	vinfo_init();
+	temp_g = C_ZNEW(TEMP_MAX, u16b);
+	term_init(&test_term, 80, 24, 0);
+	Term_activate(&test_term);
+
+	Rand_quick = TRUE;
+	Rand_value = 1;
+
+	/* Scattered walls, with a lit area at the top left */
+	cave = cave_new();
+	cave_resize(cave, VIEW_HGT, VIEW_WID);
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			if (!cave_in_bounds_fully(cave, y, x))
+				cave_set_feat(cave, y, x, FEAT_PERM_SOLID);
+			else if (one_in_(6))
+				cave_set_feat(cave, y, x, FEAT_WALL_EXTRA);
+			else
+				cave_set_feat(cave, y, x, FEAT_FLOOR);
+
+			if (y < 20 && x < 40)
+				cave_info_on(cave, y, x, CAVE_GLOW);
+		}
+
+	p_ptr->py = VIEW_HGT / 2;
+	p_ptr->px = VIEW_WID / 2;
+	cave_set_feat(cave, p_ptr->py, p_ptr->px, FEAT_FLOOR);
+	p_ptr->cur_light = 1;
+	p_ptr->timed[TMD_BLIND] = 0;
+
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(cave);
+	cave = NULL;
+	FREE(temp_g);
+	term_nuke(&test_term);
+	return 0;
+}
+
+/* Note the CAVE_VIEW and CAVE_SEEN flags of every grid */
+static void note_view(byte flags[VIEW_HGT][VIEW_WID]) {
+	int y, x;
+
+	for (y = 0; y < VIEW_HGT; y++)
+		for (x = 0; x < VIEW_WID; x++)
+			flags[y][x] = cave_info(cave, y, x) & (CAVE_VIEW | CAVE_SEEN);
+}
+
+/* Mark the grids of a delta in delta[], failing if one is there twice */
+static int note_delta(int n, const u16b *gp, byte mark) {
+	int i;
+
+	for (i = 0; i < n; i++) {
+		int y = GRID_Y(gp[i]);
+		int x = GRID_X(gp[i]);
+
+		if (delta[y][x]) return 0;
+		delta[y][x] = mark;
+	}
+
+	return 1;
+}
+
+/*
+ * Update the view, and check it against a full rescan. A grid which came
+ * into view, or came into sight while in view, must be in view_added();
+ * one whose flags otherwise changed must be in view_removed().
+ */
+static int check_update(void) {
+	const u16b *gp;
+	int n, y, x;
+
+	note_view(before);
+	update_view();
+	note_view(after);
+
+	memset(delta, 0, sizeof(delta));
+	n = view_added(&gp);
+	if (!note_delta(n, gp, 1)) return 0;
+	n = view_removed(&gp);
+	if (!note_delta(n, gp, 2)) return 0;
+
+	/* The rescan leaves the view as the next update expects to find it */
+	forget_view();
+	update_view();
+
+	for (y = 0; y < VIEW_HGT; y++)
+		for (x = 0; x < VIEW_WID; x++) {
+			byte rescan = cave_info(cave, y, x) & (CAVE_VIEW | CAVE_SEEN);
+			byte old = before[y][x];
+			byte now = after[y][x];
+			byte mark = 0;
+
+			if (now != rescan) return 0;
+
+			if (!(old & CAVE_VIEW) && (now & CAVE_VIEW))
+				mark = 1;
+			else if (old != now)
+				mark = (now & CAVE_SEEN) ? 1 : 2;
+
+			if (delta[y][x] != mark) return 0;
+		}
+
+	return 1;
+}
+
+/* Step the player onto a random floor grid next to them, if it is one */
+static void step_player(void) {
+	int d = randint0(8);
+	int y = p_ptr->py + ddy_ddd[d];
+	int x = p_ptr->px + ddx_ddd[d];
+
+	if (cave_feat(cave, y, x) != FEAT_FLOOR) return;
+
+	p_ptr->py = y;
+	p_ptr->px = x;
+}
+
+/*
+ * Raise or knock down a wall, or light or darken a grid, at random within
+ * a few grids of the edge of sight
+ */
+static void change_grid(void) {
+	int y = p_ptr->py + rand_range(-MAX_SIGHT - 4, MAX_SIGHT + 4);
+	int x = p_ptr->px + rand_range(-MAX_SIGHT - 4, MAX_SIGHT + 4);
+
+	if (!cave_in_bounds_fully(cave, y, x)) return;
+	if (y == p_ptr->py && x == p_ptr->px) return;
+
+	switch (randint0(3)) {
+		case 0:
+			if (cave_feat(cave, y, x) == FEAT_FLOOR)
+				cave_set_feat(cave, y, x, FEAT_WALL_EXTRA);
+			else
+				cave_set_feat(cave, y, x, FEAT_FLOOR);
+			break;
+		case 1:
+			cave_info_on(cave, y, x, CAVE_GLOW);
+			break;
+		default:
+			cave_info_off(cave, y, x, CAVE_GLOW);
+			break;
+	}
+}
+
+int test_moves(void *state) {
+	int i;
+
+	require(check_update());
+	for (i = 0; i < 300; i++) {
+		step_player();
+		require(check_update());
+	}
+	ok;
+}
+
+int test_light(void *state) {
+	int i;
+
+	for (i = 0; i < 200; i++) {
+		p_ptr->cur_light = randint0(5);
+		require(check_update());
+
+		/* Nothing changed */
+		require(check_update());
+
+		if (one_in_(4)) step_player();
+	}
+	p_ptr->cur_light = 1;
+	ok;
+}
+
+int test_blind(void *state) {
+	int i;
+
+	for (i = 0; i < 200; i++) {
+		if (one_in_(3))
+			p_ptr->timed[TMD_BLIND] = p_ptr->timed[TMD_BLIND] ? 0 : 10;
+		if (one_in_(2)) p_ptr->cur_light = randint0(5);
+		if (one_in_(2)) step_player();
+		require(check_update());
+	}
+	p_ptr->timed[TMD_BLIND] = 0;
+	p_ptr->cur_light = 1;
+	ok;
+}
+
+int test_terrain(void *state) {
+	int i, j;
+
+	for (i = 0; i < 200; i++) {
+		for (j = randint1(3); j > 0; j--)
+			change_grid();
+		require(check_update());
+	}
+	ok;
+}
+
+/* Whether grid (y, x) is in view on the edge of sight */
+static bool on_edge(int y, int x) {
+	return (cave_info(cave, y, x) & CAVE_VIEW) &&
+		distance(p_ptr->py, p_ptr->px, y, x) == MAX_SIGHT;
+}
+
+/* Light or darken grids in view on the edge of sight */
+int test_edge(void *state) {
+	int i, y, x;
+
+	for (i = 0; i < 200; i++) {
+		int n = 0, pick;
+
+		step_player();
+		require(check_update());
+
+		for (y = 0; y < VIEW_HGT; y++)
+			for (x = 0; x < VIEW_WID; x++)
+				if (on_edge(y, x)) n++;
+		if (!n) continue;
+
+		pick = randint0(n);
+		for (y = 0; y < VIEW_HGT; y++)
+			for (x = 0; x < VIEW_WID; x++)
+				if (on_edge(y, x) && !pick--) {
+					if (cave_info(cave, y, x) & CAVE_GLOW)
+						cave_info_off(cave, y, x, CAVE_GLOW);
+					else
+						cave_info_on(cave, y, x, CAVE_GLOW);
+				}
+		require(check_update());
+	}
+	ok;
+}
+
+int test_random(void *state) {
+	int i;
+
+	for (i = 0; i < 1000; i++) {
+		switch (randint0(4)) {
+			case 0: step_player(); break;
+			case 1: p_ptr->cur_light = randint0(5); break;
+			case 2:
+				p_ptr->timed[TMD_BLIND] = one_in_(4) ? 10 : 0;
+				break;
+			default: change_grid(); break;
+		}
+		require(check_update());
+	}
+	p_ptr->timed[TMD_BLIND] = 0;
+	p_ptr->cur_light = 1;
+	ok;
+}
+
+const char *suite_name = "cave/view";
+struct test tests[] = {
+	{ "moves", test_moves },
+	{ "light", test_light },
+	{ "blind", test_blind },
+	{ "terrain", test_terrain },
+	{ "edge", test_edge },
+	{ "random", test_random },
+	{ NULL, NULL },
+};
@@ -0,0 +1,139 @@
+/* monster/alloc
+ *
+ * Tests for get_mon_num() in monster/mon-make.c
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "monster/mon-make.h"
+#include "z-rand.h"
+
+int setup_tests(void **state) {
+	int i;
+
+	read_edit_files();
+	Rand_quick = TRUE;
+	Rand_value = 1;
+
+	for (i = 0; i < z_info->r_max; i++) {
+		monster_race *r_ptr = &r_info[i];
+
+		r_ptr->cur_num = 0;
+		r_ptr->max_num = rf_has(r_ptr->flags, RF_UNIQUE) ? 1 : 100;
+	}
+
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	get_mon_num_hook = NULL;
+	free_mon_alloc();
+	return 0;
+}
+
+/* get_mon_num() as it was, scanning the whole table on each call */
+static s16b slow_get_mon_num(int level) {
+	static long prob[4096];
+	const alloc_entry *table = alloc_race_table;
+	long total = 0, value;
+	int i, j, k, p;
+
+	if (level > 0 && one_in_(NASTY_MON))
+		level += MIN(level / 4 + 2, MON_OOD_MAX);
+
+	for (i = 0; i < alloc_race_size; i++) {
+		monster_race *r_ptr = &r_info[table[i].index];
+
+		if (table[i].level > level) break;
+		prob[i] = 0;
+		if ((level > 0) && (table[i].level <= 0)) continue;
+		if (rf_has(r_ptr->flags, RF_UNIQUE) &&
+				r_ptr->cur_num >= r_ptr->max_num)
+			continue;
+		if (rf_has(r_ptr->flags, RF_FORCE_DEPTH) &&
+				r_ptr->level > p_ptr->depth)
+			continue;
+		prob[i] = table[i].prob2;
+		total += prob[i];
+	}
+
+	if (total <= 0) return 0;
+
+	p = -1;
+	i = 0;
+	for (k = 0; k < 3; k++) {
+		if (k == 1) {
+			p = randint0(100);
+			if (p >= 60) break;
+		}
+		if (k == 2 && p >= 10) break;
+
+		j = i;
+		value = randint0(total);
+		for (i = 0; value >= prob[i]; i++)
+			value -= prob[i];
+		if (k && table[i].level < table[j].level) i = j;
+	}
+
+	return table[i].index;
+}
+
+/* Only monsters with an even index */
+static bool even_hook(int r_idx) {
+	return !(r_idx % 2);
+}
+
+/* Compare picks, and the random numbers used, at many levels and depths */
+static int compare(int calls) {
+	int n;
+
+	for (n = 0; n < calls; n++) {
+		int level = randint0(120) - 5;
+		u32b seed;
+		s16b slow, fast;
+
+		p_ptr->depth = randint0(100);
+		seed = Rand_value;
+		slow = slow_get_mon_num(level);
+		Rand_value = seed;
+		fast = get_mon_num(level);
+		if (slow != fast) return 0;
+
+		/* Now and then a unique comes or goes */
+		if (one_in_(20)) {
+			monster_race *r_ptr = &r_info[randint1(z_info->r_max - 2)];
+
+			if (rf_has(r_ptr->flags, RF_UNIQUE)) {
+				if (one_in_(2))
+					r_ptr->cur_num = !r_ptr->cur_num;
+				else
+					r_ptr->max_num = !r_ptr->max_num;
+			}
+		}
+	}
+
+	return 1;
+}
+
+int test_picks(void *state) {
+	get_mon_num_hook = NULL;
+	get_mon_num_prep();
+	require(compare(20000));
+
+	/* A restriction, and lifting it again */
+	get_mon_num_hook = even_hook;
+	get_mon_num_prep();
+	require(compare(5000));
+	get_mon_num_hook = NULL;
+	get_mon_num_prep();
+	require(compare(5000));
+
+	ok;
+}
+
+const char *suite_name = "monster/alloc";
+struct test tests[] = {
+	{ "picks", test_picks },
+	{ NULL, NULL },
+};
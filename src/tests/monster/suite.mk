@@ -1 +1,2 @@
 TESTPROGS += monster/attack monster/monster
+TESTPROGS += monster/alloc
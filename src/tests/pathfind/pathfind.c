@@ -1,11 +1,49 @@
 /* pathfind/pathfind */
 
 #include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "cave.h"
 #include "game-cmd.h"
 #include "pathfind.h"
 
-NOSETUP
-NOTEARDOWN
+/* bell() refreshes the terminal when a path can't be found */
+static term test_term;
+
+int setup_tests(void **state) {
+	int y, x;
+
+	read_edit_files();
+	term_init(&test_term, 80, 24, 0);
+	Term_activate(&test_term);
+
+	/*
+	 * A known room split by a wall with a gap at the bottom, and with a
+	 * walled-in grid at (10, 5)
+	 */
+	cave = cave_new();
+	cave_resize(cave, 22, 44);
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			if (!cave_in_bounds_fully(cave, y, x) || (x == 20 && y < 19))
+				cave_info_on(cave, y, x, CAVE_WALL);
+			if (MAX(ABS(y - 10), ABS(x - 5)) == 1)
+				cave_info_on(cave, y, x, CAVE_WALL);
+			cave_info_on(cave, y, x, CAVE_MARK);
+		}
+
+	p_ptr->py = 2;
+	p_ptr->px = 10;
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(cave);
+	cave = NULL;
+	term_nuke(&test_term);
+	return 0;
+}
 
 int test_dir_to(void *state) {
 	eq(pathfind_direction_to(loc(0,0), loc(0,1)), DIR_N);
@@ -24,8 +62,65 @@ int test_dir_to(void *state) {
 	ok;
 }
 
+int test_findpath(void *state) {
+	/* Down to the gap and back up again, starting downwards */
+	require(findpath(2, 30));
+	eq(pathfind_steps_left(), 34);
+	eq(ddy[pathfind_next_dir()], 1);
+
+	require(findpath(19, 20));
+	eq(pathfind_steps_left(), 17);
+	eq(ddy[pathfind_next_dir()], 1);
+
+	require(!findpath(10, 5));
+	ok;
+}
+
+int test_travel(void *state) {
+	require(findpath_travel(2, 40));
+	eq(pathfind_steps_left(), 37);
+	eq(ddy[pathfind_next_dir()], 1);
+
+	require(findpath_travel(20, 1));
+	eq(pathfind_steps_left(), 18);
+	eq(ddy[pathfind_next_dir()], 1);
+
+	require(!findpath_travel(10, 5));
+	ok;
+}
+
+int test_travel_large(void *state) {
+	struct cave *c = cave;
+	int y, x;
+
+	/* A level bigger than DUNGEON_HGT by DUNGEON_WID */
+	cave = cave_new();
+	cave_resize(cave, 200, 250);
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++) {
+			if (!cave_in_bounds_fully(cave, y, x))
+				cave_info_on(cave, y, x, CAVE_WALL);
+			cave_info_on(cave, y, x, CAVE_MARK);
+		}
+
+	p_ptr->py = 190;
+	p_ptr->px = 240;
+	require(findpath_travel(5, 5));
+	eq(pathfind_steps_left(), 235);
+	eq(ddx[pathfind_next_dir()], -1);
+
+	cave_free(cave);
+	cave = c;
+	p_ptr->py = 2;
+	p_ptr->px = 10;
+	ok;
+}
+
 const char *suite_name = "pathfind/pathfind";
 struct test tests[] = {
 	{ "dir-to", test_dir_to },
+	{ "findpath", test_findpath },
+	{ "travel", test_travel },
+	{ "travel-large", test_travel_large },
 	{ NULL, NULL },
 };
@@ -0,0 +1,210 @@
+/* z-bitboard/bitboard.c */
+
+#include "unit-test.h"
+#include "z-bitboard.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* Count the set neighbours of a grid the slow way */
+static int slow_count(struct bitboard *b, int y, int x) {
+	int yd, xd, n = 0;
+
+	for (yd = -1; yd <= 1; yd++) {
+		for (xd = -1; xd <= 1; xd++) {
+			if (!yd && !xd) continue;
+			if (y + yd < 0 || y + yd >= b->height) continue;
+			if (x + xd < 0 || x + xd >= b->width) continue;
+			if (bitboard_get(b, y + yd, x + xd)) n++;
+		}
+	}
+
+	return n;
+}
+
+/* Fill a board with a fixed pseudo-random pattern */
+static void fill(struct bitboard *b) {
+	u32b r = 12345;
+	int y, x;
+
+	for (y = 0; y < b->height; y++) {
+		for (x = 0; x < b->width; x++) {
+			r = r * 1103515245 + 12345;
+			bitboard_put(b, y, x, (r >> 16) % 100 < 45);
+		}
+	}
+}
+
+int test_bits(void *state) {
+	struct bitboard *b = bitboard_new(3, 130);
+
+	eq(b->words, 3);
+	eq(bitboard_count(b), 0);
+
+	bitboard_put(b, 1, 0, TRUE);
+	bitboard_put(b, 1, 63, TRUE);
+	bitboard_put(b, 1, 64, TRUE);
+	bitboard_put(b, 2, 129, TRUE);
+	require(bitboard_get(b, 1, 63));
+	require(bitboard_get(b, 1, 64));
+	require(!bitboard_get(b, 0, 64));
+	eq(bitboard_count(b), 4);
+
+	bitboard_put(b, 1, 63, FALSE);
+	require(!bitboard_get(b, 1, 63));
+	eq(bitboard_count(b), 3);
+
+	bitboard_wipe(b);
+	eq(bitboard_count(b), 0);
+
+	bitboard_free(b);
+	ok;
+}
+
+int test_neighbours(void *state) {
+	struct bitboard *b = bitboard_new(7, 150);
+	u64b c0[3], c1[3], c2[3], c3[3];
+	u64b *count[4] = { c0, c1, c2, c3 };
+	int y, x, k;
+
+	fill(b);
+
+	for (y = 0; y < b->height; y++) {
+		bitboard_neighbours(b, y, count);
+		for (x = 0; x < b->width; x++) {
+			int n = 0;
+			for (k = 0; k < 4; k++)
+				if ((count[k][x / 64] >> (x % 64)) & 1) n |= 1 << k;
+			eq(n, slow_count(b, y, x));
+		}
+	}
+
+	bitboard_free(b);
+	ok;
+}
+
+int test_smooth(void *state) {
+	struct bitboard *b = bitboard_new(9, 140);
+	struct bitboard *old = bitboard_new(9, 140);
+	int y, x;
+
+	fill(b);
+	fill(old);
+
+	bitboard_smooth(b, 3, 4);
+
+	for (y = 0; y < b->height; y++) {
+		for (x = 0; x < b->width; x++) {
+			bool on = bitboard_get(old, y, x);
+			int n = slow_count(old, y, x);
+
+			if (y > 0 && x > 0 && y < b->height - 1 && x < b->width - 1) {
+				if (n < 3) on = FALSE;
+				else if (n > 4) on = TRUE;
+			}
+			eq(bitboard_get(b, y, x), on);
+		}
+	}
+
+	bitboard_free(b);
+	bitboard_free(old);
+	ok;
+}
+
+int test_rect(void *state) {
+	struct bitboard *b = bitboard_new(5, 200);
+	int y, x, n = 0;
+
+	eq(bitboard_span(0, 0, 63) == ~(u64b)0, TRUE);
+	eq(bitboard_span(1, 60, 66) == 0x7, TRUE);
+	eq(bitboard_span(2, 0, 100), 0);
+
+	bitboard_fill(b, 1, 10, 3, 150, TRUE);
+	bitboard_fill(b, 2, 63, 2, 128, FALSE);
+
+	for (y = 0; y < b->height; y++) {
+		for (x = 0; x < b->width; x++) {
+			bool on = y >= 1 && y <= 3 && x >= 10 && x <= 150 &&
+				!(y == 2 && x >= 63 && x <= 128);
+			eq(bitboard_get(b, y, x), on);
+			if (on && x >= 50 && x <= 199) n++;
+		}
+	}
+
+	eq(bitboard_count(b), 3 * 141 - 66);
+	eq(bitboard_count_rect(b, 0, 50, 4, 199), n);
+	eq(bitboard_count_rect(b, 2, 63, 2, 128), 0);
+
+	bitboard_free(b);
+	ok;
+}
+
+int test_prev(void *state) {
+	struct bitboard *b = bitboard_new(2, 200);
+	int y, x, last;
+
+	fill(b);
+	for (y = 0; y < b->height; y++) {
+		last = -1;
+		for (x = 0; x < b->width; x++) {
+			if (bitboard_get(b, y, x)) last = x;
+			eq(bitboard_prev(b, y, x), last);
+		}
+	}
+
+	bitboard_wipe(b);
+	eq(bitboard_prev(b, 1, 199), -1);
+	bitboard_put(b, 1, 0, TRUE);
+	bitboard_put(b, 1, 63, TRUE);
+	eq(bitboard_prev(b, 1, 199), 63);
+	eq(bitboard_prev(b, 1, 62), 0);
+	eq(bitboard_prev(b, 0, 199), -1);
+
+	bitboard_free(b);
+	ok;
+}
+
+int test_select(void *state) {
+	struct bitboard *b = bitboard_new(5, 200);
+	int y, x, k, sy, sx;
+
+	fill(b);
+
+	/* Every set bit of a rectangle, in row order, then none */
+	k = 0;
+	for (y = 1; y <= 3; y++)
+		for (x = 40; x <= 170; x++) {
+			if (!bitboard_get(b, y, x)) continue;
+			require(bitboard_select_rect(b, 1, 40, 3, 170, k, &sy, &sx));
+			eq(sy, y);
+			eq(sx, x);
+			k++;
+		}
+	eq(k, bitboard_count_rect(b, 1, 40, 3, 170));
+	require(!bitboard_select_rect(b, 1, 40, 3, 170, k, &sy, &sx));
+
+	/* The last bit of a word, and a rectangle with nothing in it */
+	bitboard_wipe(b);
+	bitboard_put(b, 4, 63, TRUE);
+	bitboard_put(b, 4, 64, TRUE);
+	require(bitboard_select_rect(b, 0, 0, 4, 199, 0, &sy, &sx));
+	eq(sy, 4);
+	eq(sx, 63);
+	require(bitboard_select_rect(b, 0, 0, 4, 199, 1, &sy, &sx));
+	eq(sx, 64);
+	require(!bitboard_select_rect(b, 0, 0, 3, 199, 0, &sy, &sx));
+
+	bitboard_free(b);
+	ok;
+}
+
+const char *suite_name = "z-bitboard/bitboard";
+struct test tests[] = {
+	{ "bits", test_bits },
+	{ "neighbours", test_neighbours },
+	{ "smooth", test_smooth },
+	{ "rect", test_rect },
+	{ "prev", test_prev },
+	{ "select", test_select },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += z-bitboard/bitboard
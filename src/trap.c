@@ -67,7 +67,7 @@ void pick_trap(int y, int x)
 	};
 
 	/* Paranoia */
-	if (cave->feat[y][x] != FEAT_INVIS) return;
+	if (cave_feat(cave, y, x) != FEAT_INVIS) return;
 
 	/* Pick a trap */
 	while (1)
@@ -118,7 +118,7 @@ void create_trap(struct cave *c, int y, int x)
 void hit_trap(int y, int x)
 {
 	bool ident;
-	struct feature *trap = &f_info[cave->feat[y][x]];
+	struct feature *trap = &f_info[cave_feat(cave, y, x)];
 
 	/* Disturb the player */
 	disturb(p_ptr, 0, 0);
@@ -16,15 +16,6 @@
 
 /**** Available Types ****/
 
-/** An array of 256 bytes */
-typedef byte byte_256[256];
-
-/** An array of DUNGEON_WID bytes */
-typedef byte byte_wid[DUNGEON_WID];
-
-/** An array of DUNGEON_WID s16b's */
-typedef s16b s16b_wid[DUNGEON_WID];
-
 
 
 /** Function hook types **/
@@ -102,6 +93,30 @@ typedef struct feature
 
 
 
+/*
+ * One step in laying out a vault or room template, compiled from its text.
+ * A step with no symbol lays a run of grids of one feature along a row;
+ * otherwise it is a single grid which needs that symbol's special handling.
+ */
+struct stamp_op {
+	byte dy, dx;		/* Offset from the top left corner */
+	byte len;			/* Number of grids in a run */
+	byte feat;			/* Feature of a run */
+	byte info;			/* CAVE_* flags to mark the grids with */
+	char sym;			/* Symbol to handle, or 0 for a run */
+	s16b num;			/* Door number, for room templates */
+};
+
+/*
+ * The compiled layout of a vault or room template.
+ */
+struct stamp {
+	struct stamp_op *ops;		/* Features, doors and traps, in text order */
+	size_t n_ops;
+	struct stamp_op *places;	/* Monsters and objects, placed afterwards */
+	size_t n_places;
+};
+
 /*
  * Information about "vault generation"
  */
@@ -110,6 +125,7 @@ typedef struct vault {
 	unsigned int vidx;
 	char *name;
 	char *text;
+	struct stamp *stamp;	/* Compiled text */
 
 	byte typ;			/* Vault type */
 
@@ -128,6 +144,7 @@ typedef struct room_template {
 	unsigned int tidx;
 	char *name;
 	char *text;
+	struct stamp *stamp;	/* Compiled text */
 
 	byte typ;			/* Room type */
 
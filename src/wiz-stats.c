@@ -566,7 +566,7 @@ static void add_stats(double total[MAX_LVL], double mondrop[MAX_LVL], double inv
 static void get_obj_data(const object_type *o_ptr, int y, int x, bool mon, bool uniq)
 {
 	
-	bool vault = (cave->info[y][x] & (CAVE_ICKY));
+	bool vault = (cave_info(cave, y, x) & (CAVE_ICKY));
 	bitflag f[OF_SIZE];
 	int effect;
 	int number = o_ptr->number;
@@ -2012,8 +2012,8 @@ static void scan_for_objects(void)
 { 
 	int y, x;
 
-	for (y = 1; y < DUNGEON_HGT - 1; y++) {
-		for (x = 1; x < DUNGEON_WID - 1; x++) {
+	for (y = 1; y < cave->height - 1; y++) {
+		for (x = 1; x < cave->width - 1; x++) {
 			const object_type *o_ptr;
 
 			
@@ -2022,7 +2022,7 @@ static void scan_for_objects(void)
 				get_obj_data(o_ptr, y, x, FALSE, FALSE);
 				
 				/* delete the object */
-				delete_object_stat(cave->o_idx[y][x]);
+				delete_object_stat(cave_o_idx(cave, y, x));
 			}
 		}
 	}
@@ -2335,9 +2335,13 @@ int cave_dist[DUNGEON_HGT][DUNGEON_WID];
 void clear_cave_dist(void)
 {
 	int x,y;
-	for (y = 1; y < DUNGEON_HGT - 1; y++){
+
+	/* cave_dist only covers a standard dungeon level */
+	assert(cave->height <= DUNGEON_HGT && cave->width <= DUNGEON_WID);
+
+	for (y = 1; y < cave->height - 1; y++){
 	
-			for (x = 1; x < DUNGEON_WID - 1; x++){
+			for (x = 1; x < cave->width - 1; x++){
 			
 				cave_dist[y][x] = -1;
 			}
@@ -2400,7 +2404,7 @@ void calc_cave_distances(void)
 				if (cave_dist[ty][tx] >= 0) continue;
 				
 				/* Is it a wall? */
-				if (cave->feat[ty][tx] > FEAT_RUBBLE) continue;
+				if (cave_feat(cave, ty, tx) > FEAT_RUBBLE) continue;
 				
 				/* Add the new location */
 				d_y_new[d_new_max] = ty;
@@ -2565,18 +2569,18 @@ void disconnect_stats(void)
 		calc_cave_distances();
 		
 		/*Cycle through the dungeon */
-		for (y = 1; y < DUNGEON_HGT - 1; y++){
+		for (y = 1; y < cave->height - 1; y++){
 		
-			for (x = 1; x < DUNGEON_WID - 1; x++){
+			for (x = 1; x < cave->width - 1; x++){
 			
 				/* don't care about walls */
-				if (cave->feat[y][x] > FEAT_RUBBLE) continue;
+				if (cave_feat(cave, y, x) > FEAT_RUBBLE) continue;
 				
 				/* Can we get there? */
 				if (cave_dist[y][x] >= 0){
 				
 					/* Is it a  down stairs? */
-					if ((cave->feat[y][x] == FEAT_MORE)){
+					if ((cave_feat(cave, y, x) == FEAT_MORE)){
 
 						has_dsc_from_stairs = FALSE;
 					
@@ -2589,7 +2593,7 @@ void disconnect_stats(void)
 				}
 				
 				/* Ignore vaults as they are often disconnected */
-				if (cave->info[y][x] & (CAVE_ICKY)) continue;
+				if (cave_info(cave, y, x) & (CAVE_ICKY)) continue;
 				
 				/* We have a disconnected area */
 				has_dsc = TRUE;
@@ -124,10 +124,10 @@ static void do_cmd_wiz_hack_ben(void)
 				if (!in_bounds_fully(y, x)) continue;
 
 				/* Display proper cost */
-				if (cave->cost[y][x] != i) continue;
+				if (cave_cost(cave, y, x) != i) continue;
 
 				/* Reliability in yellow */
-				if (cave->when[y][x] == cave->when[py][px])
+				if (cave_when(cave, y, x) == cave_when(cave, py, px))
 					a = TERM_YELLOW;
 
 				/* Display player/floors/walls */
@@ -1518,10 +1518,10 @@ static void do_cmd_wiz_query(void)
 			if (!in_bounds_fully(y, x)) continue;
 
 			/* Given mask, show only those grids */
-			if (mask && !(cave->info[y][x] & mask)) continue;
+			if (mask && !(cave_info(cave, y, x) & mask)) continue;
 
 			/* Given no mask, show unknown grids */
-			if (!mask && (cave->info[y][x] & (CAVE_MARK))) continue;
+			if (!mask && (cave_info(cave, y, x) & (CAVE_MARK))) continue;
 
 			/* Color */
 			if (cave_floor_bold(y, x)) a = TERM_YELLOW;
@@ -1998,7 +1998,7 @@ void do_cmd_debug(void)
 		/* Create a trap */
 		case 'T':
 		{
-			if (cave->feat[p_ptr->py][p_ptr->px] != FEAT_FLOOR) 
+			if (cave_feat(cave, p_ptr->py, p_ptr->px) != FEAT_FLOOR) 
 				msg("You can't place a trap there!");
 			else if (p_ptr->depth == 0)
 				msg("You can't place a trap in the town!");
@@ -0,0 +1,364 @@
+/*
+ * File: z-bitboard.c
+ * Purpose: Two-dimensional bit grids with word-parallel operations
+ *
+ * Copyright (c) 2011 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "z-bitboard.h"
+#include "z-virt.h"
+
+/**
+ * Return the number of set bits in a word.
+ */
+int bitboard_bits(u64b w)
+{
+#ifdef __GNUC__
+	return __builtin_popcountll(w);
+#else
+	int n = 0;
+
+	while (w) {
+		w &= w - 1;
+		n++;
+	}
+
+	return n;
+#endif
+}
+
+/**
+ * Return the index of the lowest set bit of a non-zero word.
+ */
+int bitboard_first(u64b w)
+{
+#ifdef __GNUC__
+	return __builtin_ctzll(w);
+#else
+	int n = 0;
+
+	while (!(w & 1)) {
+		w >>= 1;
+		n++;
+	}
+
+	return n;
+#endif
+}
+
+/**
+ * Return the index of the highest set bit of a non-zero word.
+ */
+int bitboard_last(u64b w)
+{
+#ifdef __GNUC__
+	return BITBOARD_WORD_BITS - 1 - __builtin_clzll(w);
+#else
+	int n = BITBOARD_WORD_BITS - 1;
+
+	while (!(w >> n))
+		n--;
+
+	return n;
+#endif
+}
+
+/**
+ * Return the bits of word i of a row which hold grids x1 to x2 inclusive.
+ */
+u64b bitboard_span(int i, int x1, int x2)
+{
+	int lo = i * BITBOARD_WORD_BITS;
+	int hi = lo + BITBOARD_WORD_BITS - 1;
+	u64b mask = ~(u64b)0;
+
+	if (x1 > hi || x2 < lo) return 0;
+
+	if (x1 > lo) mask &= mask << (x1 - lo);
+	if (x2 < hi) mask &= ~(u64b)0 >> (hi - x2);
+
+	return mask;
+}
+
+/**
+ * Make a new, clear bitboard.
+ */
+struct bitboard *bitboard_new(int height, int width)
+{
+	struct bitboard *b = mem_zalloc(sizeof(*b));
+
+	b->height = height;
+	b->width = width;
+	b->words = (width + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS;
+	b->bits = mem_zalloc(height * b->words * sizeof(u64b));
+
+	return b;
+}
+
+void bitboard_free(struct bitboard *b)
+{
+	mem_free(b->bits);
+	mem_free(b);
+}
+
+/**
+ * Clear every bit.
+ */
+void bitboard_wipe(struct bitboard *b)
+{
+	memset(b->bits, 0, b->height * b->words * sizeof(u64b));
+}
+
+bool bitboard_get(const struct bitboard *b, int y, int x)
+{
+	return (BITBOARD_ROW(b, y)[x / BITBOARD_WORD_BITS] >>
+		(x % BITBOARD_WORD_BITS)) & 1;
+}
+
+void bitboard_put(struct bitboard *b, int y, int x, bool on)
+{
+	u64b bit = (u64b)1 << (x % BITBOARD_WORD_BITS);
+
+	if (on)
+		BITBOARD_ROW(b, y)[x / BITBOARD_WORD_BITS] |= bit;
+	else
+		BITBOARD_ROW(b, y)[x / BITBOARD_WORD_BITS] &= ~bit;
+}
+
+/**
+ * Return the highest x' <= x with (y, x') set, or -1 if there is none.
+ */
+int bitboard_prev(const struct bitboard *b, int y, int x)
+{
+	const u64b *row = BITBOARD_ROW(b, y);
+	int i = x / BITBOARD_WORD_BITS;
+	u64b w = row[i] & (~(u64b)0 >> (BITBOARD_WORD_BITS - 1 -
+		x % BITBOARD_WORD_BITS));
+
+	while (!w) {
+		if (!i) return -1;
+		w = row[--i];
+	}
+
+	return i * BITBOARD_WORD_BITS + bitboard_last(w);
+}
+
+/**
+ * Return the number of set bits.
+ */
+int bitboard_count(const struct bitboard *b)
+{
+	int i, n = 0;
+
+	for (i = 0; i < b->height * b->words; i++)
+		n += bitboard_bits(b->bits[i]);
+
+	return n;
+}
+
+/**
+ * Set or clear every bit in the rectangle from (y1, x1) to (y2, x2)
+ * inclusive.
+ */
+void bitboard_fill(struct bitboard *b, int y1, int x1, int y2, int x2,
+	bool on)
+{
+	int y, i;
+
+	for (y = y1; y <= y2; y++) {
+		u64b *row = BITBOARD_ROW(b, y);
+
+		for (i = x1 / BITBOARD_WORD_BITS; i <= x2 / BITBOARD_WORD_BITS; i++) {
+			if (on)
+				row[i] |= bitboard_span(i, x1, x2);
+			else
+				row[i] &= ~bitboard_span(i, x1, x2);
+		}
+	}
+}
+
+/**
+ * Return the number of set bits in the rectangle from (y1, x1) to (y2, x2)
+ * inclusive.
+ */
+int bitboard_count_rect(const struct bitboard *b, int y1, int x1, int y2,
+	int x2)
+{
+	int y, i, n = 0;
+
+	for (y = y1; y <= y2; y++) {
+		const u64b *row = BITBOARD_ROW(b, y);
+
+		for (i = x1 / BITBOARD_WORD_BITS; i <= x2 / BITBOARD_WORD_BITS; i++)
+			n += bitboard_bits(row[i] & bitboard_span(i, x1, x2));
+	}
+
+	return n;
+}
+
+/**
+ * Find the set bit in the rectangle from (y1, x1) to (y2, x2) inclusive
+ * which has k set bits of the rectangle before it in row order, so that
+ * with bitboard_count_rect() a bit can be picked by its rank. Returns FALSE
+ * if the rectangle holds no more than k set bits.
+ */
+bool bitboard_select_rect(const struct bitboard *b, int y1, int x1, int y2,
+	int x2, int k, int *y, int *x)
+{
+	int yy, i;
+
+	for (yy = y1; yy <= y2; yy++) {
+		const u64b *row = BITBOARD_ROW(b, yy);
+
+		for (i = x1 / BITBOARD_WORD_BITS; i <= x2 / BITBOARD_WORD_BITS; i++) {
+			u64b w = row[i] & bitboard_span(i, x1, x2);
+			int n = bitboard_bits(w);
+
+			if (k >= n) {
+				k -= n;
+				continue;
+			}
+
+			/* Drop the k lowest bits of the word */
+			while (k--)
+				w &= w - 1;
+
+			*y = yy;
+			*x = i * BITBOARD_WORD_BITS + bitboard_first(w);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/**
+ * Add one bit per grid into a bit-sliced counter.
+ */
+static void add_bits(u64b count[4], u64b in)
+{
+	int k;
+
+	for (k = 0; k < 3 && in; k++) {
+		u64b carry = count[k] & in;
+		count[k] ^= in;
+		in = carry;
+	}
+	count[3] ^= in;
+}
+
+/**
+ * Add the western and eastern neighbours in a row, and the row's own bits
+ * if centre is set, to the counters for word i.
+ */
+static void add_row(const struct bitboard *b, const u64b *row, int i,
+	bool centre, u64b count[4])
+{
+	u64b west = row[i] << 1;
+	u64b east = row[i] >> 1;
+
+	if (i > 0) west |= row[i - 1] >> (BITBOARD_WORD_BITS - 1);
+	if (i + 1 < b->words) east |= row[i + 1] << (BITBOARD_WORD_BITS - 1);
+
+	if (centre) add_bits(count, row[i]);
+	add_bits(count, west);
+	add_bits(count, east);
+}
+
+/**
+ * Count the set neighbours (0-8) of every grid in row y, a word at a time.
+ *
+ * The counts come back bit-sliced: bit k of grid x's count is bit x of
+ * count[k]. Each count[k] must hold b->words words. Grids off the board
+ * count as clear.
+ */
+void bitboard_neighbours(const struct bitboard *b, int y, u64b *count[4])
+{
+	int i;
+
+	for (i = 0; i < b->words; i++) {
+		u64b c[4] = { 0, 0, 0, 0 };
+
+		if (y > 0) add_row(b, BITBOARD_ROW(b, y - 1), i, TRUE, c);
+		add_row(b, BITBOARD_ROW(b, y), i, FALSE, c);
+		if (y + 1 < b->height)
+			add_row(b, BITBOARD_ROW(b, y + 1), i, TRUE, c);
+
+		count[0][i] = c[0];
+		count[1][i] = c[1];
+		count[2][i] = c[2];
+		count[3][i] = c[3];
+	}
+}
+
+/**
+ * Select the grids of a word whose count is exactly n.
+ */
+static u64b count_is(u64b *count[4], int i, int n)
+{
+	u64b mask = ~(u64b)0;
+	int k;
+
+	for (k = 0; k < 4; k++)
+		mask &= (n & (1 << k)) ? count[k][i] : ~count[k][i];
+
+	return mask;
+}
+
+/**
+ * Run one step of a cellular automaton over the board: every grid with fewer
+ * than low set neighbours is cleared, and every one with more than high is
+ * set. Grids on the edge of the board are left alone.
+ */
+void bitboard_smooth(struct bitboard *b, int low, int high)
+{
+	u64b *bits = mem_zalloc(b->height * b->words * sizeof(u64b));
+	u64b *inside = mem_zalloc(b->words * sizeof(u64b));
+	u64b *count[4];
+	int i, k, n, y;
+
+	for (k = 0; k < 4; k++)
+		count[k] = mem_zalloc(b->words * sizeof(u64b));
+
+	/* The grids to update in each row */
+	for (i = 1; i < b->width - 1; i++)
+		inside[i / BITBOARD_WORD_BITS] |=
+			(u64b)1 << (i % BITBOARD_WORD_BITS);
+
+	memcpy(bits, b->bits, b->height * b->words * sizeof(u64b));
+
+	for (y = 1; y < b->height - 1; y++) {
+		u64b *row = bits + y * b->words;
+
+		bitboard_neighbours(b, y, count);
+
+		for (i = 0; i < b->words; i++) {
+			u64b clear = 0, set = 0;
+
+			for (n = 0; n < low && n <= 8; n++)
+				clear |= count_is(count, i, n);
+			for (n = MAX(high + 1, 0); n <= 8; n++)
+				set |= count_is(count, i, n);
+
+			row[i] = (row[i] & ~(clear & inside[i])) | (set & inside[i]);
+		}
+	}
+
+	mem_free(b->bits);
+	b->bits = bits;
+
+	for (k = 0; k < 4; k++)
+		mem_free(count[k]);
+	mem_free(inside);
+}
@@ -0,0 +1,66 @@
+/*
+ * File: z-bitboard.h
+ * Purpose: Two-dimensional bit grids with word-parallel operations
+ *
+ * Copyright (c) 2011 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_BITBOARD_H
+#define INCLUDED_Z_BITBOARD_H
+
+#include "h-basic.h"
+
+/* The number of bits in a bitboard word */
+#define BITBOARD_WORD_BITS	64
+
+/**
+ * A height x width grid of bits. Each row is stored as a run of 64-bit
+ * words, with grid x held in bit (x % 64) of word (x / 64); bits past the
+ * width are always clear.
+ */
+struct bitboard {
+	int height;
+	int width;
+	int words;		/* words per row */
+	u64b *bits;
+};
+
+/* The words of row y */
+#define BITBOARD_ROW(b, y)	((b)->bits + (y) * (b)->words)
+
+int bitboard_bits(u64b w);
+int bitboard_first(u64b w);
+int bitboard_last(u64b w);
+u64b bitboard_span(int i, int x1, int x2);
+
+struct bitboard *bitboard_new(int height, int width);
+void bitboard_free(struct bitboard *b);
+
+void bitboard_wipe(struct bitboard *b);
+bool bitboard_get(const struct bitboard *b, int y, int x);
+void bitboard_put(struct bitboard *b, int y, int x, bool on);
+int bitboard_prev(const struct bitboard *b, int y, int x);
+int bitboard_count(const struct bitboard *b);
+
+void bitboard_fill(struct bitboard *b, int y1, int x1, int y2, int x2,
+	bool on);
+int bitboard_count_rect(const struct bitboard *b, int y1, int x1, int y2,
+	int x2);
+bool bitboard_select_rect(const struct bitboard *b, int y1, int x1, int y2,
+	int x2, int k, int *y, int *x);
+
+void bitboard_neighbours(const struct bitboard *b, int y, u64b *count[4]);
+void bitboard_smooth(struct bitboard *b, int low, int high);
+
+#endif /* INCLUDED_Z_BITBOARD_H */
@@ -99,14 +99,27 @@ static u32b rand_fixval = 0;
  * Initialize the complex RNG using a new seed.
  */
 void Rand_state_init(u32b seed) {
+	Rand_state_init64(seed);
+}
+
+
+/**
+ * Initialize the complex RNG using a new 64-bit seed. Seeds below 2^32 give
+ * the same state as Rand_state_init().
+ */
+void Rand_state_init64(u64b seed) {
+	u32b high = (u32b)(seed >> 32);
 	int i, j;
 
+	/* Start from the same index, so the state depends only on the seed */
+	state_i = 0;
+
 	/* Seed the table */
-	STATE[0] = seed;
+	STATE[0] = (u32b)seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		STATE[i] = LCRNG(STATE[i - 1]) ^ high;
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
@@ -122,6 +135,34 @@ void Rand_state_init(u32b seed) {
 }
 
 
+/**
+ * Save the state of both RNGs.
+ */
+void Rand_state_save(rand_state *r) {
+	r->quick = Rand_quick;
+	r->value = Rand_value;
+	r->i = state_i;
+	memcpy(r->state, STATE, sizeof(r->state));
+	r->z0 = z0;
+	r->z1 = z1;
+	r->z2 = z2;
+}
+
+
+/**
+ * Put back the state saved by Rand_state_save().
+ */
+void Rand_state_restore(const rand_state *r) {
+	Rand_quick = r->quick;
+	Rand_value = r->value;
+	state_i = r->i;
+	memcpy(STATE, r->state, sizeof(STATE));
+	z0 = r->z0;
+	z1 = r->z1;
+	z2 = r->z2;
+}
+
+
 /**
  * Extract a "random" number from 0 to m - 1, via division.
  *
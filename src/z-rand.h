@@ -85,6 +85,26 @@ extern u32b z2;
  */
 void Rand_state_init(u32b seed);
 
+/**
+ * Initialise the RNG state with the given 64-bit seed.
+ */
+void Rand_state_init64(u64b seed);
+
+/**
+ * A copy of the whole RNG state, so that a self-contained job can be run on
+ * its own seed without disturbing the main stream of random numbers.
+ */
+typedef struct rand_state {
+	bool quick;
+	u32b value;
+	u32b i;
+	u32b state[RAND_DEG];
+	u32b z0, z1, z2;
+} rand_state;
+
+void Rand_state_save(rand_state *r);
+void Rand_state_restore(const rand_state *r);
+
 /**
  * Generates a random unsigned long integer X where "0 <= X < M" holds.
  *